@@ -0,0 +1,438 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+#include "heuristic_backtracking.h"
+
+/*
+Adaptive variable ordering heuristics, which learn from the search itself rather than recomputing consistent domains.
+An instance is given to the backtracking solvers at once as the primary selector, the secondary selector and the inference.
+Its inference wraps another inference (or, when none is given, checks the constraints containing the assigned variable),
+and records what it observes: failures, and the domain removals on the problem's trail. Its selectors then score the
+unassigned variables by the recorded scores and the current domain sizes, and return all the best scored variables,
+in the order of getVariables().
+Copies share their state, since the solvers copy their arguments. The state is bound to one constraint problem at a time
+by variables and constraints indices, hence an instance must not be shared by concurrent searches (e.g. by parallel solvers).
+1. WeightedDegree - dom/wdeg: a constraint's weight is bumped whenever it causes a failure. The selected variable has the
+	smallest ratio of domain size to the sum of the weights of its constraints which have other unassigned variables.
+2. Activity - a variable's activity is bumped whenever an inference removes values from its domain, and all the activities
+	decay at every inference. The selected variable has the largest ratio of activity to domain size.
+	Activities grow only with inferences which remove values through the problem (e.g. mac, macRM, maintainingGAC).
+3. Impact - an assignment's impact is the ratio by which it, with its inference, shrank the search space (the product of
+	the variables domain sizes), and 1 on failure. Impacts are averaged per variable and value. The selected variable's
+	values are estimated to leave the smallest search space (sum of 1 - impact over its domain). Untried values have no impact.
+*/
+
+namespace csp
+{
+	constexpr double ACTIVITY_RESCALE_LIMIT = 1e100;
+
+	// lower scores are better
+	template <typename T, typename VariableScore>
+	static std::vector<Ref<Variable<T>>> __selectBestScoredVariables(ConstraintProblem<T>& constraintProblem, VariableScore scoreVariable)
+	{
+		double bestScore = std::numeric_limits<double>::infinity();
+		std::vector<size_t> bestVarsIdxs;
+		for (size_t varIdx : constraintProblem.getUnassignedVariablesIdxs())
+		{
+			double score = scoreVariable(varIdx);
+			if (score < bestScore)
+			{
+				bestScore = score;
+				bestVarsIdxs.clear();
+			}
+			if (score == bestScore)
+			{
+				bestVarsIdxs.push_back(varIdx);
+			}
+		}
+
+		std::sort(bestVarsIdxs.begin(), bestVarsIdxs.end());
+		std::vector<Ref<Variable<T>>> bestVars;
+		bestVars.reserve(bestVarsIdxs.size());
+		for (size_t varIdx : bestVarsIdxs)
+		{
+			bestVars.emplace_back(constraintProblem.getVariable(varIdx));
+		}
+		return bestVars;
+	}
+
+	template <typename T, typename VariableScore>
+	static Variable<T>& __selectBestScoredCandidate(ConstraintProblem<T>& constraintProblem,
+		const std::vector<Ref<Variable<T>>>& candidateVars, VariableScore scoreVariable)
+	{
+		double bestScore = std::numeric_limits<double>::infinity();
+		size_t bestPosition = 0;
+		for (size_t i = 0; i < candidateVars.size(); ++i)
+		{
+			double score = scoreVariable(constraintProblem.getVariableIdx(candidateVars[i]));
+			if (score < bestScore)
+			{
+				bestScore = score;
+				bestPosition = i;
+			}
+		}
+		return candidateVars[bestPosition];
+	}
+
+	template <typename T>
+	static bool __inferOrCheckConstraints(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable,
+		const std::optional<Inference<T>>& optInference)
+	{
+		if (optInference)
+		{
+			return (*optInference)(constraintProblem, assignedVariable);
+		}
+		for (size_t constrIdx : constraintProblem.getConstraintsIdxsContainingVariable(constraintProblem.getVariableIdx(assignedVariable)))
+		{
+			if (!constraintProblem.getConstraint(constrIdx).isConsistent())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	template <typename T>
+	class WeightedDegree final
+	{
+	public:
+		WeightedDegree<T>(const std::optional<Inference<T>>& optInference = std::optional<Inference<T>>{}) :
+			m_pState{ std::make_shared<State>(State{ optInference, nullptr, { } }) }
+		{ }
+
+		// primary selector
+		std::vector<Ref<Variable<T>>> operator()(ConstraintProblem<T>& constraintProblem)
+		{
+			this->init_weights(constraintProblem);
+			return __selectBestScoredVariables<T>(constraintProblem, [this, &constraintProblem](size_t varIdx) -> double
+				{
+					return this->get_score(constraintProblem, varIdx);
+				});
+		}
+
+		// secondary selector
+		Variable<T>& operator()(ConstraintProblem<T>& constraintProblem, const std::vector<Ref<Variable<T>>>& candidateVars)
+		{
+			this->init_weights(constraintProblem);
+			return __selectBestScoredCandidate<T>(constraintProblem, candidateVars, [this, &constraintProblem](size_t varIdx) -> double
+				{
+					return this->get_score(constraintProblem, varIdx);
+				});
+		}
+
+		// inference
+		bool operator()(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+		{
+			this->init_weights(constraintProblem);
+			if (__inferOrCheckConstraints<T>(constraintProblem, assignedVariable, m_pState->optInference))
+			{
+				return true;
+			}
+			this->bump_failure_weights(constraintProblem, constraintProblem.getVariableIdx(assignedVariable));
+			return false;
+		}
+
+		// weights start at 1, and are those of the last searched constraint problem
+		size_t getConstraintWeight(size_t constrIdx) const noexcept { return m_pState->constraintsWeights[constrIdx]; }
+
+	private:
+		struct State
+		{
+			std::optional<Inference<T>> optInference;
+			const ConstraintProblem<T>* pConstraintProblem;
+			std::vector<size_t> constraintsWeights;
+		};
+
+		void init_weights(const ConstraintProblem<T>& constraintProblem)
+		{
+			State& state = *m_pState;
+			const size_t constraintsSize = constraintProblem.getConstraints().size();
+			if (state.pConstraintProblem != &constraintProblem || state.constraintsWeights.size() != constraintsSize)
+			{
+				state.pConstraintProblem = &constraintProblem;
+				state.constraintsWeights.assign(constraintsSize, 1);
+			}
+		}
+
+		double get_score(const ConstraintProblem<T>& constraintProblem, size_t varIdx) const
+		{
+			size_t weightedDegree = 0;
+			for (size_t constrIdx : constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
+			{
+				for (size_t otherVarIdx : constraintProblem.getVariablesIdxsOfConstraint(constrIdx))
+				{
+					if (otherVarIdx != varIdx && !constraintProblem.getVariable(otherVarIdx).isAssigned())
+					{
+						weightedDegree += m_pState->constraintsWeights[constrIdx];
+						break;
+					}
+				}
+			}
+			// variables constrained by no other unassigned variable are left for last
+			return weightedDegree ?
+				static_cast<double>(constraintProblem.getVariable(varIdx).getDomain().size()) / weightedDegree :
+				std::numeric_limits<double>::infinity();
+		}
+
+		void bump_failure_weights(ConstraintProblem<T>& constraintProblem, size_t assignedVarIdx)
+		{
+			std::vector<size_t>& constraintsWeights = m_pState->constraintsWeights;
+			Span<const size_t> assignedVarConstrsIdxs = constraintProblem.getConstraintsIdxsContainingVariable(assignedVarIdx);
+			bool isBumped = false;
+			for (size_t constrIdx : assignedVarConstrsIdxs)
+			{
+				if (!constraintProblem.getConstraint(constrIdx).isConsistent())
+				{
+					++constraintsWeights[constrIdx];
+					isBumped = true;
+				}
+			}
+			if (isBumped)
+			{
+				return;
+			}
+
+			// the constraints shared with the neighbors whose domains were wiped out
+			for (size_t neighborIdx : constraintProblem.getNeighborsIdxs(assignedVarIdx))
+			{
+				Variable<T>& neighbor = constraintProblem.getVariable(neighborIdx);
+				if (neighbor.isAssigned() || (!neighbor.getDomain().empty() && !constraintProblem.isConsistentDomainEmpty(neighbor)))
+				{
+					continue;
+				}
+				for (size_t constrIdx : assignedVarConstrsIdxs)
+				{
+					Span<const size_t> constrVarsIdxs = constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+					if (std::find(constrVarsIdxs.begin(), constrVarsIdxs.end(), neighborIdx) != constrVarsIdxs.end())
+					{
+						++constraintsWeights[constrIdx];
+						isBumped = true;
+					}
+				}
+			}
+
+			// the wipe out was propagated further than the neighbors
+			if (!isBumped)
+			{
+				for (size_t constrIdx : assignedVarConstrsIdxs)
+				{
+					++constraintsWeights[constrIdx];
+				}
+			}
+		}
+
+		std::shared_ptr<State> m_pState;
+	};
+
+
+	template <typename T>
+	class Activity final
+	{
+	public:
+		Activity<T>(const std::optional<Inference<T>>& optInference = std::optional<Inference<T>>{}, double decay = 0.99) :
+			m_pState{ std::make_shared<State>(State{ optInference, decay, nullptr, { }, 1.0, { }, 0 }) }
+		{ }
+
+		// primary selector
+		std::vector<Ref<Variable<T>>> operator()(ConstraintProblem<T>& constraintProblem)
+		{
+			this->init_activities(constraintProblem);
+			return __selectBestScoredVariables<T>(constraintProblem, [this, &constraintProblem](size_t varIdx) -> double
+				{
+					return this->get_score(constraintProblem, varIdx);
+				});
+		}
+
+		// secondary selector
+		Variable<T>& operator()(ConstraintProblem<T>& constraintProblem, const std::vector<Ref<Variable<T>>>& candidateVars)
+		{
+			this->init_activities(constraintProblem);
+			return __selectBestScoredCandidate<T>(constraintProblem, candidateVars, [this, &constraintProblem](size_t varIdx) -> double
+				{
+					return this->get_score(constraintProblem, varIdx);
+				});
+		}
+
+		// inference
+		bool operator()(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+		{
+			this->init_activities(constraintProblem);
+			State& state = *m_pState;
+			const size_t trailMark = constraintProblem.getTrailMark();
+			bool isConsistent = __inferOrCheckConstraints<T>(constraintProblem, assignedVariable, state.optInference);
+
+			++state.inferencesCount;
+			for (size_t trailPosition = trailMark; trailPosition < constraintProblem.getTrailMark(); ++trailPosition)
+			{
+				size_t varIdx = constraintProblem.getVariableIdx(constraintProblem.getTrailedVariable(trailPosition));
+				if (state.lastBumpInferences[varIdx] != state.inferencesCount)
+				{
+					state.lastBumpInferences[varIdx] = state.inferencesCount;
+					state.activities[varIdx] += state.activityIncrement;
+				}
+			}
+
+			// rather than decaying all the activities, later bumps are made bigger
+			state.activityIncrement /= state.decay;
+			if (ACTIVITY_RESCALE_LIMIT < state.activityIncrement)
+			{
+				for (double& activity : state.activities)
+				{
+					activity /= ACTIVITY_RESCALE_LIMIT;
+				}
+				state.activityIncrement /= ACTIVITY_RESCALE_LIMIT;
+			}
+			return isConsistent;
+		}
+
+		// activities are relative to each other, and are those of the last searched constraint problem
+		double getVariableActivity(size_t varIdx) const noexcept { return m_pState->activities[varIdx]; }
+
+	private:
+		struct State
+		{
+			std::optional<Inference<T>> optInference;
+			double decay;
+			const ConstraintProblem<T>* pConstraintProblem;
+			std::vector<double> activities;
+			double activityIncrement;
+			std::vector<size_t> lastBumpInferences;
+			size_t inferencesCount;
+		};
+
+		void init_activities(const ConstraintProblem<T>& constraintProblem)
+		{
+			State& state = *m_pState;
+			const size_t varsSize = constraintProblem.getVariables().size();
+			if (state.pConstraintProblem != &constraintProblem || state.activities.size() != varsSize)
+			{
+				state.pConstraintProblem = &constraintProblem;
+				state.activities.assign(varsSize, 0.0);
+				state.activityIncrement = 1.0;
+				state.lastBumpInferences.assign(varsSize, 0);
+				state.inferencesCount = 0;
+			}
+		}
+
+		double get_score(const ConstraintProblem<T>& constraintProblem, size_t varIdx) const
+		{
+			const size_t domainSize = constraintProblem.getVariable(varIdx).getDomain().size();
+			return domainSize ? -m_pState->activities[varIdx] / domainSize : -std::numeric_limits<double>::infinity();
+		}
+
+		std::shared_ptr<State> m_pState;
+	};
+
+
+	template <typename T>
+	class Impact final
+	{
+	public:
+		Impact<T>(const std::optional<Inference<T>>& optInference = std::optional<Inference<T>>{}) :
+			m_pState{ std::make_shared<State>(State{ optInference, nullptr, { }, { }, { } }) }
+		{ }
+
+		// primary selector
+		std::vector<Ref<Variable<T>>> operator()(ConstraintProblem<T>& constraintProblem)
+		{
+			this->init_impacts(constraintProblem);
+			return __selectBestScoredVariables<T>(constraintProblem, [this, &constraintProblem](size_t varIdx) -> double
+				{
+					return this->get_score(constraintProblem, varIdx);
+				});
+		}
+
+		// secondary selector
+		Variable<T>& operator()(ConstraintProblem<T>& constraintProblem, const std::vector<Ref<Variable<T>>>& candidateVars)
+		{
+			this->init_impacts(constraintProblem);
+			return __selectBestScoredCandidate<T>(constraintProblem, candidateVars, [this, &constraintProblem](size_t varIdx) -> double
+				{
+					return this->get_score(constraintProblem, varIdx);
+				});
+		}
+
+		// inference
+		bool operator()(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+		{
+			this->init_impacts(constraintProblem);
+			State& state = *m_pState;
+			const size_t trailMark = constraintProblem.getTrailMark();
+			bool isConsistent = __inferOrCheckConstraints<T>(constraintProblem, assignedVariable, state.optInference);
+
+			double impact = 1.0;
+			if (isConsistent)
+			{
+				// only the domains of the assigned variable and of the pruned variables changed the search space
+				double logSearchSpaceRatio = -std::log(static_cast<double>(assignedVariable.getDomain().size()));
+				for (size_t trailPosition = trailMark; trailPosition < constraintProblem.getTrailMark(); ++trailPosition)
+				{
+					size_t varIdx = constraintProblem.getVariableIdx(constraintProblem.getTrailedVariable(trailPosition));
+					if (!state.removalsCounts[varIdx]++)
+					{
+						state.prunedVarsIdxs.push_back(varIdx);
+					}
+				}
+				for (size_t varIdx : state.prunedVarsIdxs)
+				{
+					double domainSize = static_cast<double>(constraintProblem.getVariable(varIdx).getDomain().size());
+					logSearchSpaceRatio += std::log(domainSize) - std::log(domainSize + state.removalsCounts[varIdx]);
+					state.removalsCounts[varIdx] = 0;
+				}
+				state.prunedVarsIdxs.clear();
+				impact = 1.0 - std::exp(logSearchSpaceRatio);
+			}
+
+			std::pair<double, size_t>& impactsSumAndCount =
+				state.valuesImpacts[constraintProblem.getVariableIdx(assignedVariable)][assignedVariable.getValue()];
+			impactsSumAndCount.first += impact;
+			++impactsSumAndCount.second;
+			return isConsistent;
+		}
+
+		// average impact of the assignment in the last searched constraint problem, 0 if it was not tried
+		double getAssignmentImpact(size_t varIdx, T value) const
+		{
+			const std::unordered_map<T, std::pair<double, size_t>>& varValuesImpacts = m_pState->valuesImpacts[varIdx];
+			auto it = varValuesImpacts.find(value);
+			return it == varValuesImpacts.cend() ? 0.0 : it->second.first / it->second.second;
+		}
+
+	private:
+		struct State
+		{
+			std::optional<Inference<T>> optInference;
+			const ConstraintProblem<T>* pConstraintProblem;
+			std::vector<std::unordered_map<T, std::pair<double, size_t>>> valuesImpacts;	// value to impacts sum and count
+			std::vector<size_t> removalsCounts;
+			std::vector<size_t> prunedVarsIdxs;
+		};
+
+		void init_impacts(const ConstraintProblem<T>& constraintProblem)
+		{
+			State& state = *m_pState;
+			const size_t varsSize = constraintProblem.getVariables().size();
+			if (state.pConstraintProblem != &constraintProblem || state.valuesImpacts.size() != varsSize)
+			{
+				state.pConstraintProblem = &constraintProblem;
+				state.valuesImpacts.assign(varsSize, std::unordered_map<T, std::pair<double, size_t>>{ });
+				state.removalsCounts.assign(varsSize, 0);
+				state.prunedVarsIdxs.clear();
+			}
+		}
+
+		double get_score(const ConstraintProblem<T>& constraintProblem, size_t varIdx) const
+		{
+			double searchSpaceEstimate = 0.0;
+			for (const T& value : constraintProblem.getVariable(varIdx).getDomain())
+			{
+				searchSpaceEstimate += 1.0 - this->getAssignmentImpact(varIdx, value);
+			}
+			return searchSpaceEstimate;
+		}
+
+		std::shared_ptr<State> m_pState;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,539 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+#include "forward_checking.h"
+#include "constraints_propagation.h"
+
+/*
+All-different propagation, used as an inference by the backtracking solvers.
+Constraints recognized as all-different are those constructed with the built-in all-different evaluator
+(csp::allDiff<T> or csp::AllDiff<T>). Their n-ary propagation is stronger than pairwise arc consistency:
+1. allDifferentGAC - generalized arc consistency by Regin's algorithm: a maximum matching of the variables-values bipartite
+	graph is found, and a value is removed from a variable's domain iff the pair belongs to no maximum matching, i.e. it is
+	neither matched, nor on an alternating cycle (same strongly connected component), nor on an even alternating path
+	starting at a free value.
+2. allDifferentBoundsConsistency - integral T only: Hall intervals of the variables' [min, max] bounds are found, and the bounds
+	of variables not contained in a Hall interval are pushed out of it. A pass costs O(n log n) for n variables, plus the
+	removed values, against the matching and strongly connected components of GAC over all the values of all the domains.
+	It prunes less than GAC: only bounds move, never values inside a domain.
+Pruned domains cascade to the other all-different constraints of the pruned variables, until a fixed point is reached.
+Other constraints are then forward checked. Assigned variables' domains are never pruned, they only count as their value.
+*/
+
+namespace csp
+{
+	template <typename T>
+	constexpr bool isAllDifferentConstraint(const Constraint<T>& constraint) noexcept
+	{
+		return std::holds_alternative<AllDiff<T>>(constraint.getAnyConstraintEvaluator());
+	}
+
+	// variables are nodes [0, varsSize) and distinct values are nodes [varsSize, varsSize + values.size())
+	template <typename T>
+	struct __AllDifferentValueGraph
+	{
+		std::vector<T> values;
+		std::vector<std::vector<size_t>> varToValuesIds;
+		std::vector<std::vector<size_t>> valueToVarsPositions;
+		std::vector<size_t> varMatchedValueId;
+		std::vector<size_t> valueMatchedVarPosition;
+	};
+
+	template <typename T>
+	static __AllDifferentValueGraph<T> __buildValueGraph(const ConstraintProblem<T>& constraintProblem, Span<const size_t> varsIdxs)
+	{
+		__AllDifferentValueGraph<T> valueGraph;
+		valueGraph.varToValuesIds.resize(varsIdxs.size());
+		std::unordered_map<T, size_t> valueToId;
+		for (size_t varPosition = 0; varPosition < varsIdxs.size(); ++varPosition)
+		{
+			const Variable<T>& var = constraintProblem.getVariable(varsIdxs[varPosition]);
+			auto addEdge = [&valueGraph, &valueToId, varPosition](const T& value)
+			{
+				auto [it, isNewValue] = valueToId.emplace(value, valueGraph.values.size());
+				if (isNewValue)
+				{
+					valueGraph.values.push_back(value);
+					valueGraph.valueToVarsPositions.emplace_back();
+				}
+				valueGraph.varToValuesIds[varPosition].push_back(it->second);
+				valueGraph.valueToVarsPositions[it->second].push_back(varPosition);
+			};
+
+			if (var.isAssigned())
+			{
+				addEdge(var.getValue());
+			}
+			else
+			{
+				for (const T& value : var.getDomain())
+				{
+					addEdge(value);
+				}
+			}
+		}
+		valueGraph.varMatchedValueId.assign(varsIdxs.size(), UNASSIGNED);
+		valueGraph.valueMatchedVarPosition.assign(valueGraph.values.size(), UNASSIGNED);
+		return valueGraph;
+	}
+
+	template <typename T>
+	static bool __augmentMatching(__AllDifferentValueGraph<T>& valueGraph, size_t varPosition, std::vector<size_t>& valueVisitStamp,
+		size_t stamp)
+	{
+		for (size_t valueId : valueGraph.varToValuesIds[varPosition])
+		{
+			if (valueVisitStamp[valueId] == stamp)
+			{
+				continue;
+			}
+			valueVisitStamp[valueId] = stamp;
+			size_t matchedVarPosition = valueGraph.valueMatchedVarPosition[valueId];
+			if (matchedVarPosition == UNASSIGNED || __augmentMatching<T>(valueGraph, matchedVarPosition, valueVisitStamp, stamp))
+			{
+				valueGraph.varMatchedValueId[varPosition] = valueId;
+				valueGraph.valueMatchedVarPosition[valueId] = varPosition;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// returns false iff no matching covers all the variables
+	template <typename T>
+	static bool __findMaximumMatching(__AllDifferentValueGraph<T>& valueGraph)
+	{
+		const size_t varsSize = valueGraph.varToValuesIds.size();
+		for (size_t varPosition = 0; varPosition < varsSize; ++varPosition)
+		{
+			for (size_t valueId : valueGraph.varToValuesIds[varPosition])
+			{
+				if (valueGraph.valueMatchedVarPosition[valueId] == UNASSIGNED)
+				{
+					valueGraph.varMatchedValueId[varPosition] = valueId;
+					valueGraph.valueMatchedVarPosition[valueId] = varPosition;
+					break;
+				}
+			}
+		}
+
+		std::vector<size_t> valueVisitStamp(valueGraph.values.size(), UNASSIGNED);
+		for (size_t varPosition = 0; varPosition < varsSize; ++varPosition)
+		{
+			if (valueGraph.varMatchedValueId[varPosition] == UNASSIGNED &&
+				!__augmentMatching<T>(valueGraph, varPosition, valueVisitStamp, varPosition))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/*
+	the residual graph is oriented: a variable points to its matched value, a value points to the variables it is unmatched with.
+	Tarjan's algorithm, where componentIds[node] stays UNASSIGNED until the node's component is complete.
+	*/
+	template <typename T>
+	static void __strongConnect(const __AllDifferentValueGraph<T>& valueGraph, size_t node, size_t& visitCounter,
+		std::vector<size_t>& visitIdx, std::vector<size_t>& lowLink, std::vector<size_t>& nodesStack,
+		std::vector<size_t>& componentIds, size_t& componentsCounter)
+	{
+		const size_t varsSize = valueGraph.varToValuesIds.size();
+		visitIdx[node] = lowLink[node] = visitCounter++;
+		nodesStack.push_back(node);
+
+		auto visitSuccessor = [&](size_t successor)
+		{
+			if (visitIdx[successor] == UNASSIGNED)
+			{
+				__strongConnect<T>(valueGraph, successor, visitCounter, visitIdx, lowLink, nodesStack, componentIds, componentsCounter);
+				lowLink[node] = std::min(lowLink[node], lowLink[successor]);
+			}
+			else if (componentIds[successor] == UNASSIGNED)
+			{
+				lowLink[node] = std::min(lowLink[node], visitIdx[successor]);
+			}
+		};
+
+		if (node < varsSize)
+		{
+			visitSuccessor(varsSize + valueGraph.varMatchedValueId[node]);
+		}
+		else
+		{
+			size_t valueId = node - varsSize;
+			for (size_t varPosition : valueGraph.valueToVarsPositions[valueId])
+			{
+				if (valueGraph.valueMatchedVarPosition[valueId] != varPosition)
+				{
+					visitSuccessor(varPosition);
+				}
+			}
+		}
+
+		if (lowLink[node] == visitIdx[node])
+		{
+			size_t componentNode;
+			do
+			{
+				componentNode = nodesStack.back();
+				nodesStack.pop_back();
+				componentIds[componentNode] = componentsCounter;
+			} while (componentNode != node);
+			++componentsCounter;
+		}
+	}
+
+	template <typename T>
+	static const std::vector<size_t> __findComponentsIds(const __AllDifferentValueGraph<T>& valueGraph)
+	{
+		const size_t nodesSize = valueGraph.varToValuesIds.size() + valueGraph.values.size();
+		std::vector<size_t> visitIdx(nodesSize, UNASSIGNED);
+		std::vector<size_t> lowLink(nodesSize, UNASSIGNED);
+		std::vector<size_t> componentIds(nodesSize, UNASSIGNED);
+		std::vector<size_t> nodesStack;
+		nodesStack.reserve(nodesSize);
+		size_t visitCounter = 0;
+		size_t componentsCounter = 0;
+		for (size_t node = 0; node < nodesSize; ++node)
+		{
+			if (visitIdx[node] == UNASSIGNED)
+			{
+				__strongConnect<T>(valueGraph, node, visitCounter, visitIdx, lowLink, nodesStack, componentIds, componentsCounter);
+			}
+		}
+		return componentIds;
+	}
+
+	// values reachable by alternating paths starting at values no variable is matched with
+	template <typename T>
+	static const std::vector<bool> __findValuesReachableFromFreeValues(const __AllDifferentValueGraph<T>& valueGraph)
+	{
+		std::vector<bool> isReachableValue(valueGraph.values.size(), false);
+		std::vector<size_t> valuesToVisit;
+		for (size_t valueId = 0; valueId < valueGraph.values.size(); ++valueId)
+		{
+			if (valueGraph.valueMatchedVarPosition[valueId] == UNASSIGNED)
+			{
+				isReachableValue[valueId] = true;
+				valuesToVisit.push_back(valueId);
+			}
+		}
+		while (!valuesToVisit.empty())
+		{
+			size_t valueId = valuesToVisit.back();
+			valuesToVisit.pop_back();
+			for (size_t varPosition : valueGraph.valueToVarsPositions[valueId])
+			{
+				size_t matchedValueId = valueGraph.varMatchedValueId[varPosition];
+				if (!isReachableValue[matchedValueId])
+				{
+					isReachableValue[matchedValueId] = true;
+					valuesToVisit.push_back(matchedValueId);
+				}
+			}
+		}
+		return isReachableValue;
+	}
+
+	template <typename T>
+	static bool __gacFilterAllDifferent(ConstraintProblem<T>& constraintProblem, size_t constrIdx, std::vector<size_t>& prunedVarsIdxs)
+	{
+		Span<const size_t> varsIdxs = constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+		__AllDifferentValueGraph<T> valueGraph = __buildValueGraph<T>(constraintProblem, varsIdxs);
+		if (!__findMaximumMatching<T>(valueGraph))
+		{
+			return false;
+		}
+
+		const std::vector<size_t> componentIds = __findComponentsIds<T>(valueGraph);
+		const std::vector<bool> isReachableValue = __findValuesReachableFromFreeValues<T>(valueGraph);
+		const size_t varsSize = varsIdxs.size();
+		for (size_t varPosition = 0; varPosition < varsSize; ++varPosition)
+		{
+			Variable<T>& var = constraintProblem.getVariable(varsIdxs[varPosition]);
+			if (var.isAssigned())
+			{
+				continue;
+			}
+
+			bool isPruned = false;
+			for (size_t valueId : valueGraph.varToValuesIds[varPosition])
+			{
+				if (valueId != valueGraph.varMatchedValueId[varPosition] && !isReachableValue[valueId] &&
+					componentIds[varPosition] != componentIds[varsSize + valueId])
+				{
+					constraintProblem.removeFromDomainByValue(var, valueGraph.values[valueId]);
+					isPruned = true;
+				}
+			}
+			if (isPruned)
+			{
+				prunedVarsIdxs.push_back(varsIdxs[varPosition]);
+			}
+		}
+		return true;
+	}
+
+	// union-find like paths over the ranks of the sorted bounds, see __boundsFilterAllDifferent
+	inline void __pathSet(std::vector<size_t>& links, size_t start, size_t end, size_t to) noexcept
+	{
+		size_t rank = start;
+		while (rank != end)
+		{
+			size_t nextRank = links[rank];
+			links[rank] = to;
+			rank = nextRank;
+		}
+	}
+
+	inline size_t __pathMin(const std::vector<size_t>& links, size_t rank) noexcept
+	{
+		while (links[rank] < rank)
+		{
+			rank = links[rank];
+		}
+		return rank;
+	}
+
+	inline size_t __pathMax(const std::vector<size_t>& links, size_t rank) noexcept
+	{
+		while (rank < links[rank])
+		{
+			rank = links[rank];
+		}
+		return rank;
+	}
+
+	/*
+	Bounds consistency by López-Ortiz, Quimper, Tromp and van Beek's algorithm. The variables' [min, max] bounds are sorted and
+	ranked once per pass, which is O(n log n) for n variables. Then one sweep by ascending max raises the mins past the Hall
+	intervals, and one sweep by descending min lowers the maxs. The sweeps find the Hall intervals with union-find like paths
+	over the bounds' ranks, so each one is nearly linear. A moved bound that lands in a hole of a domain moves on to the next
+	value in the domain, which may move other bounds, hence the passes repeat until no bound moves. Values are compared as
+	long long.
+	*/
+	template <typename T>
+	static bool __boundsFilterAllDifferent(ConstraintProblem<T>& constraintProblem, size_t constrIdx, std::vector<size_t>& prunedVarsIdxs)
+	{
+		static_assert(std::is_integral_v<T>, "bounds consistency counts the values of an interval, hence T must be integral");
+		Span<const size_t> varsIdxs = constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+		const size_t varsSize = varsIdxs.size();
+		if (!varsSize)
+		{
+			return true;
+		}
+
+		std::vector<long long> mins(varsSize);
+		std::vector<long long> maxs(varsSize);
+		auto updateBounds = [&constraintProblem, &varsIdxs, &mins, &maxs](size_t varPosition) -> bool
+		{
+			const Variable<T>& var = constraintProblem.getVariable(varsIdxs[varPosition]);
+			if (var.isAssigned())
+			{
+				mins[varPosition] = maxs[varPosition] = static_cast<long long>(var.getValue());
+				return true;
+			}
+			const std::vector<T>& domain = var.getDomain();
+			if (domain.empty())
+			{
+				return false;
+			}
+			auto [minIt, maxIt] = std::minmax_element(domain.cbegin(), domain.cend());
+			mins[varPosition] = static_cast<long long>(*minIt);
+			maxs[varPosition] = static_cast<long long>(*maxIt);
+			return true;
+		};
+
+		std::vector<bool> isPrunedVar(varsSize, false);
+		bool isRevised = true;
+		// an assigned variable is never pruned, its value only has to be within the new bounds
+		auto pruneOutOfBounds = [&](size_t varPosition, long long lowerBound, long long upperBound) -> bool
+		{
+			Variable<T>& var = constraintProblem.getVariable(varsIdxs[varPosition]);
+			if (var.isAssigned())
+			{
+				const long long value = static_cast<long long>(var.getValue());
+				return lowerBound <= value && value <= upperBound;
+			}
+			const std::vector<T>& domain = var.getDomain();
+			for (size_t i = domain.size(); 0 < i; --i)
+			{
+				const long long value = static_cast<long long>(domain[i - 1]);
+				if (value < lowerBound || upperBound < value)
+				{
+					constraintProblem.removeFromDomainByIdx(var, i - 1);
+					isPrunedVar[varPosition] = true;
+					isRevised = true;
+				}
+			}
+			return !domain.empty();
+		};
+
+		std::vector<size_t> minSorted(varsSize);
+		std::vector<size_t> maxSorted(varsSize);
+		std::vector<size_t> minRanks(varsSize);
+		std::vector<size_t> maxRanks(varsSize);
+		// bounds[0] and bounds[boundsSize + 1] are sentinels, and a max is ranked by max + 1
+		std::vector<long long> bounds(2 * varsSize + 2);
+		std::vector<size_t> links(2 * varsSize + 2);
+		std::vector<size_t> hallLinks(2 * varsSize + 2);
+		std::vector<long long> capacities(2 * varsSize + 2);
+		while (isRevised)
+		{
+			isRevised = false;
+			for (size_t varPosition = 0; varPosition < varsSize; ++varPosition)
+			{
+				if (!updateBounds(varPosition))
+				{
+					return false;
+				}
+			}
+
+			std::iota(minSorted.begin(), minSorted.end(), 0);
+			std::iota(maxSorted.begin(), maxSorted.end(), 0);
+			std::sort(minSorted.begin(), minSorted.end(),
+				[&mins](size_t left, size_t right) -> bool { return mins[left] < mins[right]; });
+			std::sort(maxSorted.begin(), maxSorted.end(),
+				[&maxs](size_t left, size_t right) -> bool { return maxs[left] < maxs[right]; });
+
+			long long minBound = mins[minSorted.front()];
+			long long maxBound = maxs[maxSorted.front()] + 1;
+			long long lastBound = minBound - 2;
+			size_t boundsSize = 0;
+			bounds[0] = lastBound;
+			for (size_t i = 0, j = 0; ; )
+			{
+				if (i < varsSize && minBound <= maxBound)
+				{
+					if (minBound != lastBound)
+					{
+						bounds[++boundsSize] = lastBound = minBound;
+					}
+					minRanks[minSorted[i]] = boundsSize;
+					if (++i < varsSize)
+					{
+						minBound = mins[minSorted[i]];
+					}
+				}
+				else
+				{
+					if (maxBound != lastBound)
+					{
+						bounds[++boundsSize] = lastBound = maxBound;
+					}
+					maxRanks[maxSorted[j]] = boundsSize;
+					if (++j == varsSize)
+					{
+						break;
+					}
+					maxBound = maxs[maxSorted[j]] + 1;
+				}
+			}
+			bounds[boundsSize + 1] = bounds[boundsSize] + 2;
+
+			// raising the mins: capacities[rank] is the amount of values left in [bounds[rank - 1], bounds[rank])
+			for (size_t rank = 1; rank <= boundsSize + 1; ++rank)
+			{
+				links[rank] = hallLinks[rank] = rank - 1;
+				capacities[rank] = bounds[rank] - bounds[rank - 1];
+			}
+			for (size_t varPosition : maxSorted)
+			{
+				const size_t minRank = minRanks[varPosition];
+				const size_t maxRank = maxRanks[varPosition];
+				size_t z = __pathMax(links, minRank + 1);
+				const size_t j = links[z];
+				if (!--capacities[z])
+				{
+					links[z] = z + 1;
+					z = __pathMax(links, links[z]);
+					links[z] = j;
+				}
+				__pathSet(links, minRank + 1, z, z);
+				if (capacities[z] < bounds[z] - bounds[maxRank])
+				{
+					return false;
+				}
+				if (minRank < hallLinks[minRank])
+				{
+					const size_t w = __pathMax(hallLinks, hallLinks[minRank]);
+					if (!pruneOutOfBounds(varPosition, bounds[w], maxs[varPosition]))
+					{
+						return false;
+					}
+					__pathSet(hallLinks, minRank, w, w);
+				}
+				if (capacities[z] == bounds[z] - bounds[maxRank])
+				{
+					__pathSet(hallLinks, hallLinks[maxRank], j - 1, maxRank);
+					hallLinks[maxRank] = j - 1;
+				}
+			}
+
+			// lowering the maxs: capacities[rank] is the amount of values left in [bounds[rank], bounds[rank + 1])
+			for (size_t rank = 0; rank <= boundsSize; ++rank)
+			{
+				links[rank] = hallLinks[rank] = rank + 1;
+				capacities[rank] = bounds[rank + 1] - bounds[rank];
+			}
+			for (auto it = minSorted.crbegin(); it != minSorted.crend(); ++it)
+			{
+				const size_t varPosition = *it;
+				const size_t minRank = minRanks[varPosition];
+				const size_t maxRank = maxRanks[varPosition];
+				size_t z = __pathMin(links, maxRank - 1);
+				const size_t j = links[z];
+				if (!--capacities[z])
+				{
+					links[z] = z - 1;
+					z = __pathMin(links, links[z]);
+					links[z] = j;
+				}
+				__pathSet(links, maxRank - 1, z, z);
+				if (capacities[z] < bounds[minRank] - bounds[z])
+				{
+					return false;
+				}
+				if (hallLinks[maxRank] < maxRank)
+				{
+					const size_t w = __pathMin(hallLinks, hallLinks[maxRank]);
+					if (!pruneOutOfBounds(varPosition, mins[varPosition], bounds[w] - 1))
+					{
+						return false;
+					}
+					__pathSet(hallLinks, maxRank, w, w);
+				}
+				if (capacities[z] == bounds[minRank] - bounds[z])
+				{
+					__pathSet(hallLinks, hallLinks[minRank], j + 1, minRank);
+					hallLinks[minRank] = j + 1;
+				}
+			}
+		}
+
+		for (size_t varPosition = 0; varPosition < varsSize; ++varPosition)
+		{
+			if (isPrunedVar[varPosition])
+			{
+				prunedVarsIdxs.push_back(varsIdxs[varPosition]);
+			}
+		}
+		return true;
+	}
+
+	template <typename T>
+	bool allDifferentGAC(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+	{
+		return __propagateToFixedPoint<T>(constraintProblem, assignedVariable, isAllDifferentConstraint<T>, __gacFilterAllDifferent<T>) &&
+			forwardChecking<T>(constraintProblem, assignedVariable);
+	}
+
+	template <typename T>
+	bool allDifferentBoundsConsistency(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+	{
+		return __propagateToFixedPoint<T>(constraintProblem, assignedVariable, isAllDifferentConstraint<T>, __boundsFilterAllDifferent<T>) &&
+			forwardChecking<T>(constraintProblem, assignedVariable);
+	}
+}
\ No newline at end of file
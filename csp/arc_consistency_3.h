@@ -31,69 +31,78 @@ namespace std
 namespace csp
 {
 	template <typename T>
-	static void __eraseUnassignedNeighborFromNeighbors(std::vector<Ref<Variable<T>>>& neighbors, Variable<T>& unassignedNeighbor)
+	static bool __hasSupport(const Constraint<T>& sharedConstraint, Variable<T>& neighbor)
 	{
-		for (auto it = neighbors.cbegin(); it != neighbors.cend(); ++it)
+		// the domain of an assigned neighbor is its value, which is what makes maintaining arc consistency prune anything
+		if (neighbor.isAssigned())
 		{
-			if ((*it).get() == unassignedNeighbor)
-			{
-				neighbors.erase(it);
-				return;
-			}
+			return sharedConstraint.isConsistent();
 		}
-	}
-
-	template <typename T>
-	static std::optional<Constraint<T>> __findSharedConstraint(const std::vector<Ref<Constraint<T>>>& firstVariableConstraints,
-		const std::vector<Ref<Constraint<T>>>& secondVariableConstraints)
-	{
-		std::optional<Constraint<T>> sharedConstr;
-		size_t firstSize = firstVariableConstraints.size();
-		size_t secondSize = secondVariableConstraints.size();
-		const std::vector<Ref<Constraint<T>>>& shorterVec = firstSize <= secondSize ? firstVariableConstraints : secondVariableConstraints;
-		const std::vector<Ref<Constraint<T>>>& longerVec = firstSize <= secondSize ? secondVariableConstraints : firstVariableConstraints;
-		bool notFoundSharedConstraint = true;
 
-		for (auto it = shorterVec.begin(); it != shorterVec.end() && notFoundSharedConstraint; ++it)
+		bool isSupported = false;
+		const size_t neighborDomainSize = neighbor.getDomain().size();
+		for (size_t i = 0; i < neighborDomainSize && !isSupported; ++i)
 		{
-			for (Constraint<T>& constrOfLonger : longerVec)
-			{
-				if (*it == constrOfLonger)
-				{
-					sharedConstr = (*it).get();
-					notFoundSharedConstraint = false;
-					break;
-				}
-			}
+			neighbor.assignByIdx(i);
+			isSupported = sharedConstraint.isConsistent();
+			neighbor.unassign();
 		}
-		return sharedConstr;
+		return isSupported;
 	}
 
 	template <typename T>
-	static bool __revise(ConstraintProblem<T>& constraintProblem, Variable<T>& variable, Variable<T>& neighbor)
+	static bool __revise(ConstraintProblem<T>& constraintProblem, size_t varIdx, size_t neighborIdx)
 	{
+		Variable<T>& variable = constraintProblem.getVariable(varIdx);
 		if (variable.isAssigned())
 		{
 			return false;
 		}
 		bool revised = false;
-		const std::vector<Ref<Constraint<T>>>& variableConstraints = constraintProblem.getConstraintsContainingVariable(variable);
-		const std::vector<Ref<Constraint<T>>>& neighborConstraints = constraintProblem.getConstraintsContainingVariable(neighbor);
-		std::optional<Constraint<T>> optSharedConstr = __findSharedConstraint<T>(variableConstraints, neighborConstraints);
-		if (optSharedConstr)
+		std::optional<size_t> optSharedConstrIdx = constraintProblem.getSharedConstraintIdx(varIdx, neighborIdx);
+		if (optSharedConstrIdx)
 		{
-			Constraint<T>& sharedConstraint = *optSharedConstr;
+			const Constraint<T>& sharedConstraint = constraintProblem.getConstraint(*optSharedConstrIdx);
+			Variable<T>& neighbor = constraintProblem.getVariable(neighborIdx);
 			const std::vector<T>& variableDomain = variable.getDomain();
-			for (size_t i = 0; i < variableDomain.size(); ++i)
+			if constexpr (__is_bitset_domain_type<T>)
+			{
+				// the unsupported values are collected, then pruned together in one word operation
+				if (const BitsetDomain<T>* pVariableBitsetDomain = constraintProblem.getBitsetDomain(variable))
+				{
+					BitsetDomain<T> unsupportedValues{ pVariableBitsetDomain->getBase() };
+					for (size_t i = 0; i < variableDomain.size(); ++i)
+					{
+						variable.assignByIdx(i);
+						if (!__hasSupport<T>(sharedConstraint, neighbor))
+						{
+							unsupportedValues.insert(variableDomain[i]);
+						}
+						variable.unassign();
+					}
+					if (!unsupportedValues.empty())
+					{
+						constraintProblem.removeFromDomain(variable, unsupportedValues);
+						revised = true;
+					}
+					return revised;
+				}
+			}
+
+			for (size_t i = 0; i < variableDomain.size(); )
 			{
 				variable.assignByIdx(i);
-				if (sharedConstraint.getConsistentDomainValues(neighbor).empty())
+				bool isUnsupported = !__hasSupport<T>(sharedConstraint, neighbor);
+				variable.unassign();
+				if (isUnsupported)
 				{
-					variable.unassign();
-					variable.removeFromDomainByIdx(i);
+					constraintProblem.removeFromDomainByIdx(variable, i);
 					revised = true;
 				}
-				variable.unassign();
+				else
+				{
+					++i;
+				}
 			}
 		}
 		return revised;
@@ -104,29 +113,27 @@ namespace csp
 namespace csp
 {
 	template <typename T>
-	bool ac3(ConstraintProblem<T>& constraintProblem, std::unordered_set<VariableRefsPair<T>>& arcs)
+	static bool __ac3(ConstraintProblem<T>& constraintProblem, std::unordered_set<VariableRefsPair<T>>& arcs)
 	{
 		while (!arcs.empty())
 		{
 			const auto& itToStart = arcs.cbegin();
 			auto [unassignedVar, unassignedNeighbor] = *itToStart;
 			arcs.erase(itToStart);
-			if (__revise<T>(constraintProblem, unassignedVar.get(), unassignedNeighbor.get()))
+			size_t varIdx = constraintProblem.getVariableIdx(unassignedVar);
+			size_t neighborIdx = constraintProblem.getVariableIdx(unassignedNeighbor);
+			if (__revise<T>(constraintProblem, varIdx, neighborIdx))
 			{
-				if (constraintProblem.getConsistentDomain(unassignedVar).empty())
+				if (constraintProblem.isConsistentDomainEmpty(unassignedVar))
 				{
 					return false;
 				}
 
-				std::vector<Ref<Variable<T>>> neighbors =
-					const_cast<std::vector<Ref<Variable<T>>>&>(constraintProblem.getNeighbors(unassignedVar));
-				__eraseUnassignedNeighborFromNeighbors<T>(neighbors, unassignedNeighbor.get());
-
-				if (!neighbors.empty())
+				for (size_t otherNeighborIdx : constraintProblem.getNeighborsIdxs(varIdx))
 				{
-					for (Variable<T>& neigh : neighbors)
+					if (otherNeighborIdx != neighborIdx)
 					{
-						arcs.emplace(neigh, unassignedVar);
+						arcs.emplace(constraintProblem.getVariable(otherNeighborIdx), unassignedVar);
 					}
 				}
 			}
@@ -135,6 +142,16 @@ namespace csp
 		return constraintProblem.isPotentiallySolvable();
 	}
 
+	// mac runs __ac3 within the search, whereas the values ac3 prunes as preprocessing are removed permanently
+	template <typename T>
+	bool ac3(ConstraintProblem<T>& constraintProblem, std::unordered_set<VariableRefsPair<T>>& arcs)
+	{
+		const size_t trailMark = constraintProblem.getTrailMark();
+		bool isPotentiallySolvable = __ac3<T>(constraintProblem, arcs);
+		constraintProblem.commitTrail(trailMark);
+		return isPotentiallySolvable;
+	}
+
 	template <typename T>
 	std::unordered_set<VariableRefsPair<T>> initArcsAC3(ConstraintProblem<T>& constraintProblem)
 	{
@@ -143,9 +160,9 @@ namespace csp
 		arcs.reserve(unassignedVars.size());
 		for (Variable<T>& unassignedVar : unassignedVars)
 		{
-			for (Variable<T>& unassignedNeighbor : constraintProblem.getNeighbors(unassignedVar))
+			for (size_t neighborIdx : constraintProblem.getNeighborsIdxs(constraintProblem.getVariableIdx(unassignedVar)))
 			{
-				arcs.emplace(unassignedVar, unassignedNeighbor);
+				arcs.emplace(unassignedVar, constraintProblem.getVariable(neighborIdx));
 			}
 		}
 		return arcs;
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+
+/*
+Arc Consistency 3rm (AC3rm) algorithm: AC3 with residual supports.
+A value a of x is supported on the arc (x, y) by a value b of y iff x = a and y = b are consistent with the constraint x and y share.
+The last support found for each (arc, value) is cached as a residue. Revising the arc first checks whether the residue is still
+in y's domain (or is y's value, if y is assigned), and only then scans y's domain for a new support.
+Unlike AC-2001's last supports, residues need no undoing when backtracking, hence nothing has to be recorded on the trail.
+Arcs are identified by dense ids: the arcs of x are (x, y) for its neighbors y, in the order of ConstraintProblem::getNeighborsIdxs,
+and the arcs queue is a FIFO deduplicated by a flag per arc, rather than a hash set of variables pairs.
+ArcConsistency3rm<T> keeps its residues between calls, thus an instance can be given as an Inference to the backtracking
+solvers (maintaining arc consistency) and reuse residues across the search tree. ac3rm and macRM are its stateless counterparts,
+and return the same results as ac3(constraintProblem, initArcsAC3(constraintProblem)) and mac respectively; ac3rm, like ac3,
+prunes permanently.
+*/
+
+namespace csp
+{
+	template <typename T>
+	class ArcConsistency3rm final
+	{
+	public:
+		ArcConsistency3rm<T>() :
+			m_pConstraintProblem{ nullptr },
+			m_vecArcsOffsets{ },
+			m_vecArcToVariableIdx{ },
+			m_vecReverseArcs{ },
+			m_vecResidues{ },
+			m_vecIsQueuedArc{ },
+			m_size_tConstraintChecksCount{ 0 }
+		{ }
+
+		// preprocessing: enforces arc consistency on all the arcs of the constraint problem's unassigned variables
+		bool enforce(ConstraintProblem<T>& constraintProblem)
+		{
+			this->init_arcs(constraintProblem);
+			std::queue<size_t> arcsQueue;
+			for (size_t arcId = 0; arcId < m_vecArcToVariableIdx.size(); ++arcId)
+			{
+				this->enqueue_arc(constraintProblem, arcId, arcsQueue);
+			}
+			return this->propagate(constraintProblem, arcsQueue) && constraintProblem.isPotentiallySolvable();
+		}
+
+		// inference: enforces arc consistency starting from the arcs (neighbor, assignedVariable)
+		bool operator()(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+		{
+			this->init_arcs(constraintProblem);
+			std::queue<size_t> arcsQueue;
+			this->enqueue_arcs_into(constraintProblem, constraintProblem.getVariableIdx(assignedVariable), arcsQueue);
+			return this->propagate(constraintProblem, arcsQueue);
+		}
+
+		// number of Constraint::isConsistent evaluations made by the revisions
+		constexpr size_t getConstraintChecksCount() const noexcept { return m_size_tConstraintChecksCount; }
+
+	private:
+		void init_arcs(const ConstraintProblem<T>& constraintProblem)
+		{
+			const size_t varsSize = constraintProblem.getVariables().size();
+			if (m_pConstraintProblem == &constraintProblem && m_vecArcsOffsets.size() == varsSize + 1)
+			{
+				return;
+			}
+			m_pConstraintProblem = &constraintProblem;
+			m_vecArcsOffsets.assign(varsSize + 1, 0);
+			m_vecArcToVariableIdx.clear();
+			for (size_t varIdx = 0; varIdx < varsSize; ++varIdx)
+			{
+				const size_t neighborsSize = constraintProblem.getNeighborsIdxs(varIdx).size();
+				m_vecArcsOffsets[varIdx + 1] = m_vecArcsOffsets[varIdx] + neighborsSize;
+				m_vecArcToVariableIdx.insert(m_vecArcToVariableIdx.end(), neighborsSize, varIdx);
+			}
+
+			// the constraint graph is symmetric, hence every arc (x, y) has its reverse arc (y, x)
+			m_vecReverseArcs.assign(m_vecArcToVariableIdx.size(), UNASSIGNED);
+			for (size_t arcId = 0; arcId < m_vecArcToVariableIdx.size(); ++arcId)
+			{
+				size_t varIdx = m_vecArcToVariableIdx[arcId];
+				size_t neighborIdx = this->get_arc_neighbor_idx(constraintProblem, arcId);
+				Span<const size_t> neighborNeighborsIdxs = constraintProblem.getNeighborsIdxs(neighborIdx);
+				const size_t* pVarIdx = std::find(neighborNeighborsIdxs.begin(), neighborNeighborsIdxs.end(), varIdx);
+				m_vecReverseArcs[arcId] = m_vecArcsOffsets[neighborIdx] + (pVarIdx - neighborNeighborsIdxs.begin());
+			}
+			m_vecResidues.assign(m_vecArcToVariableIdx.size(), std::unordered_map<T, T>{ });
+			m_vecIsQueuedArc.assign(m_vecArcToVariableIdx.size(), false);
+		}
+
+		size_t get_arc_neighbor_idx(const ConstraintProblem<T>& constraintProblem, size_t arcId) const noexcept
+		{
+			size_t varIdx = m_vecArcToVariableIdx[arcId];
+			return constraintProblem.getNeighborsIdxs(varIdx)[arcId - m_vecArcsOffsets[varIdx]];
+		}
+
+		void enqueue_arc(const ConstraintProblem<T>& constraintProblem, size_t arcId, std::queue<size_t>& arcsQueue)
+		{
+			if (!m_vecIsQueuedArc[arcId] && !constraintProblem.getVariable(m_vecArcToVariableIdx[arcId]).isAssigned())
+			{
+				m_vecIsQueuedArc[arcId] = true;
+				arcsQueue.push(arcId);
+			}
+		}
+
+		// enqueues the arcs (neighbor, var) of var's neighbors other than skippedNeighborIdx
+		void enqueue_arcs_into(const ConstraintProblem<T>& constraintProblem, size_t varIdx, std::queue<size_t>& arcsQueue,
+			size_t skippedNeighborIdx = UNASSIGNED)
+		{
+			Span<const size_t> neighborsIdxs = constraintProblem.getNeighborsIdxs(varIdx);
+			for (size_t neighborPosition = 0; neighborPosition < neighborsIdxs.size(); ++neighborPosition)
+			{
+				if (neighborsIdxs[neighborPosition] != skippedNeighborIdx)
+				{
+					this->enqueue_arc(constraintProblem, m_vecReverseArcs[m_vecArcsOffsets[varIdx] + neighborPosition], arcsQueue);
+				}
+			}
+		}
+
+		bool propagate(ConstraintProblem<T>& constraintProblem, std::queue<size_t>& arcsQueue)
+		{
+			bool isConsistent = true;
+			while (!arcsQueue.empty())
+			{
+				size_t arcId = arcsQueue.front();
+				arcsQueue.pop();
+				m_vecIsQueuedArc[arcId] = false;
+				if (!isConsistent)
+				{
+					continue;
+				}
+
+				if (this->revise(constraintProblem, arcId))
+				{
+					size_t varIdx = m_vecArcToVariableIdx[arcId];
+					if (constraintProblem.getVariable(varIdx).getDomain().empty())
+					{
+						// the queue is drained rather than abandoned, so the queued flags are left cleared for the next call
+						isConsistent = false;
+						continue;
+					}
+					this->enqueue_arcs_into(constraintProblem, varIdx, arcsQueue, this->get_arc_neighbor_idx(constraintProblem, arcId));
+				}
+			}
+			return isConsistent;
+		}
+
+		bool revise(ConstraintProblem<T>& constraintProblem, size_t arcId)
+		{
+			size_t varIdx = m_vecArcToVariableIdx[arcId];
+			size_t neighborIdx = this->get_arc_neighbor_idx(constraintProblem, arcId);
+			std::optional<size_t> optSharedConstrIdx = constraintProblem.getSharedConstraintIdx(varIdx, neighborIdx);
+			if (!optSharedConstrIdx)
+			{
+				return false;
+			}
+
+			const Constraint<T>& sharedConstraint = constraintProblem.getConstraint(*optSharedConstrIdx);
+			Variable<T>& var = constraintProblem.getVariable(varIdx);
+			Variable<T>& neighbor = constraintProblem.getVariable(neighborIdx);
+			std::unordered_map<T, T>& residues = m_vecResidues[arcId];
+			bool isRevised = false;
+			for (size_t i = var.getDomain().size(); 0 < i; --i)
+			{
+				const T& value = var.getDomain()[i - 1];
+				auto residueIt = residues.find(value);
+				if (residueIt != residues.end() && this->is_valid_residue(neighbor, residueIt->second))
+				{
+					continue;
+				}
+
+				var.assignByIdx(i - 1);
+				std::optional<T> optSupport = this->find_support(sharedConstraint, neighbor);
+				var.unassign();
+				if (optSupport)
+				{
+					residues.insert_or_assign(var.getDomain()[i - 1], *optSupport);
+				}
+				else
+				{
+					constraintProblem.removeFromDomainByIdx(var, i - 1);
+					isRevised = true;
+				}
+			}
+			return isRevised;
+		}
+
+		bool is_valid_residue(const Variable<T>& neighbor, const T& residue) const
+		{
+			if (neighbor.isAssigned())
+			{
+				return neighbor.getValue() == residue;
+			}
+			const std::vector<T>& neighborDomain = neighbor.getDomain();
+			return std::find(neighborDomain.cbegin(), neighborDomain.cend(), residue) != neighborDomain.cend();
+		}
+
+		std::optional<T> find_support(const Constraint<T>& sharedConstraint, Variable<T>& neighbor)
+		{
+			// the domain of an assigned neighbor is its value, which is what makes maintaining arc consistency prune anything
+			if (neighbor.isAssigned())
+			{
+				++m_size_tConstraintChecksCount;
+				return sharedConstraint.isConsistent() ? std::optional<T>{ neighbor.getValue() } : std::nullopt;
+			}
+
+			const size_t neighborDomainSize = neighbor.getDomain().size();
+			for (size_t i = 0; i < neighborDomainSize; ++i)
+			{
+				neighbor.assignByIdx(i);
+				++m_size_tConstraintChecksCount;
+				bool isSupported = sharedConstraint.isConsistent();
+				neighbor.unassign();
+				if (isSupported)
+				{
+					return neighbor.getDomain()[i];
+				}
+			}
+			return std::nullopt;
+		}
+
+		const ConstraintProblem<T>* m_pConstraintProblem;
+		std::vector<size_t> m_vecArcsOffsets;
+		std::vector<size_t> m_vecArcToVariableIdx;
+		std::vector<size_t> m_vecReverseArcs;
+		std::vector<std::unordered_map<T, T>> m_vecResidues;
+		std::vector<bool> m_vecIsQueuedArc;
+		size_t m_size_tConstraintChecksCount;
+	};
+
+	template <typename T>
+	bool ac3rm(ConstraintProblem<T>& constraintProblem)
+	{
+		const size_t trailMark = constraintProblem.getTrailMark();
+		ArcConsistency3rm<T> arcConsistency3rm;
+		bool isPotentiallySolvable = arcConsistency3rm.enforce(constraintProblem);
+		constraintProblem.commitTrail(trailMark);
+		return isPotentiallySolvable;
+	}
+
+	template <typename T>
+	bool macRM(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+	{
+		ArcConsistency3rm<T> arcConsistency3rm;
+		return arcConsistency3rm(constraintProblem, assignedVariable);
+	}
+}
\ No newline at end of file
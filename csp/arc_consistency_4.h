@@ -4,6 +4,7 @@
 #include "constraint_problem.h"
 
 // Arc Consistency 4 (AC4) algorithm
+// supports are counted between the first two variables of each constraint, see generalized_arc_consistency.h for n-ary constraints
 
 namespace csp
 {
@@ -48,12 +49,12 @@ namespace std
 namespace csp
 {
 	template <typename T>
-	static void __initialize_ac4(const std::vector<Ref<Constraint<T>>>& constraints,
+	static void __initialize_ac4(ConstraintProblem<T>& constraintProblem,
 		std::unordered_map<VariableValueNeighborTriplet<T>, int>& supportCounter,
 		std::unordered_map<VariableValuePair<T>, std::unordered_set<VariableValuePair<T>>>& variableValuePairsSupportedBy,
 		std::queue<VariableValuePair<T>>& unsupportedVariableValuePairs)
 	{
-		for (const Constraint<T>& constr : constraints)
+		for (const Constraint<T>& constr : constraintProblem.getConstraints())
 		{
 			const std::vector<Ref<Variable<T>>>& variables = constr.getVariables();
 			if (variables.size() == 1)
@@ -108,7 +109,7 @@ namespace csp
 					}
 					if (!supportCounter[variableValueNeighborTriplet])
 					{
-						firstVar->removeFromDomainByIdx(i);
+						constraintProblem.removeFromDomainByIdx(*firstVar, i);
 						unsupportedVariableValuePairs.emplace(firstPair);
 					}
 				}
@@ -121,10 +122,11 @@ namespace csp
 	template <typename T>
 	bool ac4(ConstraintProblem<T>& constraintProblem)
 	{
+		const size_t trailMark = constraintProblem.getTrailMark();
 		std::unordered_map<VariableValueNeighborTriplet<T>, int> supportCounter;
 		std::unordered_map<VariableValuePair<T>, std::unordered_set<VariableValuePair<T>>> variableValuePairsSupportedBy;
 		std::queue<VariableValuePair<T>> unsupportedVariableValuePairs;
-		__initialize_ac4<T>(constraintProblem.getConstraints(), supportCounter, variableValuePairsSupportedBy, unsupportedVariableValuePairs);
+		__initialize_ac4<T>(constraintProblem, supportCounter, variableValuePairsSupportedBy, unsupportedVariableValuePairs);
 
 		while (!unsupportedVariableValuePairs.empty())
 		{
@@ -145,13 +147,14 @@ namespace csp
 					--supportCounter[variableValueNeighborTriplet];
 					if (!supportCounter[variableValueNeighborTriplet])
 					{
-						firstVar.removeFromDomainByIdx(std::distance(firstDomainItBegin, serachRes));
+						constraintProblem.removeFromDomainByIdx(firstVar, std::distance(firstDomainItBegin, serachRes));
 						unsupportedVariableValuePairs.emplace(firstVarValuePair);
 					}
 				}
 			}
 		}
 
+		constraintProblem.commitTrail(trailMark);
 		return constraintProblem.isPotentiallySolvable();
 	}
 }
\ No newline at end of file
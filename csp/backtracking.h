@@ -6,46 +6,106 @@
 
 namespace csp
 {
-	template <typename T>
-	static bool __backtrackingSolver(const ConstraintProblem<T>& constraintProblem, AssignmentHistory<T>& assignmentHistory,
-		bool writeAssignmentHistory)
+	/*
+	Iterative backtracking engine, with an explicit stack of frames (variable idx, next value idx) rather than recursion.
+	The selected variable is the last unassigned one (by idx), hence the variables of the frames are in descending idx order,
+	and the next one is found by scanning down from the top frame's variable, without collecting the unassigned variables.
+	onCompleteAssignment is called whenever constraintProblem is completely assigned. If it returns true the search stops,
+	keeping the assignment, and true is returned. Otherwise the search backtracks, and false is returned once it is exhausted
+	or stopped, with the variables the search assigned unassigned.
+	Assignments and unassignments are written to pAssignmentHistory (if not null) in the order the recursive search made them.
+	*/
+	template <typename T, typename OnCompleteAssignment>
+	static bool __backtracking(const ConstraintProblem<T>& constraintProblem, OnCompleteAssignment& onCompleteAssignment,
+		AssignmentHistory<T>* pAssignmentHistory)
 	{
-		if (constraintProblem.isCompletelyAssigned())
+		const size_t varsSize = constraintProblem.getVariables().size();
+		std::vector<std::pair<size_t, size_t>> frames;	// variable idx, next value idx
+		frames.reserve(varsSize);
+
+		auto unassignVariable = [pAssignmentHistory](Variable<T>& var) -> void
 		{
-			if (constraintProblem.isConsistentlyAssigned())
-			{
-				return true;
-			}
-			else
+			var.unassign();
+			if (pAssignmentHistory)
 			{
-				return false;
+				pAssignmentHistory->emplace_back(var, std::optional<T>{});
 			}
-		}
+		};
 
-		const std::vector<Ref<Variable<T>>> unassignedVars = constraintProblem.getUnassignedVariables();
-		Variable<T>& selectedVar = unassignedVars.back();
-		const std::vector<T>& selectedDomain = selectedVar.getDomain();
-		for (size_t i = 0; i < selectedDomain.size(); ++i)
+		bool isDescending = true;
+		while (true)
 		{
-			selectedVar.assignByIdx(i);
-			if (writeAssignmentHistory)
+			if (isDescending)
 			{
-				assignmentHistory.emplace_back(selectedVar, std::optional<T>{ selectedDomain[i] });
+				size_t unassignedVarIdx = frames.empty() ? varsSize : frames.back().first;
+				while (unassignedVarIdx && constraintProblem.getVariable(unassignedVarIdx - 1).isAssigned())
+				{
+					--unassignedVarIdx;
+				}
+
+				if (!unassignedVarIdx)
+				{
+					if (onCompleteAssignment(constraintProblem))
+					{
+						return true;
+					}
+				}
+				else if (constraintProblem.isStopRequested())
+				{
+					for (; !frames.empty(); frames.pop_back())
+					{
+						Variable<T>& var = constraintProblem.getVariable(frames.back().first);
+						if (var.isAssigned())
+						{
+							unassignVariable(var);
+						}
+					}
+					return false;
+				}
+				else
+				{
+					frames.emplace_back(unassignedVarIdx - 1, 0);
+				}
 			}
 
-			if (__backtrackingSolver<T>(constraintProblem, assignmentHistory, writeAssignmentHistory))
+			if (frames.empty())
 			{
-				return true;
+				return false;
+			}
+			auto& [varIdx, nextValueIdx] = frames.back();
+			Variable<T>& selectedVar = constraintProblem.getVariable(varIdx);
+			if (selectedVar.isAssigned())
+			{
+				unassignVariable(selectedVar);
 			}
 
-			selectedVar.unassign();
-			if (writeAssignmentHistory)
+			if (nextValueIdx < selectedVar.getDomain().size())
+			{
+				selectedVar.assignByIdx(nextValueIdx);
+				if (pAssignmentHistory)
+				{
+					pAssignmentHistory->emplace_back(selectedVar, std::optional<T>{ selectedVar.getDomain()[nextValueIdx] });
+				}
+				++nextValueIdx;
+				isDescending = true;
+			}
+			else
 			{
-				assignmentHistory.emplace_back(selectedVar, std::optional<T>{});
+				frames.pop_back();
+				isDescending = false;
 			}
 		}
+	}
 
-		return false;
+	template <typename T>
+	static bool __backtrackingSolver(const ConstraintProblem<T>& constraintProblem, AssignmentHistory<T>& assignmentHistory,
+		bool writeAssignmentHistory)
+	{
+		auto isSolution = [](const ConstraintProblem<T>& completelyAssignedProblem) -> bool
+		{
+			return completelyAssignedProblem.isConsistentlyAssigned();
+		};
+		return __backtracking<T>(constraintProblem, isSolution, writeAssignmentHistory ? &assignmentHistory : nullptr);
 	}
 
 	template <typename T>
@@ -56,40 +116,50 @@ namespace csp
 		return assignmentHistory;
 	}
 
-	template <typename T>
-	void __backtrackingSolver_findAllSolutions(const ConstraintProblem<T>& constraintProblem, std::unordered_set<Assignment<T>>& solutions)
+	// calls onSolution with constraintProblem completely and consistently assigned, once for each solution
+	template <typename T, typename OnSolution>
+	static void __backtrackingSolver_visitAllSolutions(const ConstraintProblem<T>& constraintProblem, OnSolution& onSolution)
 	{
-		if (constraintProblem.isCompletelyAssigned())
+		auto visitSolution = [&onSolution](const ConstraintProblem<T>& completelyAssignedProblem) -> bool
 		{
-			if (constraintProblem.isConsistentlyAssigned())
-			{
-				solutions.emplace(constraintProblem.getCurrentAssignment());
-			}
-			else
+			if (completelyAssignedProblem.isConsistentlyAssigned())
 			{
-				return;
+				onSolution(completelyAssignedProblem);
 			}
-		}
-
-		const std::vector<Ref<Variable<T>>> unassignedVars = constraintProblem.getUnassignedVariables();
-		if (unassignedVars.empty())
-			return;
-
-		Variable<T>& selectedVar = unassignedVars.back();
-		const std::vector<T>& selectedDomain = selectedVar.getDomain();
-		for (size_t i = 0; i < selectedDomain.size(); ++i)
-		{
-			selectedVar.assignByIdx(i);
-			__backtrackingSolver_findAllSolutions<T>(constraintProblem, solutions);
-			selectedVar.unassign();
-		}
+			return false;
+		};
+		__backtracking<T>(constraintProblem, visitSolution, static_cast<AssignmentHistory<T>*>(nullptr));
 	}
 
 	template <typename T>
 	const std::unordered_set<Assignment<T>> backtrackingSolver_findAllSolutions(const ConstraintProblem<T>& constraintProblem)
 	{
 		std::unordered_set<Assignment<T>> solutions;
-		__backtrackingSolver_findAllSolutions<T>(constraintProblem, solutions);
+		auto insertSolution = [&solutions](const ConstraintProblem<T>& solvedProblem) -> void
+		{
+			solutions.emplace(solvedProblem.getCurrentAssignment());
+		};
+		__backtrackingSolver_visitAllSolutions<T>(constraintProblem, insertSolution);
 		return solutions;
 	}
+
+	// counts the solutions without materializing them
+	template <typename T>
+	uint64_t backtrackingSolver_countAllSolutions(const ConstraintProblem<T>& constraintProblem)
+	{
+		uint64_t solutionsCount = 0;
+		auto countSolution = [&solutionsCount](const ConstraintProblem<T>&) -> void { ++solutionsCount; };
+		__backtrackingSolver_visitAllSolutions<T>(constraintProblem, countSolution);
+		return solutionsCount;
+	}
+
+	/*
+	Calls solutionVisitor with constraintProblem assigned with each solution in turn, rather than copying the solutions.
+	The assignment is valid only during the call, and solutionVisitor must not change it.
+	*/
+	template <typename T>
+	void backtrackingSolver_forEachSolution(const ConstraintProblem<T>& constraintProblem, const SolutionVisitor<T>& solutionVisitor)
+	{
+		__backtrackingSolver_visitAllSolutions<T>(constraintProblem, solutionVisitor);
+	}
 }
\ No newline at end of file
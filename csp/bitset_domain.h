@@ -0,0 +1,146 @@
+#pragma once
+
+#include "pch.h"
+#include "initial_utilities.h"
+
+/*
+Bitset domain: the values of a domain of an integral type whose values span at most BITSET_DOMAIN_MAX_SIZE consecutive
+integers, stored as bit (value - base). Removing a set of values (pruning), intersecting, sizing (popcount) and checking for
+emptiness are word operations, as opposed to erasing from a vector of values or building unordered_sets of them.
+A Variable<T> keeps one next to its domain vector once ConstraintProblem<T>::setBitsetDomains is called, see there.
+*/
+
+namespace csp
+{
+	constexpr size_t BITSET_DOMAIN_MAX_SIZE = 256;
+
+	template <typename T>
+	constexpr bool __is_bitset_domain_type = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+	template <typename T>
+	class BitsetDomain final
+	{
+	public:
+		using Bits = std::bitset<BITSET_DOMAIN_MAX_SIZE>;
+
+		// an empty bitset domain of the values [base, base + BITSET_DOMAIN_MAX_SIZE)
+		BitsetDomain(T base) noexcept : m_base{ base }, m_bits{ }
+		{ }
+
+		// domain must fit (see fits), it need not be sorted
+		BitsetDomain(const std::vector<T>& domain) noexcept :
+			m_base{ domain.empty() ? T{ } : *std::min_element(domain.cbegin(), domain.cend()) },
+			m_bits{ }
+		{
+			for (T value : domain)
+			{
+				this->insert(value);
+			}
+		}
+
+		BitsetDomain(const BitsetDomain<T>& otherBitsetDomain) = default;
+		BitsetDomain<T>& operator=(const BitsetDomain<T>& otherBitsetDomain) = default;
+		~BitsetDomain() = default;
+
+		// whether a domain can be stored as a bitset domain, i.e. whether its values span at most BITSET_DOMAIN_MAX_SIZE integers
+		static bool fits(const std::vector<T>& domain) noexcept
+		{
+			if constexpr (__is_bitset_domain_type<T>)
+			{
+				if (domain.empty())
+				{
+					return true;
+				}
+				auto [minIt, maxIt] = std::minmax_element(domain.cbegin(), domain.cend());
+				return to_offset(*minIt, *maxIt) < BITSET_DOMAIN_MAX_SIZE;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		constexpr T getBase() const noexcept { return m_base; }
+
+		// whether value is in the values range of this domain, i.e. whether it can be inserted
+		bool covers(T value) const noexcept { return to_offset(m_base, value) < BITSET_DOMAIN_MAX_SIZE; }
+
+		bool contains(T value) const noexcept
+		{
+			return this->covers(value) && m_bits.test(to_offset(m_base, value));
+		}
+
+		void insert(T value) noexcept { m_bits.set(to_offset(m_base, value)); }
+
+		void erase(T value) noexcept { m_bits.reset(to_offset(m_base, value)); }
+
+		// both domains must have the same base, which holds for the bitset domains of one variable
+		void eraseAll(const BitsetDomain<T>& erasedValues) noexcept { m_bits &= ~erasedValues.m_bits; }
+
+		BitsetDomain<T>& operator&=(const BitsetDomain<T>& otherBitsetDomain) noexcept
+		{
+			m_bits &= otherBitsetDomain.m_bits;
+			return *this;
+		}
+
+		size_t size() const noexcept { return m_bits.count(); }
+
+		bool empty() const noexcept { return m_bits.none(); }
+
+		// in ascending order
+		std::vector<T> getValues() const
+		{
+			std::vector<T> values;
+			values.reserve(m_bits.count());
+			for (size_t offset = 0; offset < BITSET_DOMAIN_MAX_SIZE; ++offset)
+			{
+				if (m_bits.test(offset))
+				{
+					values.emplace_back(from_offset(offset));
+				}
+			}
+			return values;
+		}
+
+		friend bool operator==(const BitsetDomain<T>& left, const BitsetDomain<T>& right) noexcept
+		{
+			return left.m_base == right.m_base && left.m_bits == right.m_bits;
+		}
+
+		friend bool operator!=(const BitsetDomain<T>& left, const BitsetDomain<T>& right) noexcept
+		{
+			return !(left == right);
+		}
+
+	private:
+		// modular arithmetic, hence a value below base maps past BITSET_DOMAIN_MAX_SIZE rather than overflowing
+		static constexpr size_t to_offset(T base, T value) noexcept
+		{
+			if constexpr (__is_bitset_domain_type<T>)
+			{
+				using UnsignedT = std::make_unsigned_t<T>;
+				return static_cast<size_t>(static_cast<UnsignedT>(static_cast<UnsignedT>(value) - static_cast<UnsignedT>(base)));
+			}
+			else
+			{
+				return BITSET_DOMAIN_MAX_SIZE;
+			}
+		}
+
+		T from_offset(size_t offset) const noexcept
+		{
+			if constexpr (__is_bitset_domain_type<T>)
+			{
+				using UnsignedT = std::make_unsigned_t<T>;
+				return static_cast<T>(static_cast<UnsignedT>(static_cast<UnsignedT>(m_base) + static_cast<UnsignedT>(offset)));
+			}
+			else
+			{
+				return m_base;
+			}
+		}
+
+		T m_base;
+		Bits m_bits;
+	};
+}
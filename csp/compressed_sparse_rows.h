@@ -0,0 +1,89 @@
+#pragma once
+
+#include "pch.h"
+#include "initial_utilities.h"
+
+/*
+Compressed Sparse Rows (CSR) is a read-only adjacency structure: all rows are laid out back to back in a single
+contiguous vector of column indices, and row i occupies the range [offsets[i], offsets[i + 1]) of that vector.
+Iterating a row is a linear scan over contiguous memory, as opposed to a hash lookup followed by a node chase.
+*/
+
+namespace csp
+{
+	class CompressedSparseRows final
+	{
+	public:
+		CompressedSparseRows() = default;
+
+		CompressedSparseRows(const std::vector<std::vector<size_t>>& rows) :
+			m_vecOffsets{ init_offsets(rows) },
+			m_vecColumnIdxs{ init_columnIdxs(rows, m_vecOffsets.back()) }
+		{ }
+
+		CompressedSparseRows(const CompressedSparseRows& otherCsr) = default;
+		CompressedSparseRows& operator=(const CompressedSparseRows& otherCsr) = default;
+
+		CompressedSparseRows(CompressedSparseRows&& otherCsr) noexcept :
+			m_vecOffsets{ std::move(otherCsr.m_vecOffsets) },
+			m_vecColumnIdxs{ std::move(otherCsr.m_vecColumnIdxs) }
+		{ }
+
+		CompressedSparseRows& operator=(CompressedSparseRows&& otherCsr) noexcept
+		{
+			std::swap(m_vecOffsets, otherCsr.m_vecOffsets);
+			std::swap(m_vecColumnIdxs, otherCsr.m_vecColumnIdxs);
+			return *this;
+		}
+
+		~CompressedSparseRows() = default;
+
+		size_t getRowsSize() const noexcept { return m_vecOffsets.empty() ? 0 : m_vecOffsets.size() - 1; }
+
+		size_t getRowSize(size_t rowIdx) const noexcept { return m_vecOffsets[rowIdx + 1] - m_vecOffsets[rowIdx]; }
+
+		Span<const size_t> getRow(size_t rowIdx) const noexcept
+		{
+			return Span<const size_t>{ m_vecColumnIdxs.data() + m_vecOffsets[rowIdx], this->getRowSize(rowIdx) };
+		}
+
+		bool rowContains(size_t rowIdx, size_t columnIdx) const noexcept
+		{
+			for (size_t currColumnIdx : this->getRow(rowIdx))
+			{
+				if (currColumnIdx == columnIdx)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+		static std::vector<size_t> init_offsets(const std::vector<std::vector<size_t>>& rows)
+		{
+			std::vector<size_t> offsets;
+			offsets.reserve(rows.size() + 1);
+			offsets.push_back(0);
+			for (const std::vector<size_t>& row : rows)
+			{
+				offsets.push_back(offsets.back() + row.size());
+			}
+			return offsets;
+		}
+
+		static std::vector<size_t> init_columnIdxs(const std::vector<std::vector<size_t>>& rows, size_t columnIdxsSize)
+		{
+			std::vector<size_t> columnIdxs;
+			columnIdxs.reserve(columnIdxsSize);
+			for (const std::vector<size_t>& row : rows)
+			{
+				columnIdxs.insert(columnIdxs.end(), row.cbegin(), row.cend());
+			}
+			return columnIdxs;
+		}
+
+		std::vector<size_t> m_vecOffsets;
+		std::vector<size_t> m_vecColumnIdxs;
+	};
+}
\ No newline at end of file
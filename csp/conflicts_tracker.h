@@ -0,0 +1,219 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+
+/*
+ConflictsTracker incrementally maintains, for a completely assigned constraint problem:
+1. a satisfied flag per constraint.
+2. a conflicts count per variable, i.e. the number of unsatisfied constraints the variable participates in.
+3. the set of conflicted (conflicts count > 0) non read-only variables, as a sparse set with O(1) insertion, removal and random selection.
+4. the total number of unsatisfied constraints.
+Reassigning a variable through the tracker re-evaluates only the constraints containing it,
+hence a local search step costs O(degree * domain size) constraint evaluations rather than O(constraints * domain size).
+Variables must not be reassigned behind the tracker's back.
+*/
+
+namespace csp
+{
+	template <typename T>
+	class ConflictsTracker final
+	{
+	public:
+		ConflictsTracker<T>() = delete;
+
+		ConflictsTracker<T>(ConstraintProblem<T>& constraintProblem,
+			const std::optional<std::unordered_set<Ref<Variable<T>>>>& optReadOnlyVars = std::optional<std::unordered_set<Ref<Variable<T>>>>{}) :
+			m_constraintProblem{ constraintProblem },
+			m_vecIsReadOnlyVar{ init_isReadOnlyVar(constraintProblem, optReadOnlyVars) },
+			m_vecIsSatisfiedConstraint(constraintProblem.getConstraints().size(), false),
+			m_vecVarConflictsCount(constraintProblem.getVariables().size(), 0),
+			m_vecConflictedVarsIdxs{ },
+			m_vecConflictedVarPosition(constraintProblem.getVariables().size(), UNASSIGNED),
+			m_size_tUnsatisfiedConstraintsSize{ 0 },
+			m_defaultRandomEngine{ std::random_device{}() }
+		{
+			this->recount();
+		}
+
+		ConflictsTracker<T>(const ConflictsTracker<T>& otherConflictsTracker) = default;
+		ConflictsTracker<T>& operator=(const ConflictsTracker<T>& otherConflictsTracker) = delete;
+		ConflictsTracker<T>(ConflictsTracker<T>&& otherConflictsTracker) = default;
+		ConflictsTracker<T>& operator=(ConflictsTracker<T>&& otherConflictsTracker) = delete;
+		~ConflictsTracker<T>() = default;
+
+		// re-evaluates every constraint, e.g. after variables were reassigned not through the tracker
+		void recount()
+		{
+			std::fill(m_vecVarConflictsCount.begin(), m_vecVarConflictsCount.end(), 0);
+			for (size_t varIdx : m_vecConflictedVarsIdxs)
+			{
+				m_vecConflictedVarPosition[varIdx] = UNASSIGNED;
+			}
+			m_vecConflictedVarsIdxs.clear();
+			m_size_tUnsatisfiedConstraintsSize = 0;
+
+			const std::vector<Ref<Constraint<T>>>& constraints = m_constraintProblem.getConstraints();
+			for (size_t constrIdx = 0; constrIdx < constraints.size(); ++constrIdx)
+			{
+				m_vecIsSatisfiedConstraint[constrIdx] = true;
+				if (!constraints[constrIdx].get().isSatisfied())
+				{
+					this->set_unsatisfied(constrIdx);
+				}
+			}
+		}
+
+		constexpr size_t getUnsatisfiedConstraintsSize() const noexcept { return m_size_tUnsatisfiedConstraintsSize; }
+
+		size_t getVariableConflictsCount(size_t varIdx) const noexcept { return m_vecVarConflictsCount[varIdx]; }
+
+		bool isSatisfiedConstraint(size_t constrIdx) const noexcept { return m_vecIsSatisfiedConstraint[constrIdx]; }
+
+		const std::vector<size_t>& getConflictedVariablesIdxs() const noexcept { return m_vecConflictedVarsIdxs; }
+
+		size_t selectRandomConflictedVariableIdx()
+		{
+			std::uniform_int_distribution<size_t> distribution(0, m_vecConflictedVarsIdxs.size() - 1);
+			return m_vecConflictedVarsIdxs[distribution(m_defaultRandomEngine)];
+		}
+
+		// number of unsatisfied constraints containing the variable, were it assigned with assignmentIdx
+		size_t getConflictsCountIfAssigned(size_t varIdx, size_t assignmentIdx)
+		{
+			Variable<T>& var = m_constraintProblem.getVariable(varIdx);
+			size_t originalAssignmentIdx = var.getAssignmentIdx();
+			if (originalAssignmentIdx == assignmentIdx)
+			{
+				return m_vecVarConflictsCount[varIdx];
+			}
+
+			var.unassign();
+			var.assignByIdx(assignmentIdx);
+			size_t conflictsCount = 0;
+			for (size_t constrIdx : m_constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
+			{
+				if (!m_constraintProblem.getConstraint(constrIdx).isSatisfied())
+				{
+					++conflictsCount;
+				}
+			}
+			var.unassign();
+			if (originalAssignmentIdx != UNASSIGNED)
+			{
+				var.assignByIdx(originalAssignmentIdx);
+			}
+			return conflictsCount;
+		}
+
+		size_t selectMinConflictsAssignmentIdx(size_t varIdx)
+		{
+			size_t minConflictsCount = std::numeric_limits<size_t>::max();
+			size_t minConflictsAssignmentIdx = UNASSIGNED;
+			size_t minConflictsAssignmentsSize = 0;
+			const size_t domainSize = m_constraintProblem.getVariable(varIdx).getDomain().size();
+			for (size_t i = 0; i < domainSize; ++i)
+			{
+				size_t conflictsCount = this->getConflictsCountIfAssigned(varIdx, i);
+				if (conflictsCount < minConflictsCount)
+				{
+					minConflictsCount = conflictsCount;
+					minConflictsAssignmentIdx = i;
+					minConflictsAssignmentsSize = 1;
+				}
+				else if (conflictsCount == minConflictsCount)
+				{
+					// reservoir sampling of a uniformly random minimal assignment
+					++minConflictsAssignmentsSize;
+					std::uniform_int_distribution<size_t> distribution(0, minConflictsAssignmentsSize - 1);
+					if (!distribution(m_defaultRandomEngine))
+					{
+						minConflictsAssignmentIdx = i;
+					}
+				}
+			}
+			return minConflictsAssignmentIdx;
+		}
+
+		void reassign(size_t varIdx, size_t assignmentIdx)
+		{
+			Variable<T>& var = m_constraintProblem.getVariable(varIdx);
+			var.unassign();
+			var.assignByIdx(assignmentIdx);
+			for (size_t constrIdx : m_constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
+			{
+				bool isSatisfied = m_constraintProblem.getConstraint(constrIdx).isSatisfied();
+				if (isSatisfied && !m_vecIsSatisfiedConstraint[constrIdx])
+				{
+					this->set_satisfied(constrIdx);
+				}
+				else if (!isSatisfied && m_vecIsSatisfiedConstraint[constrIdx])
+				{
+					this->set_unsatisfied(constrIdx);
+				}
+			}
+		}
+
+	private:
+		static std::vector<bool> init_isReadOnlyVar(const ConstraintProblem<T>& constraintProblem,
+			const std::optional<std::unordered_set<Ref<Variable<T>>>>& optReadOnlyVars)
+		{
+			const std::vector<Ref<Variable<T>>>& variables = constraintProblem.getVariables();
+			std::vector<bool> isReadOnlyVar(variables.size(), false);
+			if (optReadOnlyVars)
+			{
+				for (size_t varIdx = 0; varIdx < variables.size(); ++varIdx)
+				{
+					isReadOnlyVar[varIdx] = (*optReadOnlyVars).count(variables[varIdx]);
+				}
+			}
+			return isReadOnlyVar;
+		}
+
+		void set_satisfied(size_t constrIdx)
+		{
+			m_vecIsSatisfiedConstraint[constrIdx] = true;
+			--m_size_tUnsatisfiedConstraintsSize;
+			for (size_t varIdx : m_constraintProblem.getVariablesIdxsOfConstraint(constrIdx))
+			{
+				if (!--m_vecVarConflictsCount[varIdx] && !m_vecIsReadOnlyVar[varIdx])
+				{
+					this->erase_conflicted_var(varIdx);
+				}
+			}
+		}
+
+		void set_unsatisfied(size_t constrIdx)
+		{
+			m_vecIsSatisfiedConstraint[constrIdx] = false;
+			++m_size_tUnsatisfiedConstraintsSize;
+			for (size_t varIdx : m_constraintProblem.getVariablesIdxsOfConstraint(constrIdx))
+			{
+				if (!m_vecVarConflictsCount[varIdx]++ && !m_vecIsReadOnlyVar[varIdx])
+				{
+					m_vecConflictedVarPosition[varIdx] = m_vecConflictedVarsIdxs.size();
+					m_vecConflictedVarsIdxs.push_back(varIdx);
+				}
+			}
+		}
+
+		void erase_conflicted_var(size_t varIdx)
+		{
+			size_t position = m_vecConflictedVarPosition[varIdx];
+			size_t lastVarIdx = m_vecConflictedVarsIdxs.back();
+			m_vecConflictedVarsIdxs[position] = lastVarIdx;
+			m_vecConflictedVarPosition[lastVarIdx] = position;
+			m_vecConflictedVarsIdxs.pop_back();
+			m_vecConflictedVarPosition[varIdx] = UNASSIGNED;
+		}
+
+		ConstraintProblem<T>& m_constraintProblem;
+		const std::vector<bool> m_vecIsReadOnlyVar;
+		std::vector<bool> m_vecIsSatisfiedConstraint;
+		std::vector<size_t> m_vecVarConflictsCount;
+		std::vector<size_t> m_vecConflictedVarsIdxs;
+		std::vector<size_t> m_vecConflictedVarPosition;
+		size_t m_size_tUnsatisfiedConstraintsSize;
+		std::default_random_engine m_defaultRandomEngine;
+	};
+}
\ No newline at end of file
@@ -2,18 +2,50 @@
 
 #include "pch.h"
 #include "variable.h"
+#include "constraint_evaluators.h"
 
 
 namespace csp
 {
 	template <typename T>
 	using ConstraintEvaluator = std::function<bool(const std::vector<T>& assignedValues)>;
+
+	// the arithmetic built-in evaluators are not offered for other T, so that Constraint<T> does not demand arithmetic operators of T
+	template <typename T>
+	using BuiltInConstraintEvaluator = std::conditional_t<std::is_arithmetic_v<T>,
+		std::variant<AllDiff<T>, AllEqual<T>, ExactLengthExactSum<T>, TimeDelayer<T>, NotAttackingQueens<T>, LinearSum<T>>,
+		std::variant<AllDiff<T>, AllEqual<T>>>;
+
+	template <typename E, typename Variant>
+	struct __is_variant_alternative : std::false_type
+	{ };
+
+	template <typename E, typename... Alternatives>
+	struct __is_variant_alternative<E, std::variant<Alternatives...>> : std::disjunction<std::is_same<E, Alternatives>...>
+	{ };
+
+	template <typename T, typename E>
+	constexpr bool __is_built_in_constraint_evaluator_v = __is_variant_alternative<E, BuiltInConstraintEvaluator<T>>::value;
+
+	template <typename T, typename BuiltInVariant>
+	struct __any_constraint_evaluator;
+
+	template <typename T, typename... BuiltIns>
+	struct __any_constraint_evaluator<T, std::variant<BuiltIns...>>
+	{
+		using type = std::variant<ConstraintEvaluator<T>, BuiltIns...>;
+	};
+
+	// either a type-erased user evaluator or one of the built-in evaluators
+	template <typename T>
+	using AnyConstraintEvaluator = typename __any_constraint_evaluator<T, BuiltInConstraintEvaluator<T>>::type;
 }
 
 namespace csp
 {
 	template<typename T> class duplicate_variable_error;
 	template<typename T> class uncontained_variable_error;
+	template<typename T> class linear_sum_arity_error;
 
 
 	template <typename T>
@@ -24,7 +56,7 @@ namespace csp
 		Constraint(const std::vector<Ref<Variable<T>>>& variables, const ConstraintEvaluator<T>& evaluateConstraint) :
 			m_usetVariableAddresses{ init_varsAddresses(variables) },
 			m_vecVariables{ variables }, 
-			m_ceEvaluateConstraint{ evaluateConstraint }
+			m_anyceEvaluateConstraint{ init_evaluator(evaluateConstraint) }
 		{
 			if (m_vecVariables.size() == 1)
 			{
@@ -32,10 +64,25 @@ namespace csp
 			}
 		}
 
+		// accepts a built-in evaluator or an AnyConstraintEvaluator<T>, lambdas and function pointers go through the overload above
+		template <typename BuiltInEvaluator, typename = std::enable_if_t<__is_built_in_constraint_evaluator_v<T, BuiltInEvaluator> ||
+			std::is_same_v<BuiltInEvaluator, AnyConstraintEvaluator<T>>>>
+		Constraint(const std::vector<Ref<Variable<T>>>& variables, const BuiltInEvaluator& evaluateConstraint) :
+			m_usetVariableAddresses{ init_varsAddresses(variables) },
+			m_vecVariables{ variables },
+			m_anyceEvaluateConstraint{ evaluateConstraint }
+		{
+			this->verify_linear_sum_arity();
+			if (m_vecVariables.size() == 1)
+			{
+				enforce_unary_constraint();
+			}
+		}
+
 		Constraint(const Constraint<T>& otherConstraint) : 
 			m_usetVariableAddresses{ otherConstraint.m_usetVariableAddresses },
 			m_vecVariables{ otherConstraint.m_vecVariables }, 
-			m_ceEvaluateConstraint{ otherConstraint.m_ceEvaluateConstraint }
+			m_anyceEvaluateConstraint{ otherConstraint.m_anyceEvaluateConstraint }
 		{ }
 
 		Constraint<T>& operator=(const Constraint<T>& otherConstraint)
@@ -46,21 +93,29 @@ namespace csp
 		Constraint<T>(Constraint<T>&& otherConstraint) noexcept :
 			m_usetVariableAddresses{ std::move(otherConstraint.m_usetVariableAddresses) },
 			m_vecVariables{ std::move(otherConstraint.m_vecVariables) },
-			m_ceEvaluateConstraint{ std::move(otherConstraint.m_ceEvaluateConstraint) }
+			m_anyceEvaluateConstraint{ std::move(otherConstraint.m_anyceEvaluateConstraint) }
 		{ }
 
 		Constraint<T>& operator=(Constraint<T>&& otherConstraint) noexcept
 		{
 			std::swap(m_usetVariableAddresses, otherConstraint.m_usetVariableAddresses);
 			std::swap(m_vecVariables, otherConstraint.m_vecVariables);
-			std::swap(m_ceEvaluateConstraint, otherConstraint.m_ceEvaluateConstraint);
+			std::swap(m_anyceEvaluateConstraint, otherConstraint.m_anyceEvaluateConstraint);
 			return *this;
 		}
 
 		~Constraint() = default;
 
 		const std::vector<Ref<Variable<T>>>& getVariables() const noexcept { return m_vecVariables; }
-		const ConstraintEvaluator<T>& getConstraintEvaluator() const noexcept { return m_ceEvaluateConstraint; }
+		const ConstraintEvaluator<T> getConstraintEvaluator() const
+		{
+			return std::visit([](const auto& evaluateConstraint) -> ConstraintEvaluator<T> { return evaluateConstraint; },
+				m_anyceEvaluateConstraint);
+		}
+
+		const AnyConstraintEvaluator<T>& getAnyConstraintEvaluator() const noexcept { return m_anyceEvaluateConstraint; }
+
+		constexpr bool hasBuiltInConstraintEvaluator() const noexcept { return m_anyceEvaluateConstraint.index() != 0; }
 
 		constexpr bool isCompletelyAssigned() const noexcept
 		{
@@ -76,34 +131,14 @@ namespace csp
 
 		constexpr bool isConsistent() const noexcept
 		{
-			std::vector<T> values;
-			values.reserve(m_vecVariables.size());
-			for (const Variable<T>& var : m_vecVariables)
-			{
-				if (var.isAssigned())
-				{
-					values.emplace_back(var.getValue());
-				}
-			}
-			return m_ceEvaluateConstraint(values);
+			return std::visit([this](const auto& evaluateConstraint) -> bool
+				{ return this->evaluate_assigned_values(evaluateConstraint, false); }, m_anyceEvaluateConstraint);
 		}
 
 		constexpr bool isSatisfied() const noexcept
 		{
-			std::vector<T> values;
-			values.reserve(m_vecVariables.size());
-			for (const Variable<T>& var : m_vecVariables)
-			{
-				if (var.isAssigned())
-				{
-					values.emplace_back(var.getValue());
-				}
-				else
-				{
-					return false;
-				}
-			}
-			return m_ceEvaluateConstraint(values);
+			return std::visit([this](const auto& evaluateConstraint) -> bool
+				{ return this->evaluate_assigned_values(evaluateConstraint, true); }, m_anyceEvaluateConstraint);
 		}
 
 		const std::vector<T> getConsistentDomainValues(Variable<T>& var) const
@@ -174,6 +209,83 @@ namespace csp
 
 
 		private:
+			/*
+			The assigned values passed to the constraint evaluator are gathered into a per thread scratch buffer
+			which is reused across calls, hence in steady state evaluating a constraint performs no heap allocations.
+			There is a buffer per nesting depth, so an evaluator may itself evaluate other constraints.
+			std::deque is used because, unlike std::vector, growing it does not invalidate references to its elements.
+			*/
+			class AssignedValuesBuffer final
+			{
+			public:
+				AssignedValuesBuffer() : m_size_tDepth{ get_depth()++ }
+				{
+					std::deque<std::vector<T>>& buffers = get_buffers();
+					if (buffers.size() <= m_size_tDepth)
+					{
+						buffers.emplace_back();
+					}
+					buffers[m_size_tDepth].clear();
+				}
+
+				AssignedValuesBuffer(const AssignedValuesBuffer& otherBuffer) = delete;
+				AssignedValuesBuffer& operator=(const AssignedValuesBuffer& otherBuffer) = delete;
+
+				~AssignedValuesBuffer() { --get_depth(); }
+
+				std::vector<T>& get() const noexcept { return get_buffers()[m_size_tDepth]; }
+
+			private:
+				static size_t& get_depth() noexcept
+				{
+					thread_local size_t depth = 0;
+					return depth;
+				}
+
+				static std::deque<std::vector<T>>& get_buffers() noexcept
+				{
+					thread_local std::deque<std::vector<T>> buffers;
+					return buffers;
+				}
+
+				size_t m_size_tDepth;
+			};
+
+			// the evaluator's type is a template parameter, hence for built-in evaluators the call is statically dispatched
+			template <typename Evaluator>
+			bool evaluate_assigned_values(const Evaluator& evaluateConstraint, bool demandCompleteAssignment) const
+			{
+				AssignedValuesBuffer assignedValuesBuffer;
+				std::vector<T>& values = assignedValuesBuffer.get();
+				for (const Variable<T>& var : m_vecVariables)
+				{
+					if (var.isAssigned())
+					{
+						values.emplace_back(var.getValue());
+					}
+					else if (demandCompleteAssignment)
+					{
+						return false;
+					}
+				}
+				return evaluateConstraint(values);
+			}
+
+			static AnyConstraintEvaluator<T> init_evaluator(const ConstraintEvaluator<T>& evaluateConstraint)
+			{
+				using EvaluatorFunctionPtr = bool(*)(const std::vector<T>&);
+				const EvaluatorFunctionPtr* pEvaluatorFunctionPtr = evaluateConstraint.template target<EvaluatorFunctionPtr>();
+				if (pEvaluatorFunctionPtr && *pEvaluatorFunctionPtr == &allDiff<T>)
+				{
+					return AllDiff<T>{};
+				}
+				else if (pEvaluatorFunctionPtr && *pEvaluatorFunctionPtr == &allEqual<T>)
+				{
+					return AllEqual<T>{};
+				}
+				return evaluateConstraint;
+			}
+
 			static const std::unordered_set<Variable<T>*> init_varsAddresses(const std::vector<Ref<Variable<T>>>& variables)
 			{
 				std::unordered_set<Variable<T>*> varsAddresses;
@@ -199,6 +311,19 @@ namespace csp
 				}
 			}
 
+			// LinearSum matches the assigned values to its coefficients by position
+			void verify_linear_sum_arity() const
+			{
+				if constexpr (std::is_arithmetic_v<T>)
+				{
+					const LinearSum<T>* pLinearSum = std::get_if<LinearSum<T>>(&m_anyceEvaluateConstraint);
+					if (pLinearSum && pLinearSum->coefficients.size() != m_vecVariables.size())
+					{
+						throw linear_sum_arity_error<T>(*this, pLinearSum->coefficients.size());
+					}
+				}
+			}
+
 			void verify_variable_is_contained(Variable<T>& var) const
 			{
 				if (!m_usetVariableAddresses.count(&(var)))
@@ -209,7 +334,7 @@ namespace csp
 
 			std::unordered_set<Variable<T>*> m_usetVariableAddresses;
 			std::vector<Ref<Variable<T>>> m_vecVariables;
-			ConstraintEvaluator<T> m_ceEvaluateConstraint;
+			AnyConstraintEvaluator<T> m_anyceEvaluateConstraint;
 	};
 
 
@@ -231,6 +356,16 @@ namespace csp
 			+ constr.toString() }
 		{ }
 	};
+
+	template<typename T>
+	class linear_sum_arity_error : public std::invalid_argument
+	{
+	public:
+		linear_sum_arity_error(const Constraint<T>& constr, size_t coefficientsSize) :
+			std::invalid_argument{ "LinearSum has " + std::to_string(coefficientsSize) + " coefficients, but it constrains " +
+			std::to_string(constr.getVariables().size()) + " variables in\n" + constr.toString() }
+		{ }
+	};
 }
 
 
@@ -20,10 +20,9 @@ namespace csp
 	template <typename T>
 	bool allEqual(const std::vector<T>& assignedValues)
 	{
-		T lastValue = assignedValues.back();
-		for (size_t i = 0; i < assignedValues.size() - 2; ++i)
+		for (size_t i = 1; i < assignedValues.size(); ++i)
 		{
-			if (assignedValues[i] != lastValue)
+			if (!(assignedValues[i] == assignedValues[0]))
 			{
 				return false;
 			}
@@ -31,9 +30,27 @@ namespace csp
 		return true;
 	}
 
+	constexpr size_t ALL_DIFF_PAIRWISE_SIZE_LIMIT = 32;
+
 	template <typename T>
 	bool allDiff(const std::vector<T>& assignedValues)
 	{
+		// for few values pairwise comparisons are cheaper than hashing, and need no allocations
+		if (assignedValues.size() <= ALL_DIFF_PAIRWISE_SIZE_LIMIT)
+		{
+			for (size_t i = 1; i < assignedValues.size(); ++i)
+			{
+				for (size_t j = 0; j < i; ++j)
+				{
+					if (assignedValues[i] == assignedValues[j])
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
 		std::unordered_set<T> seenValues;
 		seenValues.reserve(assignedValues.size());
 		for (size_t i = 0; i < assignedValues.size(); ++i)
@@ -96,4 +113,101 @@ namespace csp
 			}
 		}
 	};
+
+	enum class LinearRelation
+	{
+		EQUAL,
+		LESS_EQUAL,
+		GREATER_EQUAL
+	};
+
+	// signed and wide, so that e.g. unsigned variables may have negative coefficients and sums do not overflow
+	template <typename T>
+	using LinearValue = std::conditional_t<std::is_integral_v<T>, long long, long double>;
+
+	// sum of coefficients[i] * x_i, where x_i is the i-th variable of the constraint, is related to rightHandSide
+	template <typename T>
+	struct LinearSum
+	{
+		std::vector<LinearValue<T>> coefficients;
+		LinearRelation relation;
+		LinearValue<T> rightHandSide;
+
+		LinearSum(const std::vector<LinearValue<T>>& _coefficients, LinearRelation _relation, LinearValue<T> _rightHandSide) :
+			coefficients{ _coefficients }, relation{ _relation }, rightHandSide{ _rightHandSide }
+		{
+			static_assert(std::is_arithmetic_v<T>, "T must be arithmetic for LinearSum");
+		}
+
+		// the values of a partial assignment can not be matched to their coefficients, hence only complete assignments are judged
+		bool operator()(const std::vector<T>& assignedValues) const noexcept
+		{
+			if (assignedValues.size() < coefficients.size())
+			{
+				return true;
+			}
+
+			LinearValue<T> sum = 0;
+			for (size_t i = 0; i < coefficients.size(); ++i)
+			{
+				sum += coefficients[i] * static_cast<LinearValue<T>>(assignedValues[i]);
+			}
+			switch (relation)
+			{
+			case LinearRelation::EQUAL:
+				return sum == rightHandSide;
+			case LinearRelation::LESS_EQUAL:
+				return sum <= rightHandSide;
+			default:
+				return rightHandSide <= sum;
+			}
+		}
+	};
+
+	/*
+	Built-in evaluators kinds. Constraints constructed with one of these (or with allDiff / allEqual function pointers)
+	store it in a closed std::variant rather than in a type-erased std::function, so the evaluator is known at compile time
+	at the call site and could be inlined into the loop gathering the assigned values.
+	*/
+	template <typename T>
+	struct AllDiff
+	{
+		bool operator()(const std::vector<T>& assignedValues) const
+		{
+			return allDiff<T>(assignedValues);
+		}
+	};
+
+	template <typename T>
+	struct AllEqual
+	{
+		bool operator()(const std::vector<T>& assignedValues) const noexcept
+		{
+			return allEqual<T>(assignedValues);
+		}
+	};
+
+	// binary constraint of two queens located in columns which are columnsDifference apart, values are the queens rows
+	template <typename T>
+	struct NotAttackingQueens
+	{
+		T columnsDifference;
+
+		NotAttackingQueens(T _columnsDifference) : columnsDifference{ _columnsDifference }
+		{
+			static_assert(std::is_arithmetic_v<T>, "T must be arithmetic for NotAttackingQueens");
+		}
+
+		bool operator()(const std::vector<T>& assignedValues) const noexcept
+		{
+			if (assignedValues.size() < 2)
+			{
+				return true;
+			}
+			T firstRow = assignedValues[0];
+			T secondRow = assignedValues[1];
+			T rowsDifference = firstRow < secondRow ? secondRow - firstRow : firstRow - secondRow;
+			return firstRow != secondRow && rowsDifference != columnsDifference;
+		}
+	};
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "pch.h"
 #include "constraint.h"
+#include "compressed_sparse_rows.h"
 
 
 namespace csp
@@ -14,6 +15,13 @@ namespace csp
 
 	template <typename T>
 	using VariableValuePair = std::pair<Ref<csp::Variable<T>>, T>;
+
+	template <typename T>
+	class ConstraintProblem;
+
+	// called by the solvers' forEachSolution functions with the problem assigned with a solution
+	template <typename T>
+	using SolutionVisitor = std::function<void(const ConstraintProblem<T>&)>;
 }
 
 namespace csp
@@ -24,28 +32,42 @@ namespace csp
 	class ConstraintProblem final
 	{
 	private:
-		using VarToConstraintsMap = std::unordered_map<Ref<Variable<T>>, std::vector<Ref<Constraint<T>>>>;
-		using AdjacencyListConstraintGraph = std::unordered_map<Ref<Variable<T>>, std::vector<Ref<Variable<T>>>>;
 		using NameToVariableRefMap = std::unordered_map<std::string, Ref<Variable<T>>>;
+		using VariableToIdxMap = std::unordered_map<Ref<Variable<T>>, size_t>;
+		using DomainTrail = std::vector<std::tuple<Ref<Variable<T>>, size_t, T>>;	// variable, removed value idx, removed value
 
 	public:
 		ConstraintProblem<T>() = delete;
 		ConstraintProblem<T>(const std::vector<Ref<Constraint<T>>>& constraints,
 			const NameToVariableRefMap& umapNameToVariableRef = std::unordered_map<std::string, Ref<Variable<T>>>{}) :
 			m_vecConstraints{ init_constraints(constraints) },
-			m_umapVariableToConstraints{ init_variableToConstraints(m_vecConstraints) },
-			m_vecVariables{ init_variables(m_umapVariableToConstraints) },
-			m_umapConstraintGraph{ init_constraintGraph(m_umapVariableToConstraints) }, 
-			m_umapNameToVariableRef{ umapNameToVariableRef }
+			m_vecVariables{ init_variables(m_vecConstraints) },
+			m_umapNameToVariableRef{ umapNameToVariableRef },
+			m_umapVariableToIdx{ init_variableToIdx(m_vecVariables) },
+			m_csrConstraintToVariables{ init_constraintToVariables(m_vecConstraints, m_umapVariableToIdx) },
+			m_csrVariableToConstraints{ init_variableToConstraintsIdxs(m_csrConstraintToVariables, m_vecVariables.size()) },
+			m_csrConstraintGraph{ init_constraintGraphIdxs(m_csrConstraintToVariables, m_csrVariableToConstraints) },
+			m_vecTrail{ },
+			m_boolBitsetDomains{ false },
+			m_pStopFlag{ nullptr },
+			m_pUnassignedVariablesSet{ init_unassignedVariablesSet(m_vecVariables) }
 		{ }
 
 		ConstraintProblem<T>(const ConstraintProblem<T>& otherConstrProb) : 
 			m_vecConstraints{ otherConstrProb.m_vecConstraints },
-			m_umapVariableToConstraints{ otherConstrProb.m_umapVariableToConstraints }, 
 			m_vecVariables{ otherConstrProb.m_vecVariables },
-			m_umapConstraintGraph{ otherConstrProb.m_umapConstraintGraph }, 
-			m_umapNameToVariableRef{ otherConstrProb.m_umapNameToVariableRef }
-		{ }
+			m_umapNameToVariableRef{ otherConstrProb.m_umapNameToVariableRef },
+			m_umapVariableToIdx{ otherConstrProb.m_umapVariableToIdx },
+			m_csrConstraintToVariables{ otherConstrProb.m_csrConstraintToVariables },
+			m_csrVariableToConstraints{ otherConstrProb.m_csrVariableToConstraints },
+			m_csrConstraintGraph{ otherConstrProb.m_csrConstraintGraph },
+			m_vecTrail{ otherConstrProb.m_vecTrail },
+			m_boolBitsetDomains{ otherConstrProb.m_boolBitsetDomains },
+			m_pStopFlag{ otherConstrProb.m_pStopFlag },
+			m_pUnassignedVariablesSet{ otherConstrProb.m_pUnassignedVariablesSet }
+		{
+			m_pUnassignedVariablesSet->acquire();
+		}
 
 		ConstraintProblem<T>& operator=(const ConstraintProblem<T>& otherConstrProb)
 		{
@@ -55,23 +77,42 @@ namespace csp
 
 		ConstraintProblem<T>(ConstraintProblem<T>&& otherConstrProb) noexcept :
 			m_vecConstraints{ std::move(otherConstrProb.m_vecConstraints) },
-			m_umapVariableToConstraints{ std::move(otherConstrProb.m_umapVariableToConstraints) },
 			m_vecVariables{ std::move(otherConstrProb.m_vecVariables) },
-			m_umapConstraintGraph{ std::move(otherConstrProb.m_umapConstraintGraph) },
-			m_umapNameToVariableRef{ std::move(otherConstrProb.m_umapNameToVariableRef) }
+			m_umapNameToVariableRef{ std::move(otherConstrProb.m_umapNameToVariableRef) },
+			m_umapVariableToIdx{ std::move(otherConstrProb.m_umapVariableToIdx) },
+			m_csrConstraintToVariables{ std::move(otherConstrProb.m_csrConstraintToVariables) },
+			m_csrVariableToConstraints{ std::move(otherConstrProb.m_csrVariableToConstraints) },
+			m_csrConstraintGraph{ std::move(otherConstrProb.m_csrConstraintGraph) },
+			m_vecTrail{ std::move(otherConstrProb.m_vecTrail) },
+			m_boolBitsetDomains{ otherConstrProb.m_boolBitsetDomains },
+			m_pStopFlag{ otherConstrProb.m_pStopFlag },
+			m_pUnassignedVariablesSet{ std::move(otherConstrProb.m_pUnassignedVariablesSet) }
 		{ }
 
 		ConstraintProblem<T>& operator=(ConstraintProblem<T>&& otherConstrProb) noexcept
 		{
 			std::swap(m_vecConstraints, otherConstrProb.m_vecConstraints);
-			std::swap(m_umapVariableToConstraints, otherConstrProb.m_umapVariableToConstraints);
 			std::swap(m_vecVariables, otherConstrProb.m_vecVariables);
-			std::swap(m_umapConstraintGraph, otherConstrProb.m_umapConstraintGraph);
 			std::swap(m_umapNameToVariableRef, otherConstrProb.m_umapNameToVariableRef);
+			std::swap(m_umapVariableToIdx, otherConstrProb.m_umapVariableToIdx);
+			std::swap(m_csrConstraintToVariables, otherConstrProb.m_csrConstraintToVariables);
+			std::swap(m_csrVariableToConstraints, otherConstrProb.m_csrVariableToConstraints);
+			std::swap(m_csrConstraintGraph, otherConstrProb.m_csrConstraintGraph);
+			std::swap(m_vecTrail, otherConstrProb.m_vecTrail);
+			std::swap(m_boolBitsetDomains, otherConstrProb.m_boolBitsetDomains);
+			std::swap(m_pStopFlag, otherConstrProb.m_pStopFlag);
+			std::swap(m_pUnassignedVariablesSet, otherConstrProb.m_pUnassignedVariablesSet);
 			return *this;
 		}
 
-		~ConstraintProblem<T>() = default;
+		~ConstraintProblem<T>()
+		{
+			// a moved from problem has no set
+			if (m_pUnassignedVariablesSet)
+			{
+				m_pUnassignedVariablesSet->release();
+			}
+		}
 
 		ConstraintProblem<T> deepCopy(std::vector<Variable<T>>& copiedVars,
 			std::vector<Constraint<T>>& copiedConstraints) const
@@ -103,11 +144,13 @@ namespace csp
 					}
 				}
 
-				copiedConstraints.emplace_back(constrCopiedVarRefs, constr.getConstraintEvaluator());
+				copiedConstraints.emplace_back(constrCopiedVarRefs, constr.getAnyConstraintEvaluator());
 				copiedConstraintRefs.emplace_back(copiedConstraints.back());
 			}
 
 			ConstraintProblem<T> copiedConstraintProblem{ copiedConstraintRefs };
+			// the copied variables copied the bitset domains (if any) of the original ones
+			copiedConstraintProblem.m_boolBitsetDomains = m_boolBitsetDomains;
 			return copiedConstraintProblem;
 		}
 
@@ -115,26 +158,12 @@ namespace csp
 
 		constexpr bool isCompletelyAssigned() const noexcept
 		{
-			for (const Variable<T>& var : m_vecVariables)
-			{
-				if (!var.isAssigned())
-				{
-					return false;
-				}
-			}
-			return true;
+			return !m_pUnassignedVariablesSet->getUnassignedSize();
 		}
 
 		constexpr bool isCompletelyUnassigned() const noexcept
 		{
-			for (const Variable<T>& var : m_vecVariables)
-			{
-				if (var.isAssigned())
-				{
-					return false;
-				}
-			}
-			return true;
+			return !m_pUnassignedVariablesSet->getAssignedSize();
 		}
 
 		constexpr bool isConsistentlyAssigned() const noexcept
@@ -149,23 +178,32 @@ namespace csp
 			return true;
 		}
 
+		/*
+		Partial assignments are rejected in O(1) by the assigned variables count. Complete assignments are checked by scanning
+		the constraints up to the first inconsistent one, on the calling thread, since starting threads costs more than
+		evaluating the constraints of all but huge problems. Problems with at least PARALLEL_CONSISTENCY_CHECK_MIN_CONSTRAINTS
+		constraints are scanned by a parallel algorithm instead (constraints evaluations are thread safe).
+		Local searches keep their unsatisfied constraints count incrementally in a ConflictsTracker instead of calling this.
+		*/
 		constexpr bool isCompletelyConsistentlyAssigned() const noexcept
 		{
-			bool probIsCompletelyConsistentlyAssigned = false;
-			std::future<bool> probIsCompletelyAssigned = std::async(std::launch::async, &ConstraintProblem<T>::isCompletelyAssigned, this);
-			std::future<bool> probisConsistentlyAssigned = std::async(std::launch::async, &ConstraintProblem<T>::isConsistentlyAssigned, this);
-			if (probIsCompletelyAssigned.get() && probisConsistentlyAssigned.get())
+			if (!this->isCompletelyAssigned())
+			{
+				return false;
+			}
+			if (m_vecConstraints.size() < PARALLEL_CONSISTENCY_CHECK_MIN_CONSTRAINTS)
 			{
-				probIsCompletelyConsistentlyAssigned = true;
+				return this->isConsistentlyAssigned();
 			}
-			return probIsCompletelyConsistentlyAssigned;
+			return std::all_of(std::execution::par, m_vecConstraints.cbegin(), m_vecConstraints.cend(),
+				[](const Constraint<T>& constraint) -> bool { return constraint.isConsistent(); });
 		}
 
 		void unassignAllVariables()
 		{
-			for (Variable<T>& var : m_vecVariables)
+			while (m_pUnassignedVariablesSet->getAssignedSize())
 			{
-				var.unassign();
+				m_vecVariables[m_pUnassignedVariablesSet->getAssignedIdxs()[0]].get().unassign();
 			}
 		}
 
@@ -174,43 +212,62 @@ namespace csp
 			return m_vecVariables;
 		}
 
+		// in the order of getVariables()
 		const std::vector<Ref<Variable<T>>> getAssignedVariables() const noexcept
 		{
-			std::vector<Ref<Variable<T>>> assignedVariables;
-			for (Variable<T>& var : m_vecVariables)
-			{
-				if (var.isAssigned())
-				{
-					assignedVariables.emplace_back(var);
-				}
-			}
-			return assignedVariables;
+			return this->get_variables_in_idxs_order(m_pUnassignedVariablesSet->getAssignedIdxs(), true);
 		}
 
+		// in the order of getVariables()
 		const std::vector<Ref<Variable<T>>> getUnassignedVariables() const noexcept
 		{
-			std::vector<Ref<Variable<T>>> unassignedVariables;
-			for (Variable<T>& var : m_vecVariables)
-			{
-				if (!var.isAssigned())
-				{
-					unassignedVariables.emplace_back(var);
-				}
-			}
-			return unassignedVariables;
+			return this->get_variables_in_idxs_order(m_pUnassignedVariablesSet->getUnassignedIdxs(), false);
+		}
+
+		/*
+		Assigned and unassigned variables are tracked incrementally (see UnassignedVariablesSet), hence their amounts are O(1),
+		and their indices are iterated with no allocation. The indices are in no particular order, and a span's order is valid
+		only until the next assignment or unassignment of the problem's variables, including the temporary ones made by
+		e.g. getConsistentDomain.
+		*/
+		size_t getAssignedVariablesSize() const noexcept { return m_pUnassignedVariablesSet->getAssignedSize(); }
+
+		size_t getUnassignedVariablesSize() const noexcept { return m_pUnassignedVariablesSet->getUnassignedSize(); }
+
+		Span<const size_t> getAssignedVariablesIdxs() const noexcept { return m_pUnassignedVariablesSet->getAssignedIdxs(); }
+
+		Span<const size_t> getUnassignedVariablesIdxs() const noexcept { return m_pUnassignedVariablesSet->getUnassignedIdxs(); }
+
+		/*
+		The unassigned variables with the smallest current domain, and that size, found in amortized O(1) from buckets of
+		the unassigned variables by domain size. Current domains are those left by the inferences, not filtered by the
+		assigned variables like getConsistentDomain. The span is invalidated as getUnassignedVariablesIdxs, and by any domain change.
+		*/
+		size_t getSmallestUnassignedDomainSize() const noexcept { return m_pUnassignedVariablesSet->getSmallestDomainSize(); }
+
+		Span<const size_t> getSmallestDomainUnassignedVariablesIdxs() const noexcept
+		{
+			return m_pUnassignedVariablesSet->getSmallestDomainUnassignedIdxs();
 		}
 
 		const std::vector<Ref<Variable<T>>> getNeighbors(Variable<T>& var) const
 		{
-			return m_umapConstraintGraph.at(var);
+			std::vector<Ref<Variable<T>>> neighbors;
+			Span<const size_t> neighborsIdxs = m_csrConstraintGraph.getRow(m_umapVariableToIdx.at(var));
+			neighbors.reserve(neighborsIdxs.size());
+			for (size_t neighborIdx : neighborsIdxs)
+			{
+				neighbors.emplace_back(m_vecVariables[neighborIdx]);
+			}
+			return neighbors;
 		}
 
 		const std::vector<Ref<Variable<T>>> getAssignedNeighbors(Variable<T>& var) const
 		{
-			const std::vector<Ref<Variable<T>>>& neighbors = m_umapConstraintGraph.at(var);
 			std::vector<Ref<Variable<T>>> assignedNeighbors;
-			for (Variable<T>& neighborVar : neighbors)
+			for (size_t neighborIdx : m_csrConstraintGraph.getRow(m_umapVariableToIdx.at(var)))
 			{
+				Variable<T>& neighborVar = m_vecVariables[neighborIdx];
 				if (neighborVar.isAssigned())
 				{
 					assignedNeighbors.emplace_back(neighborVar);
@@ -221,10 +278,10 @@ namespace csp
 
 		const std::vector<Ref<Variable<T>>> getUnassignedNeighbors(Variable<T>& var) const
 		{
-			const std::vector<Ref<Variable<T>>>& neighbors = m_umapConstraintGraph.at(var);
 			std::vector<Ref<Variable<T>>> unassignedNeighbors;
-			for (Variable<T>& neighborVar : neighbors)
+			for (size_t neighborIdx : m_csrConstraintGraph.getRow(m_umapVariableToIdx.at(var)))
 			{
+				Variable<T>& neighborVar = m_vecVariables[neighborIdx];
 				if (!neighborVar.isAssigned())
 				{
 					unassignedNeighbors.emplace_back(neighborVar);
@@ -316,13 +373,116 @@ namespace csp
 			return unsatisfiedConstraintsSize;
 		}
 
-		const std::vector<Ref<Constraint<T>>>& getConstraintsContainingVariable(Variable<T>& var) const
+		const std::vector<Ref<Constraint<T>>> getConstraintsContainingVariable(Variable<T>& var) const
+		{
+			std::vector<Ref<Constraint<T>>> constraints;
+			Span<const size_t> constrsIdxs = m_csrVariableToConstraints.getRow(m_umapVariableToIdx.at(var));
+			constraints.reserve(constrsIdxs.size());
+			for (size_t constrIdx : constrsIdxs)
+			{
+				constraints.emplace_back(m_vecConstraints[constrIdx]);
+			}
+			return constraints;
+		}
+
+		/*
+		Dense index based ("compiled") representation.
+		Variables are indexed by their order in getVariables(), which is the order of their first appearance in the constraints,
+		hence deepCopy() preserves the indices. Constraints are indexed by their order in getConstraints().
+		*/
+		size_t getVariableIdx(Variable<T>& var) const { return m_umapVariableToIdx.at(var); }
+
+		Variable<T>& getVariable(size_t varIdx) const noexcept { return m_vecVariables[varIdx]; }
+
+		Constraint<T>& getConstraint(size_t constrIdx) const noexcept { return m_vecConstraints[constrIdx]; }
+
+		Span<const size_t> getNeighborsIdxs(size_t varIdx) const noexcept { return m_csrConstraintGraph.getRow(varIdx); }
+
+		Span<const size_t> getConstraintsIdxsContainingVariable(size_t varIdx) const noexcept
+		{
+			return m_csrVariableToConstraints.getRow(varIdx);
+		}
+
+		Span<const size_t> getVariablesIdxsOfConstraint(size_t constrIdx) const noexcept
 		{
-			return m_umapVariableToConstraints.at(var);
+			return m_csrConstraintToVariables.getRow(constrIdx);
+		}
+
+		std::optional<size_t> getSharedConstraintIdx(size_t firstVarIdx, size_t secondVarIdx) const noexcept
+		{
+			// both rows are sorted in ascending order since constraints are visited by index when building them
+			Span<const size_t> firstConstrsIdxs = m_csrVariableToConstraints.getRow(firstVarIdx);
+			Span<const size_t> secondConstrsIdxs = m_csrVariableToConstraints.getRow(secondVarIdx);
+			const size_t* pFirst = firstConstrsIdxs.begin();
+			const size_t* pSecond = secondConstrsIdxs.begin();
+			while (pFirst != firstConstrsIdxs.end() && pSecond != secondConstrsIdxs.end())
+			{
+				if (*pFirst == *pSecond)
+				{
+					return *pFirst;
+				}
+				else if (*pFirst < *pSecond)
+				{
+					++pFirst;
+				}
+				else
+				{
+					++pSecond;
+				}
+			}
+			return std::optional<size_t>{};
+		}
+
+		/*
+		Bitset domains (see BitsetDomain), for integral T whose variables' domains each span at most BITSET_DOMAIN_MAX_SIZE
+		values (sudoku, n-queens, magic square, ...). When set, every variable keeps its domain as a bitset domain as well, and
+		getConsistentDomain, getConsistentDomainSize and isConsistentDomainEmpty intersect, size and check for emptiness the
+		bitset domains of the values consistent with each constraint, while ac3 prunes each revised domain in one word operation.
+		Enabling throws bitset_domain_size_error, and leaves the bitset domains off, if a domain spans too many values.
+		A variable whose domain later stops fitting (e.g. by Variable<T>::setDomain) falls back to the unordered_sets computation.
+		*/
+		void setBitsetDomains(bool useBitsetDomains)
+		{
+			static_assert(__is_bitset_domain_type<T>, "Bitset domains need an integral T (other than bool).");
+			if (!useBitsetDomains)
+			{
+				m_boolBitsetDomains = false;
+				return;
+			}
+
+			for (const Variable<T>& var : m_vecVariables)
+			{
+				if (!BitsetDomain<T>::fits(var.getDomain()))
+				{
+					throw bitset_domain_size_error<T>{ var };
+				}
+			}
+			for (Variable<T>& var : m_vecVariables)
+			{
+				var.enableBitsetDomain();
+			}
+			m_boolBitsetDomains = true;
+		}
+
+		constexpr bool isUsingBitsetDomains() const noexcept { return m_boolBitsetDomains; }
+
+		// the bitset domain of var if this problem uses bitset domains and var's domain fits one, nullptr otherwise
+		const BitsetDomain<T>* getBitsetDomain(const Variable<T>& var) const noexcept
+		{
+			const std::optional<BitsetDomain<T>>& optBitsetDomain = var.getBitsetDomain();
+			return m_boolBitsetDomains && optBitsetDomain ? &(*optBitsetDomain) : nullptr;
 		}
 
 		const std::vector<T> getConsistentDomain(Variable<T>& var) noexcept
 		{
+			if constexpr (__is_bitset_domain_type<T>)
+			{
+				if (const BitsetDomain<T>* pBitsetDomain = this->getBitsetDomain(var))
+				{
+					return this->get_consistent_bitset_domain(var, *pBitsetDomain).getValues();
+				}
+			}
+
 			std::unordered_set<T> allValues;
 			std::unordered_multiset<std::unordered_set<T>> allConsistentDomains;
 			this->init_allValues_and_allConsistentDomains(var, allValues, allConsistentDomains);
@@ -352,6 +512,145 @@ namespace csp
 			return vecConsistentDomain;
 		}
 
+		size_t getConsistentDomainSize(Variable<T>& var) noexcept
+		{
+			if constexpr (__is_bitset_domain_type<T>)
+			{
+				if (const BitsetDomain<T>* pBitsetDomain = this->getBitsetDomain(var))
+				{
+					return this->get_consistent_bitset_domain(var, *pBitsetDomain).size();
+				}
+			}
+			return this->getConsistentDomain(var).size();
+		}
+
+		bool isConsistentDomainEmpty(Variable<T>& var) noexcept
+		{
+			if constexpr (__is_bitset_domain_type<T>)
+			{
+				if (const BitsetDomain<T>* pBitsetDomain = this->getBitsetDomain(var))
+				{
+					return this->get_consistent_bitset_domain(var, *pBitsetDomain).empty();
+				}
+			}
+			return this->getConsistentDomain(var).empty();
+		}
+
+		/*
+		Trail (undo stack) of domain removals.
+		Inferences and preprocessing algorithms remove values through the problem rather than through the variable,
+		so every removal is recorded. A solver takes a mark before an inference and restores the mark on backtrack,
+		which undoes exactly the removals made since the mark, in O(removals), instead of copying whole domains.
+		*/
+		constexpr size_t getTrailMark() const noexcept { return m_vecTrail.size(); }
+
+		// the variable of the trailPosition-th recorded removal, e.g. for inspecting the removals made since a mark
+		Variable<T>& getTrailedVariable(size_t trailPosition) const noexcept { return std::get<0>(m_vecTrail[trailPosition]); }
+
+		void removeFromDomainByIdx(Variable<T>& var, size_t idx)
+		{
+			T removedValue = var.getDomain()[idx];
+			var.removeFromDomainByIdx(idx);
+			m_vecTrail.emplace_back(var, idx, removedValue);
+		}
+
+		void removeFromDomainByValue(Variable<T>& var, T val)
+		{
+			const std::vector<T>& domain = var.getDomain();
+			this->removeFromDomainByIdx(var, std::distance(domain.cbegin(), std::find(domain.cbegin(), domain.cend(), val)));
+		}
+
+		/*
+		Removes all the values of removedValues from var's domain at once (see Variable<T>::removeFromDomain).
+		The removals are trailed from the last index to the first, which is equivalent to removing them one by one.
+		*/
+		void removeFromDomain(Variable<T>& var, const BitsetDomain<T>& removedValues)
+		{
+			if (var.isAssigned())
+			{
+				throw domain_alteration_error<T>{ var };
+			}
+
+			const std::vector<T>& domain = var.getDomain();
+			for (size_t i = domain.size(); 0 < i; --i)
+			{
+				if (removedValues.contains(domain[i - 1]))
+				{
+					m_vecTrail.emplace_back(var, i - 1, domain[i - 1]);
+				}
+			}
+			var.removeFromDomain(removedValues);
+		}
+
+		// same semantics as Variable<T>::setSubsetDomain, except that the order of vecSubsetDomain does not matter
+		bool setSubsetDomain(Variable<T>& var, const std::vector<T>& vecSubsetDomain)
+		{
+			if (var.isAssigned())
+			{
+				throw domain_alteration_error<T>{ var };
+			}
+
+			const std::vector<T>& domain = var.getDomain();
+			if (domain.size() <= vecSubsetDomain.size())
+			{
+				return false;
+			}
+
+			std::unordered_set<T> usetDomain{ domain.cbegin(), domain.cend() };
+			for (T value : vecSubsetDomain)
+			{
+				if (!usetDomain.count(value))
+				{
+					return false;
+				}
+			}
+
+			std::unordered_set<T> usetSubsetDomain{ vecSubsetDomain.cbegin(), vecSubsetDomain.cend() };
+			for (size_t i = domain.size(); 0 < i; --i)
+			{
+				if (!usetSubsetDomain.count(domain[i - 1]))
+				{
+					this->removeFromDomainByIdx(var, i - 1);
+				}
+			}
+			return true;
+		}
+
+		void restoreTrail(size_t trailMark)
+		{
+			while (trailMark < m_vecTrail.size())
+			{
+				auto& [var, removedValueIdx, removedValue] = m_vecTrail.back();
+				var.get().insertToDomainByIdx(removedValueIdx, removedValue);
+				m_vecTrail.pop_back();
+			}
+		}
+
+		// makes all recorded removals permanent
+		void clearTrail() noexcept { m_vecTrail.clear(); }
+
+		/*
+		Called by preprocessing algorithms (ac3, ac4, pc2, ...) with the mark they took on entry, so that pruning outside a search
+		is permanent rather than piling up on the trail. Older entries index into domains as they were before the removals made
+		since trailMark, hence those removals can only be dropped when there are no older entries; within a search they stay
+		trailed and are undone together with the enclosing mark.
+		*/
+		void commitTrail(size_t trailMark) noexcept
+		{
+			if (!trailMark)
+			{
+				m_vecTrail.clear();
+			}
+		}
+
+		/*
+		Cooperative cancellation: once the flag pointed to is set, the solvers stop searching and return what they have so far.
+		The flag is not owned, and is not passed on by deepCopy().
+		*/
+		void setStopFlag(const std::atomic<bool>* pStopFlag) noexcept { m_pStopFlag = pStopFlag; }
+
+		bool isStopRequested() const noexcept { return m_pStopFlag && m_pStopFlag->load(std::memory_order_relaxed); }
+
 		const Assignment<T> getCurrentAssignment() const noexcept
 		{
 			std::unordered_map<Ref<Variable<T>>, size_t> currAssignment;
@@ -383,9 +682,10 @@ namespace csp
 			}
 		}
 
+		// the unassignments and assignments made are appended to *pAssignmentHistory, if given
 		void assignVarsWithRandomValues(std::optional<std::unordered_set<Ref<Variable<T>>>> optReadOnlyVars =
 			std::optional<std::unordered_set<Ref<Variable<T>>>>{},
-			std::optional<AssignmentHistory<T>> optAssignmentHistory = std::optional<AssignmentHistory<T>>{}) noexcept
+			AssignmentHistory<T>* pAssignmentHistory = nullptr) noexcept
 		{
 			for (Variable<T>& var : m_vecVariables)
 			{
@@ -397,27 +697,25 @@ namespace csp
 				else if (varIsAssigned)
 				{
 					var.unassign();
-					if (optAssignmentHistory)
+					if (pAssignmentHistory)
 					{
-						(*optAssignmentHistory).emplace_back(var, std::optional<T>{});
+						pAssignmentHistory->emplace_back(var, std::optional<T>{});
 					}
 				}
 
 				var.assignWithRandomlySelectedValue();
-				if (optAssignmentHistory)
+				if (pAssignmentHistory)
 				{
-					(*optAssignmentHistory).emplace_back(var, std::optional<T>{ var.getValue() });
+					pAssignmentHistory->emplace_back(var, std::optional<T>{ var.getValue() });
 				}
 			}
 		}
 
-		const AdjacencyListConstraintGraph& getConstraintGraph() const noexcept { return m_umapConstraintGraph; }
-
 		bool isPotentiallySolvable() noexcept
 		{
 			for (Variable<T>& var : m_vecVariables)
 			{
-				if (var.getDomain().empty() || this->getConsistentDomain(var).empty())
+				if (var.getDomain().empty() || this->isConsistentDomainEmpty(var))
 				{
 					return false;
 				}
@@ -507,75 +805,180 @@ namespace csp
 				return myConstraints;
 			}
 
-			static const VarToConstraintsMap init_variableToConstraints(const std::vector<Ref<Constraint<T>>>& constraints) noexcept
+			static const std::vector<Ref<Variable<T>>> init_variables(const std::vector<Ref<Constraint<T>>>& constraints) noexcept
 			{
-				VarToConstraintsMap variableToConstraints;
+				std::vector<Ref<Variable<T>>> variables;
+				std::unordered_set<Variable<T>*> seenVarsAddresses;
 				for (Constraint<T>& constr : constraints)
 				{
-					const std::vector<Ref<Variable<T>>>& constraintVars = constr.getVariables();
-					for (Variable<T>& var : constraintVars)
+					for (Variable<T>& var : constr.getVariables())
 					{
-						const auto [it, emplaced] = variableToConstraints.try_emplace(var, std::vector<Ref<Constraint<T>>>{ constr });
-						const auto constrsEnd = it->second.cend();
-						if (!emplaced && std::find(it->second.cbegin(), constrsEnd, constr) == constrsEnd)
+						if (seenVarsAddresses.emplace(&var).second)
 						{
-							it->second.emplace_back(constr);
+							variables.emplace_back(var);
 						}
 					}
 				}
-				return variableToConstraints;
+				return variables;
+			}
+
+			static std::shared_ptr<UnassignedVariablesSet> init_unassignedVariablesSet(const std::vector<Ref<Variable<T>>>& variables)
+			{
+				std::shared_ptr<UnassignedVariablesSet> pUnassignedVariablesSet = std::make_shared<UnassignedVariablesSet>(variables.size());
+				pUnassignedVariablesSet->acquire();
+				for (size_t i = 0; i < variables.size(); ++i)
+				{
+					variables[i].get().registerToUnassignedVariablesSet(pUnassignedVariablesSet, i);
+				}
+				return pUnassignedVariablesSet;
 			}
 
-			static const std::vector<Ref<Variable<T>>> init_variables(const VarToConstraintsMap& variableToConstraints) noexcept
+			const std::vector<Ref<Variable<T>>> get_variables_in_idxs_order(Span<const size_t> varsIdxs, bool areAssigned) const noexcept
 			{
 				std::vector<Ref<Variable<T>>> variables;
-				for (const std::pair<Ref<Variable<T>>, std::vector<Ref<Constraint<T>>>>& varToConstraints : variableToConstraints)
+				variables.reserve(varsIdxs.size());
+				// sorting few indices is cheaper than scanning all the variables
+				if (varsIdxs.size() < (m_vecVariables.size() >> 3))
 				{
-					variables.emplace_back(varToConstraints.first);
+					std::vector<size_t> sortedVarsIdxs{ varsIdxs.begin(), varsIdxs.end() };
+					std::sort(sortedVarsIdxs.begin(), sortedVarsIdxs.end());
+					for (size_t varIdx : sortedVarsIdxs)
+					{
+						variables.emplace_back(m_vecVariables[varIdx]);
+					}
+					return variables;
+				}
+
+				for (Variable<T>& var : m_vecVariables)
+				{
+					if (var.isAssigned() == areAssigned)
+					{
+						variables.emplace_back(var);
+					}
 				}
 				return variables;
 			}
 
-			static const AdjacencyListConstraintGraph init_constraintGraph(const VarToConstraintsMap& variableToConstraints) noexcept
+			static const VariableToIdxMap init_variableToIdx(const std::vector<Ref<Variable<T>>>& variables) noexcept
+			{
+				VariableToIdxMap variableToIdx;
+				variableToIdx.reserve(variables.size());
+				for (size_t i = 0; i < variables.size(); ++i)
+				{
+					variableToIdx.emplace(variables[i], i);
+				}
+				return variableToIdx;
+			}
+
+			static const CompressedSparseRows init_constraintToVariables(const std::vector<Ref<Constraint<T>>>& constraints,
+				const VariableToIdxMap& variableToIdx)
+			{
+				std::vector<std::vector<size_t>> constraintToVariables;
+				constraintToVariables.reserve(constraints.size());
+				for (Constraint<T>& constr : constraints)
+				{
+					const std::vector<Ref<Variable<T>>>& constraintVars = constr.getVariables();
+					std::vector<size_t> varsIdxs;
+					varsIdxs.reserve(constraintVars.size());
+					for (Variable<T>& var : constraintVars)
+					{
+						varsIdxs.push_back(variableToIdx.at(var));
+					}
+					constraintToVariables.emplace_back(std::move(varsIdxs));
+				}
+				return CompressedSparseRows{ constraintToVariables };
+			}
+
+			static const CompressedSparseRows init_variableToConstraintsIdxs(const CompressedSparseRows& constraintToVariables,
+				size_t variablesSize)
+			{
+				std::vector<std::vector<size_t>> variableToConstraints(variablesSize);
+				for (size_t constrIdx = 0; constrIdx < constraintToVariables.getRowsSize(); ++constrIdx)
+				{
+					for (size_t varIdx : constraintToVariables.getRow(constrIdx))
+					{
+						variableToConstraints[varIdx].push_back(constrIdx);
+					}
+				}
+				return CompressedSparseRows{ variableToConstraints };
+			}
+
+			static const CompressedSparseRows init_constraintGraphIdxs(const CompressedSparseRows& constraintToVariables,
+				const CompressedSparseRows& variableToConstraints)
 			{
-				AdjacencyListConstraintGraph constraintGraph;
-				for (const std::pair<Ref<Variable<T>>, std::vector<Ref<Constraint<T>>>>& varToConstraints : variableToConstraints)
+				size_t variablesSize = variableToConstraints.getRowsSize();
+				std::vector<std::vector<size_t>> constraintGraph(variablesSize);
+				std::vector<size_t> lastSeenBy(variablesSize, UNASSIGNED);
+				for (size_t varIdx = 0; varIdx < variablesSize; ++varIdx)
 				{
-					std::unordered_set<Ref<Variable<T>>> neighbors{ varToConstraints.first };
-					for (Constraint<T>& constraint : varToConstraints.second)
+					lastSeenBy[varIdx] = varIdx;
+					for (size_t constrIdx : variableToConstraints.getRow(varIdx))
 					{
-						const std::vector<Ref<Variable<T>>>& constraintVars = constraint.getVariables();
-						for (Variable<T>& neighborVar : constraintVars)
+						for (size_t neighborIdx : constraintToVariables.getRow(constrIdx))
 						{
-							neighbors.emplace(neighborVar);
+							if (lastSeenBy[neighborIdx] != varIdx)
+							{
+								lastSeenBy[neighborIdx] = varIdx;
+								constraintGraph[varIdx].push_back(neighborIdx);
+							}
 						}
 					}
-					neighbors.erase(varToConstraints.first);
+				}
+				return CompressedSparseRows{ constraintGraph };
+			}
 
-					if (constraintGraph.find(varToConstraints.first) == constraintGraph.end())
+			/*
+			The values of var's bitset domain consistent with each of var's constraints, as the intersection of the values
+			consistent with each constraint. Stops at the first constraint that leaves no value.
+			*/
+			BitsetDomain<T> get_consistent_bitset_domain(Variable<T>& var, const BitsetDomain<T>& bitsetDomain) noexcept
+			{
+				const size_t assignmentIdx = var.getAssignmentIdx();
+				if (assignmentIdx != UNASSIGNED)
+				{
+					var.unassign();
+				}
+
+				BitsetDomain<T> consistentDomain{ bitsetDomain };
+				const std::vector<T>& domain = var.getDomain();
+				for (size_t constrIdx : m_csrVariableToConstraints.getRow(m_umapVariableToIdx.at(var)))
+				{
+					const Constraint<T>& constraint = m_vecConstraints[constrIdx];
+					BitsetDomain<T> constraintConsistentDomain{ bitsetDomain.getBase() };
+					for (size_t i = 0; i < domain.size(); ++i)
 					{
-						constraintGraph.emplace(varToConstraints.first, std::vector<Ref<Variable<T>>>{ neighbors.cbegin(), neighbors.cend() });
+						if (!consistentDomain.contains(domain[i]))
+						{
+							continue;
+						}
+						var.assignByIdx(i);
+						if (constraint.isConsistent())
+						{
+							constraintConsistentDomain.insert(domain[i]);
+						}
+						var.unassign();
 					}
-					else
+
+					consistentDomain &= constraintConsistentDomain;
+					if (consistentDomain.empty())
 					{
-						std::vector<Ref<Variable<T>>>& currNeighbors = constraintGraph.at(varToConstraints.first);
-						const auto currNeighborsItToStart = currNeighbors.cbegin();
-						const auto currNeighborsItToEnd = currNeighbors.cend();
-						std::copy_if(neighbors.cbegin(), neighbors.cend(), std::back_inserter(currNeighbors),
-							[&currNeighborsItToStart, &currNeighborsItToEnd](const Variable<T>& var) -> bool
-							{ return std::find(currNeighborsItToStart, currNeighborsItToEnd, var) != currNeighborsItToEnd; });
+						break;
 					}
 				}
 
-				return constraintGraph;
+				if (assignmentIdx != UNASSIGNED)
+				{
+					var.assignByIdx(assignmentIdx);
+				}
+				return consistentDomain;
 			}
 
 			void init_allValues_and_allConsistentDomains(Variable<T>& var, std::unordered_set<T>& allValues,
 				std::unordered_multiset<std::unordered_set<T>>& allConsistentDomains) const noexcept
 			{
-				const std::vector<Ref<Constraint<T>>>& constraintsContainingVar = m_umapVariableToConstraints.at(var);
-				for (Constraint<T>& constraint : constraintsContainingVar)
+				for (size_t constrIdx : m_csrVariableToConstraints.getRow(m_umapVariableToIdx.at(var)))
 				{
+					const Constraint<T>& constraint = m_vecConstraints[constrIdx];
 					const std::vector<T> currConsistentDomain = constraint.getConsistentDomainValues(var);
 					allValues.insert(currConsistentDomain.cbegin(), currConsistentDomain.cend());
 					allConsistentDomains.emplace(currConsistentDomain.cbegin(), currConsistentDomain.cend());
@@ -583,10 +986,16 @@ namespace csp
 			}
 
 			std::vector<Ref<Constraint<T>>> m_vecConstraints;
-			VarToConstraintsMap m_umapVariableToConstraints;
 			std::vector<Ref<Variable<T>>> m_vecVariables;
-			AdjacencyListConstraintGraph m_umapConstraintGraph;
 			NameToVariableRefMap m_umapNameToVariableRef;
+			VariableToIdxMap m_umapVariableToIdx;
+			CompressedSparseRows m_csrConstraintToVariables;
+			CompressedSparseRows m_csrVariableToConstraints;
+			CompressedSparseRows m_csrConstraintGraph;
+			DomainTrail m_vecTrail;
+			bool m_boolBitsetDomains;
+			const std::atomic<bool>* m_pStopFlag;
+			std::shared_ptr<UnassignedVariablesSet> m_pUnassignedVariablesSet;
 	};
 
 
@@ -598,6 +1007,84 @@ namespace csp
 			std::domain_error{ constr.toString() + " is duplicate in input constraints vector." }
 		{ }
 	};
+
+}
+
+
+/*
+Helpers of the parallel solvers (portfolioSolver, parallelHeuristicBacktrackingSolver_findAllSolutions, parallelTempering and
+parallelRandomRestartFirstChoiceHillClimbing), which run their workers on deep copies of the constraint problem.
+*/
+
+namespace csp
+{
+	// hardware_concurrency() returns 0 when it is not computable, hence at least one worker, and no more workers than tasks
+	inline size_t __getWorkersAmount(unsigned int threadsAmount, size_t tasksAmount) noexcept
+	{
+		return std::clamp<size_t>(threadsAmount, 1, std::max<size_t>(tasksAmount, 1));
+	}
+
+	/*
+	The copies are made before the workers start, since deepCopy() reads the variables which the workers then assign.
+	The copied problems refer to copiedVars and copiedConstraints, which must outlive them.
+	*/
+	template <typename T>
+	std::vector<ConstraintProblem<T>> __deepCopyProblems(const ConstraintProblem<T>& constraintProblem, size_t copiesAmount,
+		std::vector<std::vector<Variable<T>>>& copiedVars, std::vector<std::vector<Constraint<T>>>& copiedConstraints)
+	{
+		copiedVars.resize(copiesAmount);
+		copiedConstraints.resize(copiesAmount);
+		std::vector<ConstraintProblem<T>> copiedProblems;
+		copiedProblems.reserve(copiesAmount);
+		for (size_t copyIdx = 0; copyIdx < copiesAmount; ++copyIdx)
+		{
+			copiedProblems.emplace_back(constraintProblem.deepCopy(copiedVars[copyIdx], copiedConstraints[copyIdx]));
+		}
+		return copiedProblems;
+	}
+
+	/*
+	Runs runWorker(workerIdx) for every worker index below workersAmount, worker 0 on the calling thread, and returns once all
+	of them returned. runWorker must not throw, the workers store their exceptions for __rethrowFirstWorkerException instead.
+	*/
+	template <typename WorkerRunner>
+	void __runWorkers(size_t workersAmount, const WorkerRunner& runWorker)
+	{
+		std::vector<std::thread> workers;
+		workers.reserve(workersAmount - 1);
+		auto joinWorkers = [&workers]() -> void
+		{
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+		};
+		try
+		{
+			for (size_t workerIdx = 1; workerIdx < workersAmount; ++workerIdx)
+			{
+				workers.emplace_back(runWorker, workerIdx);
+			}
+		}
+		catch (...)
+		{
+			joinWorkers();
+			throw;
+		}
+		runWorker(0);
+		joinWorkers();
+	}
+
+	inline void __rethrowFirstWorkerException(const std::vector<std::exception_ptr>& workersExceptions)
+	{
+		for (const std::exception_ptr& workerException : workersExceptions)
+		{
+			if (workerException)
+			{
+				std::rethrow_exception(workerException);
+			}
+		}
+	}
 }
 
 
@@ -629,16 +1116,18 @@ namespace std
 		{
 			hash<T> valueHasher;
 			hash<std::reference_wrapper<csp::Variable<T>>> variableRefHasher;
-			double hashKey = 0;
+			size_t hashValue = 0;
 
+			// the pairs hashes are mixed, then summed, since the iteration order of equal assignments may differ
 			for (const std::pair<std::reference_wrapper<csp::Variable<T>>, size_t>& varRefToAssignmentIdx : assignment)
 			{
-				double variableHashValue = static_cast<double>(variableRefHasher(varRefToAssignmentIdx.first));
 				const std::vector<T>& domain = varRefToAssignmentIdx.first.get().getDomain();
-				double currHashValue = variableHashValue / valueHasher(domain[varRefToAssignmentIdx.second]);
-				hashKey += currHashValue;
+				size_t pairHashValue = variableRefHasher(varRefToAssignmentIdx.first);
+				pairHashValue ^= valueHasher(domain[varRefToAssignmentIdx.second]) + 0x9e3779b9 + (pairHashValue << 6) + (pairHashValue >> 2);
+				pairHashValue *= 0x45d9f3b;
+				hashValue += pairHashValue ^ (pairHashValue >> 16);
 			}
-			return static_cast<size_t>(hashKey);
+			return hashValue;
 		}
 	};
 }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+
+/*
+Fixed point propagation of global constraints, shared by the global constraints inferences (all_different.h, linear_sum.h).
+Starting from the constraints containing the assigned variable, each queued constraint is filtered:
+filterConstraint(constraintProblem, constrIdx, prunedVarsIdxs) prunes (through the domain removals trail) the domains of
+the constraint's variables, writes the indices of the pruned variables and returns false iff it found the constraint unsatisfiable.
+The constraints of pruned variables which isPropagatedConstraint accepts are then queued, until no domain changes.
+A filter is expected to reach a fixed point of its own constraint, hence a constraint is not re-queued by its own prunings.
+*/
+
+namespace csp
+{
+	template <typename T, typename IsPropagatedConstraint, typename ConstraintFilter>
+	static bool __propagateToFixedPoint(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable,
+		const IsPropagatedConstraint& isPropagatedConstraint, const ConstraintFilter& filterConstraint)
+	{
+		std::vector<bool> isQueuedConstraint(constraintProblem.getConstraints().size(), false);
+		std::queue<size_t> constraintsQueue;
+		auto enqueuePropagatedConstraints = [&constraintProblem, &isPropagatedConstraint, &isQueuedConstraint, &constraintsQueue](size_t varIdx)
+		{
+			for (size_t constrIdx : constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
+			{
+				if (!isQueuedConstraint[constrIdx] && isPropagatedConstraint(constraintProblem.getConstraint(constrIdx)))
+				{
+					isQueuedConstraint[constrIdx] = true;
+					constraintsQueue.push(constrIdx);
+				}
+			}
+		};
+
+		enqueuePropagatedConstraints(constraintProblem.getVariableIdx(assignedVariable));
+		std::vector<size_t> prunedVarsIdxs;
+		while (!constraintsQueue.empty())
+		{
+			size_t constrIdx = constraintsQueue.front();
+			constraintsQueue.pop();
+			prunedVarsIdxs.clear();
+			if (!filterConstraint(constraintProblem, constrIdx, prunedVarsIdxs))
+			{
+				return false;
+			}
+			for (size_t prunedVarIdx : prunedVarsIdxs)
+			{
+				enqueuePropagatedConstraints(prunedVarIdx);
+			}
+			isQueuedConstraint[constrIdx] = false;
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -2,132 +2,277 @@
 
 #include "pch.h"
 #include "constraint_problem.h"
+#include "conflicts_tracker.h"
 
+/*
+Constraints weighting by the breakout method. Every constraint has a weight, starting at 1. From a random complete assignment,
+the reassignment which most reduces the weights sum of the unsatisfied constraints is made, until no reassignment reduces it,
+i.e. a local minimum. There, the weights of the unsatisfied constraints are increased by 1 (a breakout), which turns the minimum
+into a slope, and the descent goes on. maxBreakouts bounds the number of breakouts, and there are no restarts: the search
+gives up at the local minimum after the maxBreakouts-th breakout. (The former restarting version bounded the number of restarts
+by its maxTries argument instead.)
+WeightedPenaltiesTracker<T> keeps, for every (variable, value), the weights sum of the constraints containing the variable which
+would be unsatisfied were the variable assigned the value, along with a violation flag per (constraint, variable, value),
+in dense arrays. Reassigning x re-evaluates only the constraints containing x, for each value of their other variables,
+and a breakout only adds weights. Hence a step costs O(degree * arity * domain size) constraint evaluations, and the best
+reassignment is found by scanning the penalties of the conflicted variables, with no constraint evaluation.
+Variables must not be reassigned behind the tracker's back.
+*/
 
 namespace csp
 {
 	template <typename T>
-	using VariableAssignmentIdxPair = std::pair<Ref<csp::Variable<T>>, size_t>;
-}
-
-namespace csp
-{
-	template <typename T>
-	static int __CalculateWeight(ConstraintProblem<T>& constraintProblem,
-		std::map<Ref<Constraint<T>>, int>& constraintToWeightMap)
+	class WeightedPenaltiesTracker final
 	{
-		int weight = 0;
-		for (Variable<T>& var : constraintProblem.getVariables())
+	public:
+		WeightedPenaltiesTracker<T>() = delete;
+
+		WeightedPenaltiesTracker<T>(ConstraintProblem<T>& constraintProblem,
+			const std::optional<std::unordered_set<Ref<Variable<T>>>>& optReadOnlyVars = std::optional<std::unordered_set<Ref<Variable<T>>>>{}) :
+			m_constraintProblem{ constraintProblem },
+			m_conflictsTracker{ constraintProblem, optReadOnlyVars },
+			m_vecConstraintsWeights(constraintProblem.getConstraints().size(), 1),
+			m_vecValuesOffsets{ init_values_offsets(constraintProblem) },
+			m_vecPenalties(m_vecValuesOffsets.back(), 0),
+			m_vecConstraintsArcsOffsets{ },
+			m_vecArcsViolationsOffsets{ },
+			m_vecIsViolated{ },
+			m_defaultRandomEngine{ std::random_device{}() }
+		{
+			this->init_arcs();
+			this->recount();
+		}
+
+		WeightedPenaltiesTracker<T>(const WeightedPenaltiesTracker<T>& otherTracker) = delete;
+		WeightedPenaltiesTracker<T>& operator=(const WeightedPenaltiesTracker<T>& otherTracker) = delete;
+		~WeightedPenaltiesTracker<T>() = default;
+
+		// re-evaluates every constraint for every value of its variables, e.g. after variables were reassigned not through the tracker
+		void recount()
 		{
-			const std::vector<Ref<Constraint<T>>>& constraintsContainingVar =
-				constraintProblem.getConstraintsContainingVariable(var);
-			std::vector<Ref<Constraint<T>>> unsatisfiedConstraintsContainingVar;
-			unsatisfiedConstraintsContainingVar.reserve(constraintsContainingVar.size());
-			for (Constraint<T>& constr : constraintsContainingVar)
+			m_conflictsTracker.recount();
+			std::fill(m_vecPenalties.begin(), m_vecPenalties.end(), 0);
+			std::fill(m_vecIsViolated.begin(), m_vecIsViolated.end(), false);
+			for (size_t constrIdx = 0; constrIdx < m_vecConstraintsWeights.size(); ++constrIdx)
 			{
-				if (!constr.isSatisfied())
+				const size_t constrVarsSize = m_constraintProblem.getVariablesIdxsOfConstraint(constrIdx).size();
+				for (size_t varPosition = 0; varPosition < constrVarsSize; ++varPosition)
 				{
-					unsatisfiedConstraintsContainingVar.emplace_back(constr);
+					this->evaluate_arc(constrIdx, varPosition);
 				}
 			}
+		}
+
+		const ConflictsTracker<T>& getConflictsTracker() const noexcept { return m_conflictsTracker; }
+
+		size_t getConstraintWeight(size_t constrIdx) const noexcept { return m_vecConstraintsWeights[constrIdx]; }
 
-			for (Constraint<T>& constr : unsatisfiedConstraintsContainingVar)
+		size_t getPenalty(size_t varIdx, size_t assignmentIdx) const noexcept
+		{
+			return m_vecPenalties[m_vecValuesOffsets[varIdx] + assignmentIdx];
+		}
+
+		/*
+		The reassignment (variable idx, assignment idx) of a conflicted variable which most reduces the weights sum of the
+		unsatisfied constraints, chosen uniformly at random among the best ones. Empty if none reduces it (a local minimum).
+		*/
+		std::optional<std::pair<size_t, size_t>> selectBestReassignment()
+		{
+			std::optional<std::pair<size_t, size_t>> optBestReassignment;
+			size_t bestReduction = 0;
+			size_t bestReassignmentsSize = 0;
+			for (size_t varIdx : m_conflictsTracker.getConflictedVariablesIdxs())
 			{
-				weight += constraintToWeightMap[constr];
+				const size_t currPenalty = this->getPenalty(varIdx, m_constraintProblem.getVariable(varIdx).getAssignmentIdx());
+				const size_t domainSize = m_constraintProblem.getVariable(varIdx).getDomain().size();
+				for (size_t i = 0; i < domainSize; ++i)
+				{
+					const size_t penalty = this->getPenalty(varIdx, i);
+					if (currPenalty <= penalty || currPenalty - penalty < bestReduction)
+					{
+						continue;
+					}
+					if (bestReduction < currPenalty - penalty)
+					{
+						bestReduction = currPenalty - penalty;
+						bestReassignmentsSize = 0;
+					}
+					// reservoir sampling of a uniformly random best reassignment
+					std::uniform_int_distribution<size_t> distribution(0, bestReassignmentsSize++);
+					if (!distribution(m_defaultRandomEngine))
+					{
+						optBestReassignment = std::pair<size_t, size_t>{ varIdx, i };
+					}
+				}
 			}
+			return optBestReassignment;
 		}
-		return weight;
-	}
 
-	template <typename T>
-	static std::tuple<int, Ref<Variable<T>>, size_t> __geBestReductionVariableAssignmentIdx(ConstraintProblem<T>& constraintProblem,
-		const std::unordered_set<Ref<Variable<T>>>& readOnlyVars,
-		std::map<Ref<Constraint<T>>, int>& constraintToWeightMap)
-	{
-		int weight = __CalculateWeight<T>(constraintProblem, constraintToWeightMap);
-		const Assignment<T> originalAssignment = constraintProblem.getCurrentAssignment();
-		constraintProblem.unassignAllVariables();
-		std::map<int, VariableAssignmentIdxPair<T>> weightToPairMap;
-		for (Variable<T>& var : constraintProblem.getVariables())
+		void reassign(size_t varIdx, size_t assignmentIdx)
 		{
-			if (readOnlyVars.count(var))
+			m_conflictsTracker.reassign(varIdx, assignmentIdx);
+			for (size_t constrIdx : m_constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
 			{
-				continue;
+				// the violations of varIdx's own values depend only on the other variables, which were not reassigned
+				Span<const size_t> constrVarsIdxs = m_constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+				for (size_t varPosition = 0; varPosition < constrVarsIdxs.size(); ++varPosition)
+				{
+					if (constrVarsIdxs[varPosition] != varIdx)
+					{
+						this->evaluate_arc(constrIdx, varPosition);
+					}
+				}
 			}
-			const std::vector<T>& domain = var.getDomain();
-			for (size_t i = 0; i < domain.size(); ++i)
+		}
+
+		// increases the weights of the unsatisfied constraints by 1
+		void breakout()
+		{
+			for (size_t constrIdx = 0; constrIdx < m_vecConstraintsWeights.size(); ++constrIdx)
 			{
-				var.assignByIdx(i);
-				int currWeight = __CalculateWeight<T>(constraintProblem, constraintToWeightMap);
-				weightToPairMap.emplace(weight - currWeight, VariableAssignmentIdxPair<T>{var, i});
-				var.unassign();
+				if (m_conflictsTracker.isSatisfiedConstraint(constrIdx))
+				{
+					continue;
+				}
+				++m_vecConstraintsWeights[constrIdx];
+				Span<const size_t> constrVarsIdxs = m_constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+				for (size_t varPosition = 0; varPosition < constrVarsIdxs.size(); ++varPosition)
+				{
+					const size_t violationsOffset = m_vecArcsViolationsOffsets[m_vecConstraintsArcsOffsets[constrIdx] + varPosition];
+					const size_t valuesOffset = m_vecValuesOffsets[constrVarsIdxs[varPosition]];
+					const size_t domainSize = m_vecValuesOffsets[constrVarsIdxs[varPosition] + 1] - valuesOffset;
+					for (size_t i = 0; i < domainSize; ++i)
+					{
+						if (m_vecIsViolated[violationsOffset + i])
+						{
+							++m_vecPenalties[valuesOffset + i];
+						}
+					}
+				}
 			}
 		}
 
-		constraintProblem.unassignAllVariables();
-		constraintProblem.assignFromAssignment(originalAssignment);
-		const auto& maxReduction = weightToPairMap.rbegin();
-		int weightReduction = maxReduction->first;
-		Variable<T>& var = maxReduction->second.first;
-		size_t assignmentIdx = maxReduction->second.second;
-		return { weightReduction, var, assignmentIdx };
-	}
-
-	template <typename T>
-	const AssignmentHistory<T> constraintWeighting(ConstraintProblem<T>& constraintProblem, unsigned int maxTries,
-		bool writeAssignmentHistory = false)
-	{
-		AssignmentHistory<T> assignmentHistory;
-		std::optional<AssignmentHistory<T>> optAssignmentHistory = std::optional<AssignmentHistory<T>>{ assignmentHistory };
-		const std::vector<Ref<Variable<T>>> vecReadOnlyVars = constraintProblem.getAssignedVariables();
-		std::unordered_set<Ref<Variable<T>>> readOnlyVars{ vecReadOnlyVars.cbegin(), vecReadOnlyVars.cend() };
-		std::optional<std::unordered_set<Ref<Variable<T>>>> optReadOnlyVars{ readOnlyVars };
-		const std::vector<Ref<Constraint<T>>>& constraints = constraintProblem.getConstraints();
-		std::map<Ref<Constraint<T>>, int> constraintToWeightMap;
-		for (Constraint<T>& constr : constraints)
+	private:
+		static std::vector<size_t> init_values_offsets(const ConstraintProblem<T>& constraintProblem)
 		{
-			constraintToWeightMap.emplace(constr, 1);
+			const std::vector<Ref<Variable<T>>>& variables = constraintProblem.getVariables();
+			std::vector<size_t> valuesOffsets(variables.size() + 1, 0);
+			for (size_t varIdx = 0; varIdx < variables.size(); ++varIdx)
+			{
+				valuesOffsets[varIdx + 1] = valuesOffsets[varIdx] + variables[varIdx].get().getDomain().size();
+			}
+			return valuesOffsets;
 		}
 
-		for (unsigned int i = 0; i < maxTries; ++i)
+		// an arc is a (constraint, variable position in it), and owns a violation flag per value of the variable
+		void init_arcs()
 		{
-			constraintProblem.assignVarsWithRandomValues(optReadOnlyVars, optAssignmentHistory);
-			int lastReduction = std::numeric_limits<int>::max();
-			while (0 < lastReduction)
+			const size_t constraintsSize = m_vecConstraintsWeights.size();
+			m_vecConstraintsArcsOffsets.assign(constraintsSize + 1, 0);
+			m_vecArcsViolationsOffsets.assign(1, 0);
+			for (size_t constrIdx = 0; constrIdx < constraintsSize; ++constrIdx)
 			{
-				if (constraintProblem.isCompletelyConsistentlyAssigned())
+				Span<const size_t> constrVarsIdxs = m_constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+				m_vecConstraintsArcsOffsets[constrIdx + 1] = m_vecConstraintsArcsOffsets[constrIdx] + constrVarsIdxs.size();
+				for (size_t varIdx : constrVarsIdxs)
 				{
-					return assignmentHistory;
+					m_vecArcsViolationsOffsets.push_back(m_vecArcsViolationsOffsets.back() +
+						m_vecValuesOffsets[varIdx + 1] - m_vecValuesOffsets[varIdx]);
 				}
+			}
+			m_vecIsViolated.assign(m_vecArcsViolationsOffsets.back(), false);
+		}
 
-				auto [reduction, varRef, assignmentIdx] = __geBestReductionVariableAssignmentIdx<T>(constraintProblem, readOnlyVars, constraintToWeightMap);
-				Variable<T>& var = varRef.get();
-				var.unassign();
-				if (writeAssignmentHistory)
+		// re-evaluates the constraint for every value of the variable in varPosition, and updates the variable's penalties
+		void evaluate_arc(size_t constrIdx, size_t varPosition)
+		{
+			const Constraint<T>& constraint = m_constraintProblem.getConstraint(constrIdx);
+			const size_t varIdx = m_constraintProblem.getVariablesIdxsOfConstraint(constrIdx)[varPosition];
+			Variable<T>& var = m_constraintProblem.getVariable(varIdx);
+			const size_t assignmentIdx = var.getAssignmentIdx();
+			const size_t violationsOffset = m_vecArcsViolationsOffsets[m_vecConstraintsArcsOffsets[constrIdx] + varPosition];
+			const size_t valuesOffset = m_vecValuesOffsets[varIdx];
+			const size_t domainSize = m_vecValuesOffsets[varIdx + 1] - valuesOffset;
+			for (size_t i = 0; i < domainSize; ++i)
+			{
+				bool isViolated;
+				if (i == assignmentIdx)
+				{
+					isViolated = !m_conflictsTracker.isSatisfiedConstraint(constrIdx);
+				}
+				else
 				{
-					assignmentHistory.emplace_back(var, std::optional<T>{});
+					var.unassign();
+					var.assignByIdx(i);
+					isViolated = !constraint.isSatisfied();
 				}
-				var.assignByIdx(assignmentIdx);
-				if (writeAssignmentHistory)
+
+				if (isViolated != m_vecIsViolated[violationsOffset + i])
 				{
-					const std::vector<T>& domain = var.getDomain();
-					assignmentHistory.emplace_back(var, std::optional<T>{ domain[assignmentIdx] });
+					m_vecIsViolated[violationsOffset + i] = isViolated;
+					if (isViolated)
+					{
+						m_vecPenalties[valuesOffset + i] += m_vecConstraintsWeights[constrIdx];
+					}
+					else
+					{
+						m_vecPenalties[valuesOffset + i] -= m_vecConstraintsWeights[constrIdx];
+					}
 				}
+			}
+			var.unassign();
+			var.assignByIdx(assignmentIdx);
+		}
 
-				lastReduction = reduction;
+		ConstraintProblem<T>& m_constraintProblem;
+		ConflictsTracker<T> m_conflictsTracker;
+		std::vector<size_t> m_vecConstraintsWeights;
+		std::vector<size_t> m_vecValuesOffsets;
+		std::vector<size_t> m_vecPenalties;
+		std::vector<size_t> m_vecConstraintsArcsOffsets;
+		std::vector<size_t> m_vecArcsViolationsOffsets;
+		std::vector<bool> m_vecIsViolated;
+		std::default_random_engine m_defaultRandomEngine;
+	};
 
-				for (Constraint<T>& unsatisfiedConstraint : constraintProblem.getUnsatisfiedConstraints())
+	// the assigned variables are read only. the history (if written) starts with the random start assignment
+	template <typename T>
+	const AssignmentHistory<T> constraintWeighting(ConstraintProblem<T>& constraintProblem, unsigned int maxBreakouts,
+		bool writeAssignmentHistory = false)
+	{
+		AssignmentHistory<T> assignmentHistory;
+		const std::vector<Ref<Variable<T>>> vecReadOnlyVars = constraintProblem.getAssignedVariables();
+		std::optional<std::unordered_set<Ref<Variable<T>>>> optReadOnlyVars{ std::unordered_set<Ref<Variable<T>>>{
+			vecReadOnlyVars.cbegin(), vecReadOnlyVars.cend() } };
+		constraintProblem.assignVarsWithRandomValues(optReadOnlyVars, writeAssignmentHistory ? &assignmentHistory : nullptr);
+		WeightedPenaltiesTracker<T> weightedPenaltiesTracker{ constraintProblem, optReadOnlyVars };
+
+		unsigned int breakoutsCount = 0;
+		while (weightedPenaltiesTracker.getConflictsTracker().getUnsatisfiedConstraintsSize() && !constraintProblem.isStopRequested())
+		{
+			std::optional<std::pair<size_t, size_t>> optBestReassignment = weightedPenaltiesTracker.selectBestReassignment();
+			if (!optBestReassignment)
+			{
+				if (maxBreakouts <= breakoutsCount++)
 				{
-					++constraintToWeightMap[unsatisfiedConstraint];
+					break;
 				}
+				weightedPenaltiesTracker.breakout();
+				continue;
 			}
 
-			if (i != maxTries - 1)
+			auto [varIdx, assignmentIdx] = *optBestReassignment;
+			Variable<T>& var = constraintProblem.getVariable(varIdx);
+			if (writeAssignmentHistory)
 			{
-				constraintProblem.unassignAllVariables();
+				assignmentHistory.emplace_back(var, std::optional<T>{});
+			}
+			weightedPenaltiesTracker.reassign(varIdx, assignmentIdx);
+			if (writeAssignmentHistory)
+			{
+				assignmentHistory.emplace_back(var, std::optional<T>{ var.getDomain()[assignmentIdx] });
 			}
 		}
-
 		return assignmentHistory;
 	}
 }
\ No newline at end of file
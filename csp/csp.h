@@ -12,18 +12,28 @@
 #include "constraint_evaluators.h"
 #include "domain_sorters.h"
 #include "unassigned_variable_selectors.h"
+#include "adaptive_variable_selectors.h"
 #include "start_state_genarators.h"
 #include "successor_generators.h"
 #include "score_calculators.h"
 #include "base_genetic_constraint_problem.h"
 #include "general_genetic_constraint_problem.h"
+#include "compressed_sparse_rows.h"
+#include "bitset_domain.h"
+#include "conflicts_tracker.h"
+#include "unassigned_variables_set.h"
 
 // csp inferences
 #include "forward_checking.h"
 #include "maintaining_arc_consistency.h"
+#include "constraints_propagation.h"
+#include "all_different.h"
+#include "linear_sum.h"
+#include "generalized_arc_consistency.h"
 
 // csp preprocessing
 #include "arc_consistency_3.h"
+#include "arc_consistency_3rm.h"
 #include "arc_consistency_4.h"
 #include "path_consistency_2.h"
 
@@ -33,8 +43,13 @@
 #include "min_conflicts.h"
 #include "constraints_weighting.h"
 #include "hill_climbing.h"
+#include "parallel_hill_climbing.h"
 #include "simulated_annealing.h"
+#include "parallel_tempering.h"
 #include "general_genetic_constraint_problem.h"
 #include "genetic_local_search.h"
 #include "tree_csp_solver.h"
-#include "naive_cycle_cutset.h"
\ No newline at end of file
+#include "naive_cycle_cutset.h"
+#include "portfolio_solver.h"
+#include "parallel_backtracking.h"
+#include "solutions_generator.h"
\ No newline at end of file
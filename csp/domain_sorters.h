@@ -37,4 +37,180 @@ namespace csp
 			[](const std::pair<size_t, T>& scoreToValue) -> T { return scoreToValue.second; });
 		return sortedDomain;
 	}
+
+	/*
+	Least Constraining Value by counting supports: the score of a value a of var is the number of values var = a leaves to var's
+	unassigned neighbors, i.e. of the values b in a neighbor's consistent domain such that var = a and neighbor = b are
+	consistent with the constraints they share. Values are tried by descending scores.
+	Each neighbor's consistent domain is computed once per call rather than once per value of var, and a value b is checked
+	against the shared constraints only, with no unordered_sets per value.
+	The compatibility of the values of a binary constraint does not depend on the rest of the assignment, hence it is cached in
+	a support table per (constraint, variable position), filled lazily and kept between calls. Thus an instance given to the
+	backtracking solvers as their DomainSorter reuses its support tables across the search tree.
+	When maxSampledNeighbors is not 0, the scores count at most maxSampledNeighbors unassigned neighbors, sampled anew by each call.
+	leastConstrainingValueBySupports is its stateless counterpart.
+	*/
+	template <typename T>
+	class LeastConstrainingValueBySupports final
+	{
+	public:
+		LeastConstrainingValueBySupports<T>(size_t maxSampledNeighbors = 0) :
+			m_pConstraintProblem{ nullptr },
+			m_vecSupportTables{ },
+			m_size_tMaxSampledNeighbors{ maxSampledNeighbors },
+			m_defaultRandomEngine{ std::random_device{}() }
+		{ }
+
+		const std::vector<T> operator()(ConstraintProblem<T>& constraintProblem, Variable<T>& var)
+		{
+			this->init_support_tables(constraintProblem);
+			const size_t varIdx = constraintProblem.getVariableIdx(var);
+			const std::vector<T> consistentDomain = constraintProblem.getConsistentDomain(var);
+			const std::vector<size_t> neighborsIdxs = this->get_sampled_unassigned_neighbors_idxs(constraintProblem, varIdx);
+
+			// the neighbors consistent domains are computed while var is still unassigned
+			std::vector<std::vector<T>> neighborsConsistentDomains;
+			std::vector<std::vector<size_t>> sharedConstraintsIdxs;
+			neighborsConsistentDomains.reserve(neighborsIdxs.size());
+			sharedConstraintsIdxs.reserve(neighborsIdxs.size());
+			for (size_t neighborIdx : neighborsIdxs)
+			{
+				neighborsConsistentDomains.emplace_back(constraintProblem.getConsistentDomain(constraintProblem.getVariable(neighborIdx)));
+				sharedConstraintsIdxs.emplace_back();
+				for (size_t constrIdx : constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
+				{
+					Span<const size_t> constrVarsIdxs = constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+					if (std::find(constrVarsIdxs.begin(), constrVarsIdxs.end(), neighborIdx) != constrVarsIdxs.end())
+					{
+						sharedConstraintsIdxs.back().push_back(constrIdx);
+					}
+				}
+			}
+
+			std::vector<size_t> scores(consistentDomain.size(), 0);
+			for (size_t i = 0; i < consistentDomain.size(); ++i)
+			{
+				var.assignByValue(consistentDomain[i]);
+				for (size_t j = 0; j < neighborsIdxs.size(); ++j)
+				{
+					Variable<T>& neighbor = constraintProblem.getVariable(neighborsIdxs[j]);
+					for (const T& neighborValue : neighborsConsistentDomains[j])
+					{
+						if (this->is_supported(constraintProblem, varIdx, consistentDomain[i], sharedConstraintsIdxs[j], neighbor, neighborValue))
+						{
+							++scores[i];
+						}
+					}
+				}
+				var.unassign();
+			}
+
+			std::vector<size_t> valuesPositions(consistentDomain.size());
+			std::iota(valuesPositions.begin(), valuesPositions.end(), 0);
+			std::stable_sort(valuesPositions.begin(), valuesPositions.end(), [&scores](size_t left, size_t right)
+				{
+					return scores[left] > scores[right];
+				});
+			std::vector<T> sortedDomain;
+			sortedDomain.reserve(consistentDomain.size());
+			for (size_t valuePosition : valuesPositions)
+			{
+				sortedDomain.push_back(consistentDomain[valuePosition]);
+			}
+			return sortedDomain;
+		}
+
+	private:
+		void init_support_tables(const ConstraintProblem<T>& constraintProblem)
+		{
+			const size_t constraintsSize = constraintProblem.getConstraints().size();
+			if (m_pConstraintProblem == &constraintProblem && m_vecSupportTables.size() == 2 * constraintsSize)
+			{
+				return;
+			}
+			m_pConstraintProblem = &constraintProblem;
+			m_vecSupportTables.assign(2 * constraintsSize, std::unordered_map<T, std::unordered_map<T, bool>>{ });
+		}
+
+		std::vector<size_t> get_sampled_unassigned_neighbors_idxs(const ConstraintProblem<T>& constraintProblem, size_t varIdx)
+		{
+			std::vector<size_t> neighborsIdxs;
+			for (size_t neighborIdx : constraintProblem.getNeighborsIdxs(varIdx))
+			{
+				if (!constraintProblem.getVariable(neighborIdx).isAssigned())
+				{
+					neighborsIdxs.push_back(neighborIdx);
+				}
+			}
+			if (!m_size_tMaxSampledNeighbors || neighborsIdxs.size() <= m_size_tMaxSampledNeighbors)
+			{
+				return neighborsIdxs;
+			}
+
+			// partial Fisher-Yates shuffle
+			for (size_t i = 0; i < m_size_tMaxSampledNeighbors; ++i)
+			{
+				std::uniform_int_distribution<size_t> iToLastDistribution(i, neighborsIdxs.size() - 1);
+				std::swap(neighborsIdxs[i], neighborsIdxs[iToLastDistribution(m_defaultRandomEngine)]);
+			}
+			neighborsIdxs.resize(m_size_tMaxSampledNeighbors);
+			return neighborsIdxs;
+		}
+
+		// var is assigned value, neighbor is unassigned and is assigned neighborValue only if a constraint has to be checked
+		bool is_supported(const ConstraintProblem<T>& constraintProblem, size_t varIdx, const T& value,
+			const std::vector<size_t>& sharedConstrsIdxs, Variable<T>& neighbor, const T& neighborValue)
+		{
+			bool isSupported = true;
+			for (size_t constrIdx : sharedConstrsIdxs)
+			{
+				Span<const size_t> constrVarsIdxs = constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+				if (constrVarsIdxs.size() == 2)
+				{
+					std::unordered_map<T, bool>& valueSupportTable = m_vecSupportTables[2 * constrIdx + (constrVarsIdxs[0] != varIdx)][value];
+					auto supportIt = valueSupportTable.find(neighborValue);
+					if (supportIt == valueSupportTable.end())
+					{
+						if (!neighbor.isAssigned())
+						{
+							neighbor.assignByValue(neighborValue);
+						}
+						supportIt = valueSupportTable.emplace(neighborValue, constraintProblem.getConstraint(constrIdx).isConsistent()).first;
+					}
+					isSupported = supportIt->second;
+				}
+				else
+				{
+					if (!neighbor.isAssigned())
+					{
+						neighbor.assignByValue(neighborValue);
+					}
+					isSupported = constraintProblem.getConstraint(constrIdx).isConsistent();
+				}
+
+				if (!isSupported)
+				{
+					break;
+				}
+			}
+
+			if (neighbor.isAssigned())
+			{
+				neighbor.unassign();
+			}
+			return isSupported;
+		}
+
+		const ConstraintProblem<T>* m_pConstraintProblem;
+		std::vector<std::unordered_map<T, std::unordered_map<T, bool>>> m_vecSupportTables;
+		size_t m_size_tMaxSampledNeighbors;
+		std::default_random_engine m_defaultRandomEngine;
+	};
+
+	template <typename T>
+	const std::vector<T> leastConstrainingValueBySupports(ConstraintProblem<T>& constraintProblem, Variable<T>& var)
+	{
+		LeastConstrainingValueBySupports<T> leastConstrainingValueBySupports;
+		return leastConstrainingValueBySupports(constraintProblem, var);
+	}
 }
\ No newline at end of file
@@ -13,8 +13,7 @@ namespace csp
 		const std::vector<Ref<Variable<T>>> unassignedNeighbors = constraintProblem.getUnassignedNeighbors(assignedVariable);
 		for (Variable<T>& unassignedNeighbor : unassignedNeighbors)
 		{
-			const std::vector<T> consistentDomain = constraintProblem.getConsistentDomain(unassignedNeighbor);
-			if (consistentDomain.empty())
+			if (constraintProblem.isConsistentDomainEmpty(unassignedNeighbor))
 			{
 				return false;
 			}
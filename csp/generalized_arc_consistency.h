@@ -0,0 +1,279 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+
+/*
+Generalized Arc Consistency 3 (GAC3) algorithm with residual supports, for constraints of any arity.
+A value a of an unassigned variable x is generalized arc consistent with a constraint c containing x iff some assignment of
+c's other unassigned variables, from their current domains, satisfies c together with x = a and c's assigned variables (a support).
+Supports are searched by backtracking over c's unassigned variables (smallest domains first), pruned by Constraint::isConsistent,
+hence the search may be exponential in c's arity when no support exists.
+The last support found for each (constraint, variable, value) is cached as a residue. Before searching, the residue is checked:
+if its values are still in their variables' domains, it is still a support. Residues need no undoing when backtracking.
+Arcs (constraint, variable position in it) are queued by dense ids, and a revised variable re-queues the arcs of its other constraints.
+GeneralizedArcConsistency<T> keeps its residues between calls, thus an instance can be given as an Inference to the backtracking
+solvers (maintaining GAC) and reuse residues across the search tree. gac3 and maintainingGAC are its stateless counterparts,
+and like the other preprocessing algorithms gac3 prunes permanently (see ConstraintProblem::commitTrail).
+*/
+
+namespace csp
+{
+	template <typename T>
+	class GeneralizedArcConsistency final
+	{
+	public:
+		GeneralizedArcConsistency<T>() :
+			m_pConstraintProblem{ nullptr },
+			m_vecArcsOffsets{ },
+			m_vecArcToConstraintIdx{ },
+			m_vecResidues{ },
+			m_vecIsQueuedArc{ },
+			m_size_tConstraintChecksCount{ 0 }
+		{ }
+
+		// preprocessing: enforces GAC on all the arcs of the constraint problem
+		bool enforce(ConstraintProblem<T>& constraintProblem)
+		{
+			this->init_arcs(constraintProblem);
+			std::queue<size_t> arcsQueue;
+			for (size_t arcId = 0; arcId < m_vecArcToConstraintIdx.size(); ++arcId)
+			{
+				this->enqueue_arc(constraintProblem, arcId, arcsQueue);
+			}
+			return this->propagate(constraintProblem, arcsQueue) && constraintProblem.isPotentiallySolvable();
+		}
+
+		// inference: enforces GAC starting from the arcs of the constraints containing assignedVariable
+		bool operator()(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+		{
+			this->init_arcs(constraintProblem);
+			std::queue<size_t> arcsQueue;
+			this->enqueue_constraints_arcs(constraintProblem, constraintProblem.getVariableIdx(assignedVariable), arcsQueue);
+			return this->propagate(constraintProblem, arcsQueue);
+		}
+
+		// number of Constraint::isConsistent evaluations made by the supports searches
+		constexpr size_t getConstraintChecksCount() const noexcept { return m_size_tConstraintChecksCount; }
+
+	private:
+		void init_arcs(const ConstraintProblem<T>& constraintProblem)
+		{
+			const size_t constraintsSize = constraintProblem.getConstraints().size();
+			if (m_pConstraintProblem == &constraintProblem && m_vecArcsOffsets.size() == constraintsSize + 1)
+			{
+				return;
+			}
+			m_pConstraintProblem = &constraintProblem;
+			m_vecArcsOffsets.assign(constraintsSize + 1, 0);
+			m_vecArcToConstraintIdx.clear();
+			for (size_t constrIdx = 0; constrIdx < constraintsSize; ++constrIdx)
+			{
+				const size_t constrVarsSize = constraintProblem.getVariablesIdxsOfConstraint(constrIdx).size();
+				m_vecArcsOffsets[constrIdx + 1] = m_vecArcsOffsets[constrIdx] + constrVarsSize;
+				m_vecArcToConstraintIdx.insert(m_vecArcToConstraintIdx.end(), constrVarsSize, constrIdx);
+			}
+			m_vecResidues.assign(m_vecArcToConstraintIdx.size(), std::unordered_map<T, std::vector<T>>{ });
+			m_vecIsQueuedArc.assign(m_vecArcToConstraintIdx.size(), false);
+		}
+
+		void enqueue_arc(const ConstraintProblem<T>& constraintProblem, size_t arcId, std::queue<size_t>& arcsQueue)
+		{
+			size_t constrIdx = m_vecArcToConstraintIdx[arcId];
+			size_t varIdx = constraintProblem.getVariablesIdxsOfConstraint(constrIdx)[arcId - m_vecArcsOffsets[constrIdx]];
+			if (!m_vecIsQueuedArc[arcId] && !constraintProblem.getVariable(varIdx).isAssigned())
+			{
+				m_vecIsQueuedArc[arcId] = true;
+				arcsQueue.push(arcId);
+			}
+		}
+
+		void enqueue_constraints_arcs(const ConstraintProblem<T>& constraintProblem, size_t varIdx, std::queue<size_t>& arcsQueue,
+			size_t skippedConstrIdx = UNASSIGNED)
+		{
+			for (size_t constrIdx : constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
+			{
+				if (constrIdx == skippedConstrIdx)
+				{
+					continue;
+				}
+				Span<const size_t> constrVarsIdxs = constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+				for (size_t varPosition = 0; varPosition < constrVarsIdxs.size(); ++varPosition)
+				{
+					if (constrVarsIdxs[varPosition] != varIdx)
+					{
+						this->enqueue_arc(constraintProblem, m_vecArcsOffsets[constrIdx] + varPosition, arcsQueue);
+					}
+				}
+			}
+		}
+
+		bool propagate(ConstraintProblem<T>& constraintProblem, std::queue<size_t>& arcsQueue)
+		{
+			bool isConsistent = true;
+			while (!arcsQueue.empty())
+			{
+				size_t arcId = arcsQueue.front();
+				arcsQueue.pop();
+				m_vecIsQueuedArc[arcId] = false;
+				if (!isConsistent)
+				{
+					continue;
+				}
+
+				size_t constrIdx = m_vecArcToConstraintIdx[arcId];
+				size_t varIdx = constraintProblem.getVariablesIdxsOfConstraint(constrIdx)[arcId - m_vecArcsOffsets[constrIdx]];
+				if (this->revise(constraintProblem, arcId))
+				{
+					if (constraintProblem.getVariable(varIdx).getDomain().empty())
+					{
+						// the queue is drained rather than abandoned, so the queued flags are left cleared for the next call
+						isConsistent = false;
+						continue;
+					}
+					this->enqueue_constraints_arcs(constraintProblem, varIdx, arcsQueue, constrIdx);
+				}
+			}
+			return isConsistent;
+		}
+
+		bool revise(ConstraintProblem<T>& constraintProblem, size_t arcId)
+		{
+			size_t constrIdx = m_vecArcToConstraintIdx[arcId];
+			size_t varPosition = arcId - m_vecArcsOffsets[constrIdx];
+			Variable<T>& var = constraintProblem.getVariable(constraintProblem.getVariablesIdxsOfConstraint(constrIdx)[varPosition]);
+			bool isRevised = false;
+			for (size_t i = var.getDomain().size(); 0 < i; --i)
+			{
+				if (!this->has_support(constraintProblem, arcId, i - 1))
+				{
+					constraintProblem.removeFromDomainByIdx(var, i - 1);
+					isRevised = true;
+				}
+			}
+			return isRevised;
+		}
+
+		bool is_valid_residue(const ConstraintProblem<T>& constraintProblem, Span<const size_t> constrVarsIdxs,
+			const std::vector<T>& residue) const
+		{
+			for (size_t varPosition = 0; varPosition < constrVarsIdxs.size(); ++varPosition)
+			{
+				const Variable<T>& var = constraintProblem.getVariable(constrVarsIdxs[varPosition]);
+				if (var.isAssigned())
+				{
+					if (!(var.getValue() == residue[varPosition]))
+					{
+						return false;
+					}
+				}
+				else
+				{
+					const std::vector<T>& domain = var.getDomain();
+					if (std::find(domain.cbegin(), domain.cend(), residue[varPosition]) == domain.cend())
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		bool has_support(ConstraintProblem<T>& constraintProblem, size_t arcId, size_t valueIdx)
+		{
+			size_t constrIdx = m_vecArcToConstraintIdx[arcId];
+			size_t varPosition = arcId - m_vecArcsOffsets[constrIdx];
+			Span<const size_t> constrVarsIdxs = constraintProblem.getVariablesIdxsOfConstraint(constrIdx);
+			Variable<T>& var = constraintProblem.getVariable(constrVarsIdxs[varPosition]);
+			T value = var.getDomain()[valueIdx];
+
+			std::unordered_map<T, std::vector<T>>& residues = m_vecResidues[arcId];
+			auto residueIt = residues.find(value);
+			if (residueIt != residues.end() && this->is_valid_residue(constraintProblem, constrVarsIdxs, residueIt->second))
+			{
+				return true;
+			}
+
+			std::vector<size_t> searchedVarsIdxs;
+			for (size_t otherVarIdx : constrVarsIdxs)
+			{
+				if (!constraintProblem.getVariable(otherVarIdx).isAssigned() && otherVarIdx != constrVarsIdxs[varPosition])
+				{
+					searchedVarsIdxs.push_back(otherVarIdx);
+				}
+			}
+			std::sort(searchedVarsIdxs.begin(), searchedVarsIdxs.end(), [&constraintProblem](size_t left, size_t right)
+				{
+					return constraintProblem.getVariable(left).getDomain().size() < constraintProblem.getVariable(right).getDomain().size();
+				});
+
+			const Constraint<T>& constraint = constraintProblem.getConstraint(constrIdx);
+			std::vector<T> support;
+			var.assignByIdx(valueIdx);
+			++m_size_tConstraintChecksCount;
+			bool isSupported = constraint.isConsistent() &&
+				this->search_support(constraintProblem, constraint, searchedVarsIdxs, 0, constrVarsIdxs, support);
+			var.unassign();
+			if (isSupported)
+			{
+				residues.insert_or_assign(value, std::move(support));
+			}
+			return isSupported;
+		}
+
+		// assigns searchedVarsIdxs[depth...] consistently, writing the found support (in constraint order) to support
+		bool search_support(ConstraintProblem<T>& constraintProblem, const Constraint<T>& constraint,
+			const std::vector<size_t>& searchedVarsIdxs, size_t depth, Span<const size_t> constrVarsIdxs, std::vector<T>& support)
+		{
+			if (depth == searchedVarsIdxs.size())
+			{
+				support.reserve(constrVarsIdxs.size());
+				for (size_t varIdx : constrVarsIdxs)
+				{
+					support.push_back(constraintProblem.getVariable(varIdx).getValue());
+				}
+				return true;
+			}
+
+			Variable<T>& searchedVar = constraintProblem.getVariable(searchedVarsIdxs[depth]);
+			const size_t domainSize = searchedVar.getDomain().size();
+			for (size_t i = 0; i < domainSize; ++i)
+			{
+				searchedVar.assignByIdx(i);
+				++m_size_tConstraintChecksCount;
+				bool isSupported = constraint.isConsistent() &&
+					this->search_support(constraintProblem, constraint, searchedVarsIdxs, depth + 1, constrVarsIdxs, support);
+				searchedVar.unassign();
+				if (isSupported)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		const ConstraintProblem<T>* m_pConstraintProblem;
+		std::vector<size_t> m_vecArcsOffsets;
+		std::vector<size_t> m_vecArcToConstraintIdx;
+		std::vector<std::unordered_map<T, std::vector<T>>> m_vecResidues;
+		std::vector<bool> m_vecIsQueuedArc;
+		size_t m_size_tConstraintChecksCount;
+	};
+
+	template <typename T>
+	bool gac3(ConstraintProblem<T>& constraintProblem)
+	{
+		const size_t trailMark = constraintProblem.getTrailMark();
+		GeneralizedArcConsistency<T> generalizedArcConsistency;
+		bool isPotentiallySolvable = generalizedArcConsistency.enforce(constraintProblem);
+		constraintProblem.commitTrail(trailMark);
+		return isPotentiallySolvable;
+	}
+
+	template <typename T>
+	bool maintainingGAC(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+	{
+		GeneralizedArcConsistency<T> generalizedArcConsistency;
+		return generalizedArcConsistency(constraintProblem, assignedVariable);
+	}
+}
\ No newline at end of file
@@ -17,7 +17,7 @@ namespace csp
 		Assignment<T>* pBestIndividual = &(pCurrPopulation->back());
 		unsigned int bestFitness = 0;
 
-		for (unsigned i = 0; i < maxGenerations; ++i)
+		for (unsigned i = 0; i < maxGenerations && !constrProb.isStopRequested(); ++i)
 		{
 			const std::optional<ConstraintProblem<T>> optSolution = baseGeneticConstrProb.getSolution(*pCurrPopulation);
 			if (optSolution)
@@ -18,63 +18,202 @@ namespace csp
 
 namespace csp
 {
+	/*
+	Resumable iterative backtracking engine, shared by the heuristic backtracking solvers and SolutionsGenerator.
+	An explicit stack of frames (selected variable, its sorted domain, next value to try, trail mark) replaces recursion,
+	so the search depth is not bounded by the call stack, and the search can be suspended at each solution.
+	Frames are kept when popped, so their domains' storage is reused by later frames of the same depth.
+	next() assigns constraintProblem with the next solution and returns true, or returns false once the search is exhausted
+	or stopped, with the variables the search assigned unassigned. reset() undoes the search, so that next() starts it over.
+	The callables are referenced rather than copied, hence they must outlive the engine.
+	Assignments and unassignments are written to pAssignmentHistory (if not null) in the order the recursive search made them.
+	*/
 	template <typename T>
-	static bool __heuristicBacktrackingSolver(ConstraintProblem<T>& constraintProblem,
-		const PrimarySelector<T>& primarySelector,
-		const SecondarySelector<T>& secondarySelector,
-		const std::optional<DomainSorter<T>>& optDomainSorter,
-		const std::optional<Inference<T>>& optInference,
-		bool writeAssignmentHistory,
-		AssignmentHistory<T>& assignmentHistory)
+	class __HeuristicBacktrackingEngine final
 	{
-		if (constraintProblem.isCompletelyAssigned())
+	private:
+		struct Frame
 		{
-			if (constraintProblem.isConsistentlyAssigned())
+			Variable<T>* pSelectedVar;
+			std::vector<T> sortedDomain;
+			size_t nextValuePosition;
+			size_t trailMark;
+		};
+
+	public:
+		__HeuristicBacktrackingEngine<T>(ConstraintProblem<T>& constraintProblem,
+			const PrimarySelector<T>& primarySelector,
+			const SecondarySelector<T>& secondarySelector,
+			const std::optional<DomainSorter<T>>& optDomainSorter,
+			const std::optional<Inference<T>>& optInference,
+			AssignmentHistory<T>* pAssignmentHistory = nullptr) :
+			m_constraintProblem{ constraintProblem },
+			m_primarySelector{ primarySelector },
+			m_secondarySelector{ secondarySelector },
+			m_optDomainSorter{ optDomainSorter },
+			m_optInference{ optInference },
+			m_pAssignmentHistory{ pAssignmentHistory },
+			m_vecFrames(constraintProblem.getVariables().size()),
+			m_size_tDepth{ 0 },
+			m_size_tInitialTrailMark{ constraintProblem.getTrailMark() },
+			m_boolStarted{ false },
+			m_boolExhausted{ false }
+		{ }
+
+		__HeuristicBacktrackingEngine<T>(const __HeuristicBacktrackingEngine<T>&) = delete;
+		__HeuristicBacktrackingEngine<T>& operator=(const __HeuristicBacktrackingEngine<T>&) = delete;
+
+		constexpr bool isStarted() const noexcept { return m_boolStarted; }
+
+		constexpr bool isExhausted() const noexcept { return m_boolExhausted; }
+
+		bool next()
+		{
+			if (m_boolExhausted)
 			{
-				return true;
+				return false;
 			}
-			else
+			// the first call descends from the root, later ones resume by backtracking from the last solution
+			bool isDescending = !m_boolStarted;
+			m_boolStarted = true;
+			while (true)
 			{
-				return false;
+				if (isDescending)
+				{
+					if (m_constraintProblem.isCompletelyAssigned())
+					{
+						if (m_constraintProblem.isConsistentlyAssigned())
+						{
+							return true;
+						}
+					}
+					else if (m_constraintProblem.isStopRequested())
+					{
+						this->unwind();
+						m_boolExhausted = true;
+						return false;
+					}
+					else
+					{
+						this->push_frame();
+					}
+				}
+
+				if (!m_size_tDepth)
+				{
+					m_boolExhausted = true;
+					return false;
+				}
+				Frame& frame = m_vecFrames[m_size_tDepth - 1];
+				if (frame.pSelectedVar->isAssigned())
+				{
+					this->unassign_frame_value(frame);
+				}
+
+				isDescending = this->assign_next_value(frame);
+				if (!isDescending)
+				{
+					--m_size_tDepth;
+				}
 			}
 		}
 
-		const std::vector<Ref<Variable<T>>> candidateVars = primarySelector(constraintProblem);
-		Variable<T>& selectedVar = candidateVars.size() == 1 ? candidateVars[0].get() : secondarySelector(constraintProblem, candidateVars);
+		void reset()
+		{
+			this->unwind();
+			m_constraintProblem.restoreTrail(m_size_tInitialTrailMark);
+			m_boolStarted = false;
+			m_boolExhausted = false;
+		}
 
-		const std::vector<T> sortedDomain = optDomainSorter ? (*optDomainSorter)(constraintProblem, selectedVar) : selectedVar.getDomain();
-		for (T value : sortedDomain)
+	private:
+		void push_frame()
 		{
-			selectedVar.assignByValue(value);
-			if (writeAssignmentHistory)
+			const std::vector<Ref<Variable<T>>> candidateVars = m_primarySelector(m_constraintProblem);
+			Variable<T>& selectedVar = candidateVars.size() == 1 ? candidateVars[0].get() :
+				m_secondarySelector(m_constraintProblem, candidateVars);
+			Frame& frame = m_vecFrames[m_size_tDepth++];
+			frame.pSelectedVar = &selectedVar;
+			if (m_optDomainSorter)
 			{
-				assignmentHistory.emplace_back(selectedVar, std::optional<T>{value});
+				frame.sortedDomain = (*m_optDomainSorter)(m_constraintProblem, selectedVar);
 			}
+			else
+			{
+				frame.sortedDomain.assign(selectedVar.getDomain().cbegin(), selectedVar.getDomain().cend());
+			}
+			frame.nextValuePosition = 0;
+		}
 
-			if (optInference && !((*optInference)(constraintProblem, selectedVar)))
+		// assigns the frame's variable with its next value which the inference does not refute
+		bool assign_next_value(Frame& frame)
+		{
+			Variable<T>& selectedVar = *frame.pSelectedVar;
+			while (frame.nextValuePosition < frame.sortedDomain.size())
 			{
-				selectedVar.unassign();
-				if (writeAssignmentHistory)
+				const T& value = frame.sortedDomain[frame.nextValuePosition++];
+				selectedVar.assignByValue(value);
+				if (m_pAssignmentHistory)
 				{
-					assignmentHistory.emplace_back(selectedVar, std::optional<T>{});
+					m_pAssignmentHistory->emplace_back(selectedVar, std::optional<T>{ value });
 				}
-				return false;
+				frame.trailMark = m_constraintProblem.getTrailMark();
+				if (!m_optInference || (*m_optInference)(m_constraintProblem, selectedVar))
+				{
+					return true;
+				}
+				this->unassign_frame_value(frame);
 			}
+			return false;
+		}
 
-			if (__heuristicBacktrackingSolver<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter, optInference,
-				writeAssignmentHistory, assignmentHistory))
+		void unassign_frame_value(Frame& frame)
+		{
+			m_constraintProblem.restoreTrail(frame.trailMark);
+			frame.pSelectedVar->unassign();
+			if (m_pAssignmentHistory)
 			{
-				return true;
+				m_pAssignmentHistory->emplace_back(*frame.pSelectedVar, std::optional<T>{});
 			}
+		}
 
-			selectedVar.unassign();
-			if (writeAssignmentHistory)
+		void unwind()
+		{
+			for (; m_size_tDepth; --m_size_tDepth)
 			{
-				assignmentHistory.emplace_back(selectedVar, std::optional<T>{});
+				Frame& frame = m_vecFrames[m_size_tDepth - 1];
+				if (frame.pSelectedVar->isAssigned())
+				{
+					this->unassign_frame_value(frame);
+				}
 			}
 		}
 
-		return false;
+		ConstraintProblem<T>& m_constraintProblem;
+		const PrimarySelector<T>& m_primarySelector;
+		const SecondarySelector<T>& m_secondarySelector;
+		const std::optional<DomainSorter<T>>& m_optDomainSorter;
+		const std::optional<Inference<T>>& m_optInference;
+		AssignmentHistory<T>* m_pAssignmentHistory;
+		std::vector<Frame> m_vecFrames;
+		size_t m_size_tDepth;
+		const size_t m_size_tInitialTrailMark;
+		bool m_boolStarted;
+		bool m_boolExhausted;
+	};
+
+	template <typename T>
+	static bool __heuristicBacktrackingSolver(ConstraintProblem<T>& constraintProblem,
+		const PrimarySelector<T>& primarySelector,
+		const SecondarySelector<T>& secondarySelector,
+		const std::optional<DomainSorter<T>>& optDomainSorter,
+		const std::optional<Inference<T>>& optInference,
+		bool writeAssignmentHistory,
+		AssignmentHistory<T>& assignmentHistory)
+	{
+		__HeuristicBacktrackingEngine<T> heuristicBacktrackingEngine{ constraintProblem, primarySelector, secondarySelector,
+			optDomainSorter, optInference, writeAssignmentHistory ? &assignmentHistory : nullptr };
+		return heuristicBacktrackingEngine.next();
 	}
 
 	template <typename T>
@@ -86,65 +225,110 @@ namespace csp
 		bool writeAssignmentHistory = false)
 	{
 		AssignmentHistory<T> assignmentHistory;
+		const size_t trailMark = constraintProblem.getTrailMark();
 		__heuristicBacktrackingSolver<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter, optInference, 
 			writeAssignmentHistory, assignmentHistory);
+		// domains pruned by the inference are restored, the found assignment (if any) stays
+		constraintProblem.restoreTrail(trailMark);
 		return assignmentHistory;
 	}
 
-	template <typename T>
-	static void __heuristicBacktrackingSolver_findAllSolutions(ConstraintProblem<T>& constraintProblem,
+	// calls onSolution with constraintProblem completely and consistently assigned, once for each solution
+	template <typename T, typename OnSolution>
+	static void __heuristicBacktrackingSolver_visitAllSolutions(ConstraintProblem<T>& constraintProblem,
 		const PrimarySelector<T>& primarySelector,
 		const SecondarySelector<T>& secondarySelector,
 		const std::optional<DomainSorter<T>>& optDomainSorter,
 		const std::optional<Inference<T>>& optInference,
-		std::unordered_set<Assignment<T>>& solutions)
+		OnSolution& onSolution)
 	{
-		if (constraintProblem.isCompletelyAssigned())
+		__HeuristicBacktrackingEngine<T> heuristicBacktrackingEngine{ constraintProblem, primarySelector, secondarySelector,
+			optDomainSorter, optInference };
+		while (heuristicBacktrackingEngine.next())
 		{
-			if (constraintProblem.isConsistentlyAssigned())
-			{
-				solutions.emplace(constraintProblem.getCurrentAssignment());
-			}
-			else
-			{
-				return;
-			}
+			onSolution(constraintProblem);
 		}
+	}
 
-		if (constraintProblem.isCompletelyAssigned())
-			return;
-
-		const std::vector<Ref<Variable<T>>> candidateVars = primarySelector(constraintProblem);
-		Variable<T>& selectedVar = candidateVars.size() == 1 ? candidateVars[0].get() : secondarySelector(constraintProblem, candidateVars);
+	// values rather than assignment indices, since indices are relative to domains which the inference may have pruned
+	template <typename T>
+	static std::vector<VariableValuePair<T>> __getSolutionValues(const ConstraintProblem<T>& solvedProblem)
+	{
+		const std::vector<Ref<Variable<T>>>& variables = solvedProblem.getVariables();
+		std::vector<VariableValuePair<T>> solutionValues;
+		solutionValues.reserve(variables.size());
+		for (Variable<T>& var : variables)
+		{
+			solutionValues.emplace_back(var, var.getValue());
+		}
+		return solutionValues;
+	}
 
-		const std::vector<T> sortedDomain = optDomainSorter ? (*optDomainSorter)(constraintProblem, selectedVar) : selectedVar.getDomain();
-		for (T value : sortedDomain)
+	template <typename T>
+	const std::unordered_set<Assignment<T>> heuristicBacktrackingSolver_findAllSolutions(ConstraintProblem<T>& constraintProblem,
+		const PrimarySelector<T>& primarySelector,
+		const SecondarySelector<T>& secondarySelector = chooseFirstCandidateVar_secondarySelector<T>,
+		const std::optional<DomainSorter<T>>& optDomainSorter = std::optional<DomainSorter<T>>{},
+		const std::optional<Inference<T>> optInference = std::optional<Inference<T>>{})
+	{
+		std::vector<std::vector<VariableValuePair<T>>> solutionsValues;
+		auto insertSolutionValues = [&solutionsValues](const ConstraintProblem<T>& solvedProblem) -> void
 		{
-			selectedVar.assignByValue(value);
+			solutionsValues.emplace_back(__getSolutionValues<T>(solvedProblem));
+		};
+		const size_t trailMark = constraintProblem.getTrailMark();
+		__heuristicBacktrackingSolver_visitAllSolutions<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter,
+			optInference, insertSolutionValues);
+		constraintProblem.restoreTrail(trailMark);
 
-			if (optInference && (*optInference)(constraintProblem, selectedVar))
+		std::unordered_set<Assignment<T>> solutions;
+		solutions.reserve(solutionsValues.size());
+		for (const std::vector<VariableValuePair<T>>& solutionValues : solutionsValues)
+		{
+			Assignment<T> solution;
+			solution.reserve(solutionValues.size());
+			for (const auto& [var, value] : solutionValues)
 			{
-				selectedVar.unassign();
-				return;
+				solution.emplace(var, var.get().getAssignmentIdxOfValue(value));
 			}
-
-			__heuristicBacktrackingSolver_findAllSolutions<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter,
-				optInference, solutions);
-
-			selectedVar.unassign();
+			solutions.emplace(std::move(solution));
 		}
+		return solutions;
 	}
 
+	// counts the solutions without materializing them
 	template <typename T>
-	const std::unordered_set<Assignment<T>> heuristicBacktrackingSolver_findAllSolutions(ConstraintProblem<T>& constraintProblem,
+	uint64_t heuristicBacktrackingSolver_countAllSolutions(ConstraintProblem<T>& constraintProblem,
 		const PrimarySelector<T>& primarySelector,
-		const SecondarySelector<T>& secondarySelector = csp::chooseFirstCandidateVar_secondarySelector,
+		const SecondarySelector<T>& secondarySelector = chooseFirstCandidateVar_secondarySelector<T>,
 		const std::optional<DomainSorter<T>>& optDomainSorter = std::optional<DomainSorter<T>>{},
 		const std::optional<Inference<T>> optInference = std::optional<Inference<T>>{})
 	{
-		std::unordered_set<Assignment<T>> solutions;
-		__heuristicBacktrackingSolver_findAllSolutions<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter,
-			optInference, solutions);
-		return solutions;
+		uint64_t solutionsCount = 0;
+		auto countSolution = [&solutionsCount](const ConstraintProblem<T>&) -> void { ++solutionsCount; };
+		const size_t trailMark = constraintProblem.getTrailMark();
+		__heuristicBacktrackingSolver_visitAllSolutions<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter,
+			optInference, countSolution);
+		constraintProblem.restoreTrail(trailMark);
+		return solutionsCount;
+	}
+
+	/*
+	Calls solutionVisitor with constraintProblem assigned with each solution in turn, rather than copying the solutions.
+	The assignment (and the domains, which the inference may have pruned) is valid only during the call,
+	and solutionVisitor must not change it.
+	*/
+	template <typename T>
+	void heuristicBacktrackingSolver_forEachSolution(ConstraintProblem<T>& constraintProblem,
+		const SolutionVisitor<T>& solutionVisitor,
+		const PrimarySelector<T>& primarySelector,
+		const SecondarySelector<T>& secondarySelector = chooseFirstCandidateVar_secondarySelector<T>,
+		const std::optional<DomainSorter<T>>& optDomainSorter = std::optional<DomainSorter<T>>{},
+		const std::optional<Inference<T>> optInference = std::optional<Inference<T>>{})
+	{
+		const size_t trailMark = constraintProblem.getTrailMark();
+		__heuristicBacktrackingSolver_visitAllSolutions<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter,
+			optInference, solutionVisitor);
+		constraintProblem.restoreTrail(trailMark);
 	}
 }
\ No newline at end of file
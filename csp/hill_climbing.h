@@ -9,66 +9,111 @@
 
 namespace csp
 {
+	/*
+	Climbs from the current assignment of problem, whose score is currScore, and returns the score it climbed to.
+	Each step applies the first of up to maxSuccessors successors which improves the score. The problem is checked for being
+	solved only after moves reaching minSolvedCheckScore, and isSolved is set if the climb stopped at a solution.
+	*/
+	template <typename T>
+	static unsigned int __climbFirstChoice(ConstraintProblem<T>& problem, unsigned int currScore, unsigned int minSolvedCheckScore,
+		bool& isSolved, std::default_random_engine& defaultRandomEngine, unsigned int maxSteps, unsigned int maxSuccessors,
+		const SuccessorGenerator<T>& generateSuccessor, const ScoreCalculator<T>& calculateScore,
+		const ScoreDeltaCalculator<T>& calculateScoreDelta, const std::function<bool()>& isStopRequested)
+	{
+		bool isMoved = true;
+		for (unsigned int i = 0; i < maxSteps && !isStopRequested(); ++i)
+		{
+			if (isMoved && minSolvedCheckScore <= currScore && problem.isCompletelyConsistentlyAssigned())
+			{
+				isSolved = true;
+				return currScore;
+			}
+
+			isMoved = false;
+			for (unsigned int j = 0; j < maxSuccessors && !isMoved; ++j)
+			{
+				Reassignment reassignment = generateSuccessor(problem, defaultRandomEngine);
+				if (calculateScoreDelta)
+				{
+					int delta = calculateScoreDelta(problem, reassignment);
+					if (0 < delta)
+					{
+						applyReassignment<T>(problem, reassignment);
+						currScore += static_cast<unsigned int>(delta);
+						isMoved = true;
+					}
+					continue;
+				}
+
+				Reassignment revertingReassignment = applyReassignment<T>(problem, reassignment);
+				unsigned int successorScore = calculateScore(problem);
+				if (currScore < successorScore)
+				{
+					currScore = successorScore;
+					isMoved = true;
+				}
+				else
+				{
+					applyReassignment<T>(problem, revertingReassignment);
+				}
+			}
+		}
+		return currScore;
+	}
+
+	/*
+	Searches a deep copy of constraintProblem (into bestVars and bestConstraints), which is returned with the best assignment found.
+	Successors are applied to the copy in place and reverted unless they improve the score, and the best assignment is kept as
+	assignment indices rather than as another deep copy.
+	Successors are scored by calculateScoreDelta, or by the delta counterpart of calculateScore if it has one (see
+	getScoreDeltaCalculator), and by calculateScore otherwise. A solution is assumed to score at least as high as any other
+	assignment, hence the problem is checked for being solved only when the score reaches the best one found.
+	See parallelRandomRestartFirstChoiceHillClimbing for distributing the restarts over threads.
+	*/
 	template <typename T>
 	ConstraintProblem<T> randomRestartFirstChoiceHillClimbing(ConstraintProblem<T>& constraintProblem,
 		std::vector<Constraint<T>>& bestConstraints, std::vector<Variable<T>>& bestVars,
 		unsigned int maxRestarts, unsigned int maxSteps, unsigned int maxSuccessors,
 		const StartStateGenarator<T>& generateStartState = generateStartStateRandomly<T>,
 		const SuccessorGenerator<T>& generateSuccessor = alterRandomVariableValuePair<T>,
-		const ScoreCalculator<T>& calculateScore = consistentConstraintsAmount<T>)
+		const ScoreCalculator<T>& calculateScore = consistentConstraintsAmount<T>,
+		const ScoreDeltaCalculator<T>& calculateScoreDelta = ScoreDeltaCalculator<T>{ })
 	{
-		ConstraintProblem<T> bestProblem = generateStartState(constraintProblem, bestVars, bestConstraints);
-		ConstraintProblem<T>* pBestProblem = &(bestProblem);
-		if (pBestProblem->isCompletelyConsistentlyAssigned() || maxRestarts == 1)
+		const ScoreDeltaCalculator<T> calculateSuccessorScoreDelta = calculateScoreDelta ? calculateScoreDelta :
+			getScoreDeltaCalculator(calculateScore);
+		std::random_device randomDevice;
+		std::default_random_engine defaultRandomEngine{ randomDevice() };
+		ConstraintProblem<T> problem = constraintProblem.deepCopy(bestVars, bestConstraints);
+		generateStartState(problem, defaultRandomEngine);
+		if (problem.isCompletelyConsistentlyAssigned() || maxRestarts == 1)
 		{
-			return *pBestProblem;
+			return problem;
 		}
 		--maxRestarts;
 
-		unsigned int bestScore = calculateScore(*pBestProblem);
-		
-		for (unsigned int i = 0; i < maxRestarts; ++i)
+		unsigned int bestScore = calculateScore(problem);
+		std::vector<size_t> bestAssignmentIdxs;
+		__writeAssignmentIdxs<T>(problem, bestAssignmentIdxs);
+		const std::function<bool()> isStopRequested = [&constraintProblem]() -> bool { return constraintProblem.isStopRequested(); };
+		for (unsigned int i = 0; i < maxRestarts && !isStopRequested(); ++i)
 		{
-			std::vector<csp::Variable<T>> currVars;
-			std::vector<csp::Constraint<T>> currConstrs;
-			ConstraintProblem<T> currConstrProb = generateStartState(*pBestProblem, currVars, currConstrs);
-			ConstraintProblem<T>* pCurrConstrProb = &(currConstrProb);
-			for (unsigned int j = 0; j < maxSteps; ++j)
+			generateStartState(problem, defaultRandomEngine);
+			bool isSolved = false;
+			unsigned int currScore = __climbFirstChoice(problem, calculateScore(problem), bestScore, isSolved, defaultRandomEngine,
+				maxSteps, maxSuccessors, generateSuccessor, calculateScore, calculateSuccessorScoreDelta, isStopRequested);
+			if (isSolved)
 			{
-				if (pCurrConstrProb->isCompletelyConsistentlyAssigned())
-				{
-					bestConstraints.clear();
-					bestVars.clear();
-					*pBestProblem = pCurrConstrProb->deepCopy(bestVars, bestConstraints);
-					return *pBestProblem;
-				}
-
-				unsigned int currScore = calculateScore(*pCurrConstrProb);
-				if (bestScore < currScore)
-				{
-					bestScore = currScore;
-					bestConstraints.clear();
-					bestVars.clear();
-					*pBestProblem = pCurrConstrProb->deepCopy(bestVars, bestConstraints);
-				}
+				return problem;
+			}
 
-				for (unsigned int k = 0; k < maxSuccessors; ++k)
-				{
-					std::vector<csp::Variable<T>> successorVars;
-					std::vector<csp::Constraint<T>> successorConstrs;
-					ConstraintProblem<T> successorProb = generateSuccessor(*pCurrConstrProb, successorVars, successorConstrs);
-					unsigned int successorScore = calculateScore(successorProb);
-					if (currScore < successorScore)
-					{
-						currConstrs.clear();
-						currVars.clear();
-						*pCurrConstrProb = successorProb.deepCopy(currVars, currConstrs);
-						break;
-					}
-				}
+			if (bestScore < currScore)
+			{
+				bestScore = currScore;
+				__writeAssignmentIdxs<T>(problem, bestAssignmentIdxs);
 			}
 		}
 
-		return *pBestProblem;
+		__assignFromAssignmentIdxs<T>(problem, bestAssignmentIdxs);
+		return problem;
 	}
 }
\ No newline at end of file
@@ -11,8 +11,7 @@
 
 
 // CSPDO for c++20:
-// use coroutines in backtracking
-// use wait and notify on atomics in ConstraintProblem<T>::isCompletelyConsistentlyAssigned()
+// use coroutines in backtracking (SolutionsGenerator<T> resumes an explicit stack for now)
 // use a concept for T in Variable<T>
 // turn this library into a module
 
@@ -26,12 +25,41 @@ namespace csp
 
 	constexpr size_t SIZE_LIMIT = 40;	// in bytes
 
+	constexpr size_t PARALLEL_CONSISTENCY_CHECK_MIN_CONSTRAINTS = 1 << 16;
+
 	//typedef std::conditional<sizeof(int) >= sizeof(double), int, double>::type PassType
 
 	//template <typename T>
 	//using PassType = typename std::conditional_t<sizeof(T) <= SIZE_LIMIT, T, const T&>;
 }
 
+namespace csp
+{
+	// CSPDO for c++20: replace with std::span
+	template <typename U>
+	class Span final
+	{
+	public:
+		constexpr Span() noexcept : m_pBegin{ nullptr }, m_size_tSize{ 0 }
+		{ }
+
+		constexpr Span(U* pBegin, size_t size) noexcept : m_pBegin{ pBegin }, m_size_tSize{ size }
+		{ }
+
+		constexpr U* begin() const noexcept { return m_pBegin; }
+		constexpr U* end() const noexcept { return m_pBegin + m_size_tSize; }
+		constexpr size_t size() const noexcept { return m_size_tSize; }
+		constexpr bool empty() const noexcept { return !m_size_tSize; }
+		constexpr U& operator[](size_t idx) const noexcept { return m_pBegin[idx]; }
+		constexpr U& front() const noexcept { return *m_pBegin; }
+		constexpr U& back() const noexcept { return m_pBegin[m_size_tSize - 1]; }
+
+	private:
+		U* m_pBegin;
+		size_t m_size_tSize;
+	};
+}
+
 namespace csp
 {
 	template<typename S, typename T, typename = void>
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+#include "forward_checking.h"
+#include "constraints_propagation.h"
+#include "all_different.h"
+
+/*
+Bounds propagation of linear constraints, used as an inference by the backtracking solvers.
+Linear constraints are those constructed with the built-in LinearSum<T> evaluator (sum of a_i * x_i {=, <=, >=} c),
+and those constructed with ExactLengthExactSum<T> whose valuesAmount is the constraint's number of variables (sum of x_i = c).
+Each term a_i * x_i is bounded by its variable's domain (or value, if assigned), and the bounds of the other terms bound it:
+for sum = c, a_i * x_i lies in [c - (maximal sum of the other terms), c - (minimal sum of the other terms)].
+Values outside a term's bounds are pruned, until no bounds change, hence linear constraints prune as soon as variables are assigned,
+rather than being judged only when completely assigned.
+1. linearSumBoundsPropagation - propagates linear constraints, then forward checks the other constraints.
+2. globalConstraintsPropagation - propagates linear constraints by bounds and all-different constraints by allDifferentGAC's
+	algorithm in one fixed point, so that prunings of either kind cascade to the other (e.g. magic squares, cryptarithms).
+*/
+
+namespace csp
+{
+	template <typename T>
+	constexpr bool isLinearSumConstraint(const Constraint<T>& constraint) noexcept
+	{
+		if constexpr (std::is_arithmetic_v<T>)
+		{
+			const AnyConstraintEvaluator<T>& anyConstraintEvaluator = constraint.getAnyConstraintEvaluator();
+			const ExactLengthExactSum<T>* pExactLengthExactSum = std::get_if<ExactLengthExactSum<T>>(&anyConstraintEvaluator);
+			return std::holds_alternative<LinearSum<T>>(anyConstraintEvaluator) ||
+				(pExactLengthExactSum && pExactLengthExactSum->valuesAmount == constraint.getVariables().size());
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	template <typename T>
+	static bool __boundsFilterLinearTerms(ConstraintProblem<T>& constraintProblem, const Constraint<T>& constraint,
+		const std::vector<LinearValue<T>>& coefficients, LinearRelation relation, LinearValue<T> rightHandSide,
+		std::vector<size_t>& prunedVarsIdxs)
+	{
+		const std::vector<Ref<Variable<T>>>& variables = constraint.getVariables();
+		const size_t varsSize = variables.size();
+		std::vector<LinearValue<T>> termsMins(varsSize);
+		std::vector<LinearValue<T>> termsMaxs(varsSize);
+		auto updateTermBounds = [&variables, &coefficients, &termsMins, &termsMaxs](size_t varPosition) -> bool
+		{
+			const Variable<T>& var = variables[varPosition];
+			LinearValue<T> coefficient = coefficients[varPosition];
+			if (var.isAssigned())
+			{
+				termsMins[varPosition] = termsMaxs[varPosition] = coefficient * static_cast<LinearValue<T>>(var.getValue());
+				return true;
+			}
+			const std::vector<T>& domain = var.getDomain();
+			if (domain.empty())
+			{
+				return false;
+			}
+			auto [minIt, maxIt] = std::minmax_element(domain.cbegin(), domain.cend());
+			LinearValue<T> minTerm = coefficient * static_cast<LinearValue<T>>(*minIt);
+			LinearValue<T> maxTerm = coefficient * static_cast<LinearValue<T>>(*maxIt);
+			termsMins[varPosition] = std::min(minTerm, maxTerm);
+			termsMaxs[varPosition] = std::max(minTerm, maxTerm);
+			return true;
+		};
+
+		LinearValue<T> sumMin = 0;
+		LinearValue<T> sumMax = 0;
+		for (size_t varPosition = 0; varPosition < varsSize; ++varPosition)
+		{
+			if (!updateTermBounds(varPosition))
+			{
+				return false;
+			}
+			sumMin += termsMins[varPosition];
+			sumMax += termsMaxs[varPosition];
+		}
+
+		const bool hasLowerBound = relation != LinearRelation::LESS_EQUAL;
+		const bool hasUpperBound = relation != LinearRelation::GREATER_EQUAL;
+		bool isRevised = true;
+		while (isRevised)
+		{
+			isRevised = false;
+			if ((hasLowerBound && sumMax < rightHandSide) || (hasUpperBound && rightHandSide < sumMin))
+			{
+				return false;
+			}
+
+			for (size_t varPosition = 0; varPosition < varsSize; ++varPosition)
+			{
+				Variable<T>& var = variables[varPosition];
+				LinearValue<T> coefficient = coefficients[varPosition];
+				if (var.isAssigned() || !coefficient)
+				{
+					continue;
+				}
+
+				LinearValue<T> termLowerBound = rightHandSide - (sumMax - termsMaxs[varPosition]);
+				LinearValue<T> termUpperBound = rightHandSide - (sumMin - termsMins[varPosition]);
+				bool isPruned = false;
+				const std::vector<T>& domain = var.getDomain();
+				for (size_t i = domain.size(); 0 < i; --i)
+				{
+					LinearValue<T> term = coefficient * static_cast<LinearValue<T>>(domain[i - 1]);
+					if ((hasLowerBound && term < termLowerBound) || (hasUpperBound && termUpperBound < term))
+					{
+						constraintProblem.removeFromDomainByIdx(var, i - 1);
+						isPruned = true;
+					}
+				}
+				if (!isPruned)
+				{
+					continue;
+				}
+
+				sumMin -= termsMins[varPosition];
+				sumMax -= termsMaxs[varPosition];
+				if (!updateTermBounds(varPosition))
+				{
+					return false;
+				}
+				sumMin += termsMins[varPosition];
+				sumMax += termsMaxs[varPosition];
+				prunedVarsIdxs.push_back(constraintProblem.getVariableIdx(var));
+				isRevised = true;
+			}
+		}
+		return true;
+	}
+
+	template <typename T>
+	static bool __boundsFilterLinearSum(ConstraintProblem<T>& constraintProblem, size_t constrIdx, std::vector<size_t>& prunedVarsIdxs)
+	{
+		const Constraint<T>& constraint = constraintProblem.getConstraint(constrIdx);
+		const AnyConstraintEvaluator<T>& anyConstraintEvaluator = constraint.getAnyConstraintEvaluator();
+		if (const LinearSum<T>* pLinearSum = std::get_if<LinearSum<T>>(&anyConstraintEvaluator))
+		{
+			return __boundsFilterLinearTerms<T>(constraintProblem, constraint, pLinearSum->coefficients, pLinearSum->relation,
+				pLinearSum->rightHandSide, prunedVarsIdxs);
+		}
+
+		const ExactLengthExactSum<T>& exactLengthExactSum = std::get<ExactLengthExactSum<T>>(anyConstraintEvaluator);
+		const std::vector<LinearValue<T>> unitCoefficients(constraint.getVariables().size(), 1);
+		return __boundsFilterLinearTerms<T>(constraintProblem, constraint, unitCoefficients, LinearRelation::EQUAL,
+			static_cast<LinearValue<T>>(exactLengthExactSum.targetSum), prunedVarsIdxs);
+	}
+
+	template <typename T>
+	bool linearSumBoundsPropagation(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+	{
+		static_assert(std::is_arithmetic_v<T>, "T must be arithmetic for linear constraints");
+		return __propagateToFixedPoint<T>(constraintProblem, assignedVariable, isLinearSumConstraint<T>, __boundsFilterLinearSum<T>) &&
+			forwardChecking<T>(constraintProblem, assignedVariable);
+	}
+
+	template <typename T>
+	bool globalConstraintsPropagation(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
+	{
+		auto isGlobalConstraint = [](const Constraint<T>& constraint) -> bool
+		{
+			return isAllDifferentConstraint<T>(constraint) || isLinearSumConstraint<T>(constraint);
+		};
+		auto filterGlobalConstraint = [](ConstraintProblem<T>& constraintProblem, size_t constrIdx, std::vector<size_t>& prunedVarsIdxs) -> bool
+		{
+			if (isAllDifferentConstraint<T>(constraintProblem.getConstraint(constrIdx)))
+			{
+				return __gacFilterAllDifferent<T>(constraintProblem, constrIdx, prunedVarsIdxs);
+			}
+			if constexpr (std::is_arithmetic_v<T>)
+			{
+				return __boundsFilterLinearSum<T>(constraintProblem, constrIdx, prunedVarsIdxs);
+			}
+			else
+			{
+				return true;
+			}
+		};
+		return __propagateToFixedPoint<T>(constraintProblem, assignedVariable, isGlobalConstraint, filterGlobalConstraint) &&
+			forwardChecking<T>(constraintProblem, assignedVariable);
+	}
+}
\ No newline at end of file
@@ -23,6 +23,6 @@ namespace csp
 	bool mac(ConstraintProblem<T>& constraintProblem, Variable<T>& assignedVariable)
 	{
 		std::unordered_set<VariableRefsPair<T>> arcs = __initArcsMAC<T>(constraintProblem, assignedVariable);
-		return ac3(constraintProblem, arcs);
+		return __ac3<T>(constraintProblem, arcs);
 	}
 }
\ No newline at end of file
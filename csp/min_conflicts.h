@@ -2,6 +2,7 @@
 
 #include "pch.h"
 #include "constraint_problem.h"
+#include "conflicts_tracker.h"
 
 
 template<typename T>
@@ -16,66 +17,6 @@ public:
 
 namespace csp
 {
-	template <typename T>
-	static Variable<T>& __getRandomConflictedVariable(ConstraintProblem<T>& constraintProblem,
-		std::optional<std::unordered_set<Ref<Variable<T>>>> optReadOnlyVars)
-	{
-		const std::vector<Ref<Variable<T>>>& variables = constraintProblem.getVariables();
-		std::unordered_set<Ref<Variable<T>>> conflictedVars;
-		conflictedVars.reserve(variables.size());
-		for (const Constraint<T>& constr : constraintProblem.getUnsatisfiedConstraints())
-		{
-			const std::vector<Ref<Variable<T>>>& constrVars = constr.getVariables();
-			conflictedVars.insert(constrVars.cbegin(), constrVars.cend());
-		}
-		if (optReadOnlyVars)
-		{
-			for (auto it = conflictedVars.begin(); it != conflictedVars.end(); )
-			{
-				if ((*optReadOnlyVars).count(*it))
-				{
-					it = conflictedVars.erase(it);
-				}
-				else
-				{
-					++it;
-				}
-			}
-		}
-
-		Variable<T>& var =
-			__selectElementRandomly<Ref<Variable<T>>, std::unordered_set<Ref<Variable<T>>>>(conflictedVars);
-		return var;
-	}
-
-	template <typename T>
-	static size_t __getMinConflictedAssignmentIdx(ConstraintProblem<T>& constraintProblem, Variable<T>& conflictedVar)
-	{
-		size_t minConflictsCount = std::numeric_limits<size_t>::max();
-		const std::vector<T>& conflictedVarDomain = conflictedVar.getDomain();
-
-		std::vector<size_t> minConflictingAssignmentIdxs;
-		for (size_t i = 0; i < conflictedVarDomain.size(); ++i)
-		{
-			conflictedVar.assignByIdx(i);
-			size_t conflictsCount = constraintProblem.getUnsatisfiedConstraintsSize();
-			if (conflictsCount < minConflictsCount)
-			{
-				minConflictsCount = conflictsCount;
-				minConflictingAssignmentIdxs.clear();
-				minConflictingAssignmentIdxs.push_back(i);
-			}
-			else if (conflictsCount == minConflictsCount)
-			{
-				minConflictingAssignmentIdxs.push_back(i);
-			}
-			conflictedVar.unassign();
-
-		}
-
-		return __selectElementRandomly<size_t, std::vector<size_t>>(minConflictingAssignmentIdxs);
-	}
-
 	template <typename T>
 	const AssignmentHistory<T> minConflicts(ConstraintProblem<T>& constraintProblem, unsigned int maxSteps,
 		std::optional<std::unordered_set<Ref<Variable<T>>>> optReadOnlyVars =
@@ -91,44 +32,52 @@ namespace csp
 			throw invalid_tabu_size_error<T>{};
 		}
 		
-		constraintProblem.assignVarsWithRandomValues(optReadOnlyVars, assignmentHistory);
+		constraintProblem.assignVarsWithRandomValues(optReadOnlyVars, writeAssignmentHistory ? &assignmentHistory : nullptr);
+		ConflictsTracker<T> conflictsTracker{ constraintProblem, optReadOnlyVars };
 
-		size_t bestMinConflicts = constraintProblem.getUnsatisfiedConstraintsSize();
-		Assignment<T> bestAssignment = const_cast<Assignment<T>&>(constraintProblem.getCurrentAssignment());
-		Assignment<T>* ptrBestAssignment = &(bestAssignment);
+		// instead of copying the best assignment on every improvement, the reassignments made since the best one
+		// are logged (variable idx, previous assignment idx) and undone at the end
+		size_t bestMinConflicts = conflictsTracker.getUnsatisfiedConstraintsSize();
+		std::vector<std::pair<size_t, size_t>> reassignmentsSinceBest;
 		for (unsigned int i = 0; i < maxSteps; ++i)
 		{
-			if (constraintProblem.isCompletelyConsistentlyAssigned())
+			if (!conflictsTracker.getUnsatisfiedConstraintsSize() || conflictsTracker.getConflictedVariablesIdxs().empty() ||
+				constraintProblem.isStopRequested())
 			{
-				return assignmentHistory;
+				break;
 			}
 
-			Variable<T>& conflictedVar = __getRandomConflictedVariable<T>(constraintProblem, optReadOnlyVars);
-			conflictedVar.unassign();
+			size_t conflictedVarIdx = conflictsTracker.selectRandomConflictedVariableIdx();
+			Variable<T>& conflictedVar = constraintProblem.getVariable(conflictedVarIdx);
 			if (writeAssignmentHistory)
 			{
 				assignmentHistory.emplace_back(conflictedVar, std::optional<T>{});
 			}
-			
-			size_t minConflictedAssignmentIdx = __getMinConflictedAssignmentIdx<T>(constraintProblem, conflictedVar);
-			conflictedVar.assignByIdx(minConflictedAssignmentIdx);
+
+			size_t prevAssignmentIdx = conflictedVar.getAssignmentIdx();
+			size_t minConflictedAssignmentIdx = conflictsTracker.selectMinConflictsAssignmentIdx(conflictedVarIdx);
+			conflictsTracker.reassign(conflictedVarIdx, minConflictedAssignmentIdx);
+			reassignmentsSinceBest.emplace_back(conflictedVarIdx, prevAssignmentIdx);
 			if (writeAssignmentHistory)
 			{
 				const std::vector<T>& domain = conflictedVar.getDomain();
 				assignmentHistory.emplace_back(conflictedVar, std::optional<T>{ domain[minConflictedAssignmentIdx] });
 			}
 
-			size_t currConflictsCount = constraintProblem.getUnsatisfiedConstraintsSize();
+			size_t currConflictsCount = conflictsTracker.getUnsatisfiedConstraintsSize();
 			if (currConflictsCount < bestMinConflicts)
 			{
 				bestMinConflicts = currConflictsCount;
-				const Assignment<T> currAssignment = constraintProblem.getCurrentAssignment();
-				*ptrBestAssignment = const_cast<Assignment<T>&>(currAssignment);
+				reassignmentsSinceBest.clear();
 			}
 		}
 
-		constraintProblem.unassignAllVariables();
-		constraintProblem.assignFromAssignment(*ptrBestAssignment);
+		for (auto it = reassignmentsSinceBest.crbegin(); it != reassignmentsSinceBest.crend(); ++it)
+		{
+			Variable<T>& var = constraintProblem.getVariable(it->first);
+			var.unassign();
+			var.assignByIdx(it->second);
+		}
 		return assignmentHistory;
 	}
 }
\ No newline at end of file
@@ -176,15 +176,15 @@ namespace csp
 		const std::vector<Ref<Variable<T>>> variables = constraintProblem.getUnassignedVariables();
 		const std::vector<Ref<Variable<T>>> vecReadOnlyVariables = constraintProblem.getAssignedVariables();
 		const std::unordered_set<Ref<Variable<T>>> readOnlyVariables{ vecReadOnlyVariables.cbegin(), vecReadOnlyVariables.cend() };
-		std::vector<Ref<Constraint<T>>>& constraints = 
-			const_cast<std::vector<Ref<Constraint<T>>>&>(constraintProblem.getConstraints());
+		// sorting a copy, since constraints indices of constraintProblem are positions in its constraints vector
+		std::vector<Ref<Constraint<T>>> constraints{ constraintProblem.getConstraints() };
 		std::sort(constraints.begin(), constraints.end(),
 			[] (const Constraint<T>& left, const Constraint<T>& right) -> bool
 			{
 				return left.getVariables().size() > right.getVariables().size();
 			}
 		);
-		const ConstraintGraph<T>& constraintGraph = constraintProblem.getConstraintGraph();
+		const std::vector<Ref<Variable<T>>>& problemVariables = constraintProblem.getVariables();
 
 		const auto constraintsItToBegin = constraints.cbegin();
 
@@ -201,18 +201,20 @@ namespace csp
 
 			ConstraintGraph<T> reducedGraph;
 			reducedGraph.reserve(variables.size());
-			for (const std::pair<Ref<Variable<T>>, std::vector<Ref<Variable<T>>>>& varToNeighbors : constraintGraph)
+			for (size_t varIdx = 0; varIdx < problemVariables.size(); ++varIdx)
 			{
-				Variable<T>& var = varToNeighbors.first;
+				Variable<T>& var = problemVariables[varIdx];
 				if (!cutSetVars.count(var))
 				{
-					reducedGraph.try_emplace(var, std::vector<Ref<Variable<T>>>{});
-					reducedGraph.at(var).reserve(constraintGraph.at(var).size());
-					for (Variable<T>& neighbor : varToNeighbors.second)
+					Span<const size_t> neighborsIdxs = constraintProblem.getNeighborsIdxs(varIdx);
+					std::vector<Ref<Variable<T>>>& reducedNeighbors = reducedGraph.try_emplace(var).first->second;
+					reducedNeighbors.reserve(neighborsIdxs.size());
+					for (size_t neighborIdx : neighborsIdxs)
 					{
+						Variable<T>& neighbor = constraintProblem.getVariable(neighborIdx);
 						if (!cutSetVars.count(neighbor))
 						{
-							reducedGraph.at(var).emplace_back(neighbor);
+							reducedNeighbors.emplace_back(neighbor);
 						}
 					}
 				}
@@ -232,12 +234,8 @@ namespace csp
 					}
 				}
 
-				std::unordered_map<Ref<Variable<T>>, std::vector<T>> nonCutSetVarsToOriginalDomains;
-				for (Variable<T>& var : nonCutsetVars)
-				{
-					nonCutSetVarsToOriginalDomains.emplace(var, var.getDomain());
-				}
-
+				// domain removals made for each cutset assignment are undone by restoring this trail mark
+				const size_t trailMark = constraintProblem.getTrailMark();
 				for (const std::vector<T>& consistentAssignmentValues : allCosistentAssignmentsValues)
 				{
 					std::vector<std::pair<Ref<Variable<T>>, T>> vecVarToValue;
@@ -263,7 +261,7 @@ namespace csp
 					{
 						if (!readOnlyVariables.count(nonCutSetVariable))
 						{
-							nonCutSetVariable.setSubsetDomain(constraintProblem.getConsistentDomain(nonCutSetVariable));
+							constraintProblem.setSubsetDomain(nonCutSetVariable, constraintProblem.getConsistentDomain(nonCutSetVariable));
 						}
 					}
 
@@ -312,13 +310,7 @@ namespace csp
 						}
 					}
 
-					for (const std::pair<Ref<Variable<T>>, std::vector<T>>& varToOriginalDomain : nonCutSetVarsToOriginalDomains)
-					{
-						if (!readOnlyVariables.count(varToOriginalDomain.first))
-						{
-							varToOriginalDomain.first.get().setDomain(varToOriginalDomain.second);
-						}
-					}
+					constraintProblem.restoreTrail(trailMark);
 				}
 
 			}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+#include "heuristic_backtracking.h"
+
+/*
+Parallel enumeration of all the solutions by work-stealing backtracking.
+The search tree is split at a shallow depth into subproblems: prefixes of assignments, chosen by the same selectors, domain sorter
+and inference as the search itself, and deepened until there are about SUBPROBLEMS_PER_WORKER subproblems per worker.
+Each worker owns a deep copy of the constraint problem and a deque of subproblems. A worker replays a subproblem's prefix on
+its copy and enumerates the subtree below it, taking subproblems from the back of its own deque, and once that is empty,
+stealing from the front of the other workers' deques. Solutions are gathered per worker and merged at the end.
+Each worker runs its own copies of the selectors, domain sorter and inference, since callables such as ArcConsistency3rm,
+GeneralizedArcConsistency and LeastConstrainingValueBySupports keep mutable state inside themselves. Heuristics whose copies
+share state, like the adaptive selectors (WeightedDegree, Activity, Impact), would still race, hence they are not supported here.
+If a worker throws, the other workers stop, and the first exception caught is rethrown once all of them are joined.
+*/
+
+namespace csp
+{
+	constexpr size_t SUBPROBLEMS_PER_WORKER = 16;
+
+	template <typename T>
+	using AssignmentsPrefix = std::vector<std::pair<size_t, T>>;	// variable idx, value
+
+	template <typename T>
+	static void __splitSearchTree(ConstraintProblem<T>& constraintProblem,
+		const PrimarySelector<T>& primarySelector,
+		const SecondarySelector<T>& secondarySelector,
+		const std::optional<DomainSorter<T>>& optDomainSorter,
+		const std::optional<Inference<T>>& optInference,
+		size_t depth,
+		AssignmentsPrefix<T>& prefix,
+		std::vector<AssignmentsPrefix<T>>& prefixes)
+	{
+		if (!depth || constraintProblem.isCompletelyAssigned())
+		{
+			prefixes.push_back(prefix);
+			return;
+		}
+
+		const std::vector<Ref<Variable<T>>> candidateVars = primarySelector(constraintProblem);
+		Variable<T>& selectedVar = candidateVars.size() == 1 ? candidateVars[0].get() : secondarySelector(constraintProblem, candidateVars);
+		const size_t selectedVarIdx = constraintProblem.getVariableIdx(selectedVar);
+
+		const std::vector<T> sortedDomain = optDomainSorter ? (*optDomainSorter)(constraintProblem, selectedVar) : selectedVar.getDomain();
+		for (T value : sortedDomain)
+		{
+			selectedVar.assignByValue(value);
+			const size_t trailMark = constraintProblem.getTrailMark();
+			if (!optInference || (*optInference)(constraintProblem, selectedVar))
+			{
+				prefix.emplace_back(selectedVarIdx, value);
+				__splitSearchTree<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter, optInference, depth - 1,
+					prefix, prefixes);
+				prefix.pop_back();
+			}
+			constraintProblem.restoreTrail(trailMark);
+			selectedVar.unassign();
+		}
+	}
+
+	template <typename T>
+	static bool __replayAssignmentsPrefix(ConstraintProblem<T>& constraintProblem, const std::optional<Inference<T>>& optInference,
+		const AssignmentsPrefix<T>& prefix)
+	{
+		for (const auto& [varIdx, value] : prefix)
+		{
+			Variable<T>& var = constraintProblem.getVariable(varIdx);
+			var.assignByValue(value);
+			if (optInference && !((*optInference)(constraintProblem, var)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	struct __SubproblemsDeque
+	{
+		std::mutex mutex;
+		std::deque<size_t> subproblemsIdxs;
+	};
+
+	// pops from the back of the worker's own deque, or else steals from the front of another worker's deque
+	static std::optional<size_t> __takeSubproblem(std::vector<__SubproblemsDeque>& subproblemsDeques, size_t workerIdx)
+	{
+		{
+			__SubproblemsDeque& ownDeque = subproblemsDeques[workerIdx];
+			std::lock_guard<std::mutex> lock{ ownDeque.mutex };
+			if (!ownDeque.subproblemsIdxs.empty())
+			{
+				size_t subproblemIdx = ownDeque.subproblemsIdxs.back();
+				ownDeque.subproblemsIdxs.pop_back();
+				return subproblemIdx;
+			}
+		}
+
+		for (size_t i = 1; i < subproblemsDeques.size(); ++i)
+		{
+			__SubproblemsDeque& victimDeque = subproblemsDeques[(workerIdx + i) % subproblemsDeques.size()];
+			std::lock_guard<std::mutex> lock{ victimDeque.mutex };
+			if (!victimDeque.subproblemsIdxs.empty())
+			{
+				size_t subproblemIdx = victimDeque.subproblemsIdxs.front();
+				victimDeque.subproblemsIdxs.pop_front();
+				return subproblemIdx;
+			}
+		}
+		// subproblems are only created before the workers start, hence all the deques are empty for good
+		return std::optional<size_t>{};
+	}
+
+	template <typename T>
+	const std::unordered_set<Assignment<T>> parallelHeuristicBacktrackingSolver_findAllSolutions(ConstraintProblem<T>& constraintProblem,
+		const PrimarySelector<T>& primarySelector,
+		const SecondarySelector<T>& secondarySelector = chooseFirstCandidateVar_secondarySelector<T>,
+		const std::optional<DomainSorter<T>>& optDomainSorter = std::optional<DomainSorter<T>>{},
+		const std::optional<Inference<T>> optInference = std::optional<Inference<T>>{},
+		unsigned int threadsAmount = std::thread::hardware_concurrency())
+	{
+		// the workers steal subproblems, which are split until there are enough of them for all the workers
+		const size_t workersAmount = __getWorkersAmount(threadsAmount, std::numeric_limits<size_t>::max());
+
+		std::vector<AssignmentsPrefix<T>> prefixes;
+		const size_t trailMark = constraintProblem.getTrailMark();
+		const size_t unassignedVarsSize = constraintProblem.getUnassignedVariablesSize();
+		for (size_t depth = 1; ; ++depth)
+		{
+			prefixes.clear();
+			AssignmentsPrefix<T> prefix;
+			__splitSearchTree<T>(constraintProblem, primarySelector, secondarySelector, optDomainSorter, optInference, depth, prefix,
+				prefixes);
+			if (workersAmount * SUBPROBLEMS_PER_WORKER <= prefixes.size() || unassignedVarsSize <= depth)
+			{
+				break;
+			}
+		}
+		constraintProblem.restoreTrail(trailMark);
+
+		std::vector<std::vector<Variable<T>>> copiedVars;
+		std::vector<std::vector<Constraint<T>>> copiedConstraints;
+		std::vector<ConstraintProblem<T>> copiedProblems = __deepCopyProblems(constraintProblem, workersAmount, copiedVars,
+			copiedConstraints);
+		std::vector<__SubproblemsDeque> subproblemsDeques(workersAmount);
+		std::atomic<bool> stopFlag{ false };
+		for (ConstraintProblem<T>& copiedProblem : copiedProblems)
+		{
+			copiedProblem.setStopFlag(&stopFlag);
+		}
+		for (size_t subproblemIdx = 0; subproblemIdx < prefixes.size(); ++subproblemIdx)
+		{
+			subproblemsDeques[subproblemIdx % workersAmount].subproblemsIdxs.push_back(subproblemIdx);
+		}
+
+		std::vector<std::vector<std::vector<VariableValuePair<T>>>> workersSolutionsValues(workersAmount);
+		std::vector<std::exception_ptr> workersExceptions(workersAmount);
+		auto enumerateSubproblems = [&](size_t workerIdx) -> void
+		{
+			ConstraintProblem<T>& copiedProblem = copiedProblems[workerIdx];
+			std::vector<std::vector<VariableValuePair<T>>>& solutionsValues = workersSolutionsValues[workerIdx];
+			auto insertSolutionValues = [&solutionsValues](const ConstraintProblem<T>& solvedProblem) -> void
+			{
+				solutionsValues.emplace_back(__getSolutionValues<T>(solvedProblem));
+			};
+			try
+			{
+				const PrimarySelector<T> workerPrimarySelector{ primarySelector };
+				const SecondarySelector<T> workerSecondarySelector{ secondarySelector };
+				const std::optional<DomainSorter<T>> workerOptDomainSorter{ optDomainSorter };
+				const std::optional<Inference<T>> workerOptInference{ optInference };
+				for (std::optional<size_t> optSubproblemIdx = __takeSubproblem(subproblemsDeques, workerIdx);
+					optSubproblemIdx && !stopFlag.load(); optSubproblemIdx = __takeSubproblem(subproblemsDeques, workerIdx))
+				{
+					const AssignmentsPrefix<T>& prefix = prefixes[*optSubproblemIdx];
+					const size_t subproblemTrailMark = copiedProblem.getTrailMark();
+					if (__replayAssignmentsPrefix<T>(copiedProblem, workerOptInference, prefix))
+					{
+						__heuristicBacktrackingSolver_visitAllSolutions<T>(copiedProblem, workerPrimarySelector, workerSecondarySelector,
+							workerOptDomainSorter, workerOptInference, insertSolutionValues);
+					}
+					copiedProblem.restoreTrail(subproblemTrailMark);
+					for (const auto& [varIdx, value] : prefix)
+					{
+						copiedProblem.getVariable(varIdx).unassign();
+					}
+				}
+			}
+			catch (...)
+			{
+				workersExceptions[workerIdx] = std::current_exception();
+				stopFlag.store(true);
+			}
+		};
+
+		__runWorkers(workersAmount, enumerateSubproblems);
+		__rethrowFirstWorkerException(workersExceptions);
+
+		// a solution's values are in the order of getVariables(), that is by variable idx, which deepCopy() preserves
+		const std::vector<Ref<Variable<T>>>& variables = constraintProblem.getVariables();
+		std::unordered_set<Assignment<T>> solutions;
+		for (const std::vector<std::vector<VariableValuePair<T>>>& solutionsValues : workersSolutionsValues)
+		{
+			for (const std::vector<VariableValuePair<T>>& solutionValues : solutionsValues)
+			{
+				Assignment<T> solution;
+				solution.reserve(solutionValues.size());
+				for (size_t varIdx = 0; varIdx < solutionValues.size(); ++varIdx)
+				{
+					Variable<T>& var = variables[varIdx];
+					solution.emplace(var, var.getAssignmentIdxOfValue(solutionValues[varIdx].second));
+				}
+				solutions.emplace(std::move(solution));
+			}
+		}
+		return solutions;
+	}
+
+	// parallel counterpart of backtrackingSolver_findAllSolutions, which selects the last unassigned variable and neither sorts nor infers
+	template <typename T>
+	const std::unordered_set<Assignment<T>> parallelBacktrackingSolver_findAllSolutions(ConstraintProblem<T>& constraintProblem,
+		unsigned int threadsAmount = std::thread::hardware_concurrency())
+	{
+		PrimarySelector<T> selectLastUnassignedVariable = [](ConstraintProblem<T>& constraintProblem) -> std::vector<Ref<Variable<T>>>
+		{
+			Span<const size_t> unassignedVarsIdxs = constraintProblem.getUnassignedVariablesIdxs();
+			return { constraintProblem.getVariable(*std::max_element(unassignedVarsIdxs.begin(), unassignedVarsIdxs.end())) };
+		};
+		return parallelHeuristicBacktrackingSolver_findAllSolutions<T>(constraintProblem, selectLastUnassignedVariable,
+			chooseFirstCandidateVar_secondarySelector<T>, std::optional<DomainSorter<T>>{}, std::optional<Inference<T>>{}, threadsAmount);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+#include "hill_climbing.h"
+
+/*
+Parallel random-restart first-choice hill climbing. Restarts are independent, hence a pool of workers takes them by index from
+a shared counter, and each worker climbs on its own deep copy of the constraint problem.
+Restart r draws from an engine seeded by (seed, r) only, so a seed replays the same climbs whatever the amount of threads.
+The workers share the best score found, below which a climb does not check its problem for being solved, and the index of the
+first restart which solved it: later restarts stop, while earlier ones run to their end. Thus the returned assignment is that of
+the first solving restart, or else of the first restart reaching the best score, whatever the timing of the threads.
+If a restart throws, the other restarts stop, and the first exception caught is rethrown once all the workers are joined.
+*/
+
+namespace csp
+{
+	template <typename T>
+	ConstraintProblem<T> parallelRandomRestartFirstChoiceHillClimbing(ConstraintProblem<T>& constraintProblem,
+		std::vector<Constraint<T>>& bestConstraints, std::vector<Variable<T>>& bestVars,
+		unsigned int maxRestarts, unsigned int maxSteps, unsigned int maxSuccessors,
+		const StartStateGenarator<T>& generateStartState = generateStartStateRandomly<T>,
+		const SuccessorGenerator<T>& generateSuccessor = alterRandomVariableValuePair<T>,
+		const ScoreCalculator<T>& calculateScore = consistentConstraintsAmount<T>,
+		const ScoreDeltaCalculator<T>& calculateScoreDelta = ScoreDeltaCalculator<T>{ },
+		unsigned int seed = std::random_device{}(),
+		unsigned int threadsAmount = std::thread::hardware_concurrency())
+	{
+		const ScoreDeltaCalculator<T> calculateSuccessorScoreDelta = calculateScoreDelta ? calculateScoreDelta :
+			getScoreDeltaCalculator(calculateScore);
+		maxRestarts = std::max(maxRestarts, 1U);
+		const size_t workersAmount = __getWorkersAmount(threadsAmount, maxRestarts);
+
+		ConstraintProblem<T> problem = constraintProblem.deepCopy(bestVars, bestConstraints);
+		std::vector<std::vector<Variable<T>>> copiedVars;
+		std::vector<std::vector<Constraint<T>>> copiedConstraints;
+		std::vector<ConstraintProblem<T>> copiedProblems = __deepCopyProblems(constraintProblem, workersAmount, copiedVars,
+			copiedConstraints);
+
+		struct RestartResult
+		{
+			bool isSolved;
+			unsigned int score;
+			size_t restartIdx;
+			std::vector<size_t> assignmentIdxs;
+		};
+		// solving restarts by ascending index, then the others by descending score and ascending index
+		auto isBetterRestart = [](const RestartResult& restartResult, const RestartResult& otherRestartResult) -> bool
+		{
+			if (restartResult.isSolved != otherRestartResult.isSolved)
+			{
+				return restartResult.isSolved;
+			}
+			if (!restartResult.isSolved && restartResult.score != otherRestartResult.score)
+			{
+				return otherRestartResult.score < restartResult.score;
+			}
+			return restartResult.restartIdx < otherRestartResult.restartIdx;
+		};
+
+		std::vector<RestartResult> workersBestResults(workersAmount, RestartResult{ false, 0, UNASSIGNED, std::vector<size_t>{ } });
+		std::atomic<unsigned int> sharedBestScore{ 0 };
+		std::atomic<size_t> solvingRestartIdx{ UNASSIGNED };
+		std::atomic<size_t> nextRestartIdx{ 0 };
+		std::atomic<bool> hasWorkerFailed{ false };
+		std::vector<std::exception_ptr> workersExceptions(workersAmount);
+		auto runRestarts = [&](size_t workerIdx) -> void
+		{
+			ConstraintProblem<T>& copiedProblem = copiedProblems[workerIdx];
+			RestartResult& bestResult = workersBestResults[workerIdx];
+			std::default_random_engine defaultRandomEngine;
+			for (size_t restartIdx = nextRestartIdx++; restartIdx < maxRestarts; restartIdx = nextRestartIdx++)
+			{
+				const std::function<bool()> isStopRequested = [&constraintProblem, &solvingRestartIdx, &hasWorkerFailed, restartIdx]() -> bool
+				{
+					return solvingRestartIdx.load() < restartIdx || hasWorkerFailed.load() || constraintProblem.isStopRequested();
+				};
+				if (isStopRequested())
+				{
+					return;
+				}
+
+				std::seed_seq seedSequence{ seed, static_cast<unsigned int>(restartIdx) };
+				defaultRandomEngine.seed(seedSequence);
+				generateStartState(copiedProblem, defaultRandomEngine);
+				bool isSolved = false;
+				unsigned int currScore = __climbFirstChoice(copiedProblem, calculateScore(copiedProblem), sharedBestScore.load(),
+					isSolved, defaultRandomEngine, maxSteps, maxSuccessors, generateSuccessor, calculateScore, calculateSuccessorScoreDelta,
+					isStopRequested);
+				// the climb checks for a solution before its moves, not after its last one
+				if (!isSolved && sharedBestScore.load() <= currScore)
+				{
+					isSolved = copiedProblem.isCompletelyConsistentlyAssigned();
+				}
+
+				RestartResult restartResult{ isSolved, currScore, restartIdx, std::vector<size_t>{ } };
+				if (isBetterRestart(restartResult, bestResult))
+				{
+					__writeAssignmentIdxs<T>(copiedProblem, restartResult.assignmentIdxs);
+					bestResult = std::move(restartResult);
+				}
+				for (unsigned int bestScore = sharedBestScore.load();
+					bestScore < currScore && !sharedBestScore.compare_exchange_weak(bestScore, currScore); )
+				{ }
+				if (isSolved)
+				{
+					for (size_t solvingIdx = solvingRestartIdx.load();
+						restartIdx < solvingIdx && !solvingRestartIdx.compare_exchange_weak(solvingIdx, restartIdx); )
+					{ }
+					return;
+				}
+			}
+		};
+		auto tryRunRestarts = [&](size_t workerIdx) -> void
+		{
+			try
+			{
+				runRestarts(workerIdx);
+			}
+			catch (...)
+			{
+				workersExceptions[workerIdx] = std::current_exception();
+				hasWorkerFailed.store(true);
+			}
+		};
+
+		__runWorkers(workersAmount, tryRunRestarts);
+		__rethrowFirstWorkerException(workersExceptions);
+
+		size_t bestWorkerIdx = 0;
+		for (size_t workerIdx = 1; workerIdx < workersAmount; ++workerIdx)
+		{
+			if (isBetterRestart(workersBestResults[workerIdx], workersBestResults[bestWorkerIdx]))
+			{
+				bestWorkerIdx = workerIdx;
+			}
+		}
+		// no restart ran if a stop was requested before the workers started
+		if (workersBestResults[bestWorkerIdx].restartIdx != UNASSIGNED)
+		{
+			__assignFromAssignmentIdxs<T>(problem, workersBestResults[bestWorkerIdx].assignmentIdxs);
+		}
+		return problem;
+	}
+}
\ No newline at end of file
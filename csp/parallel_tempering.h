@@ -0,0 +1,334 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+#include "start_state_genarators.h"
+#include "score_calculators.h"
+#include "successor_generators.h"
+#include "simulated_annealing.h"
+
+/*
+Parallel tempering (replica exchange simulated annealing): replicasAmount replicas of the problem, each on its own deep copy,
+anneal concurrently at the temperatures of a ladder, geometric from minTemperature to maxTemperature.
+The replicas run in epochs of swapInterval steps. Between epochs, replicas at adjacent temperatures exchange their temperatures
+(equivalently, their configurations) with probability min(1, exp((score_j - score_i) * (1 / t_i - 1 / t_j))), alternately for the
+even and for the odd pairs of the ladder, and then every temperature is updated by the cooling schedule.
+Hot replicas cross the barriers between local optima, and good configurations found by them percolate down to the cold replicas,
+which refine them. Each replica is annealed by one worker thread at a time, so replicas scale up to threadsAmount cores.
+The workers persist across the epochs, waiting for the next epoch between them, so short epochs cost no thread start-up.
+An exception thrown by any replica's callbacks stops the others, and is rethrown once all the workers have finished.
+*/
+
+namespace csp
+{
+	template<typename T> class invalid_temperatures_error;
+
+	// what a cooling schedule knows of a temperature of the ladder, at the end of an epoch
+	struct CoolingState
+	{
+		double initialTemperature;
+		double temperature;
+		double acceptanceRate;		// of the moves proposed at this temperature during the epoch
+		unsigned int stagnantEpochs;	// since the best score found by any replica last improved
+	};
+
+	// returns the temperature of the next epoch
+	using CoolingSchedule = std::function<double(const CoolingState& coolingState)>;
+
+	// coolingRate of 1 keeps the ladder fixed, as in classic parallel tempering
+	inline CoolingSchedule geometricCooling(double coolingRate)
+	{
+		return [coolingRate](const CoolingState& coolingState) -> double
+		{
+			return coolingState.temperature * coolingRate;
+		};
+	}
+
+	// cools by coolingRate at targetAcceptanceRate, faster while more moves are accepted and slower while less are
+	inline CoolingSchedule adaptiveCooling(double coolingRate, double targetAcceptanceRate)
+	{
+		return [coolingRate, targetAcceptanceRate](const CoolingState& coolingState) -> double
+		{
+			return coolingState.temperature * std::pow(coolingRate, coolingState.acceptanceRate / targetAcceptanceRate);
+		};
+	}
+
+	// cools by coolingRate, and reheats to the initial temperature after every maxStagnantEpochs epochs without improvement
+	inline CoolingSchedule reheatingCooling(double coolingRate, unsigned int maxStagnantEpochs)
+	{
+		return [coolingRate, maxStagnantEpochs](const CoolingState& coolingState) -> double
+		{
+			if (coolingState.stagnantEpochs && !(coolingState.stagnantEpochs % maxStagnantEpochs))
+			{
+				return coolingState.initialTemperature;
+			}
+			return coolingState.temperature * coolingRate;
+		};
+	}
+
+	/*
+	Returns a deep copy of constraintProblem (into bestVars and bestConstraints) assigned with the best assignment found by any
+	replica. maxSteps bounds the steps of each replica. Once a replica solves its copy, the others stop at their next step.
+	Requires 0 < minTemperature <= maxTemperature.
+	The replicas' moves are those of simulatedAnnealing, and so are the meanings of the start state, successor and score arguments.
+	*/
+	template <typename T>
+	ConstraintProblem<T> parallelTempering(ConstraintProblem<T>& constraintProblem,
+		std::vector<Constraint<T>>& bestConstraints, std::vector<Variable<T>>& bestVars,
+		unsigned int maxSteps, unsigned int replicasAmount, double minTemperature, double maxTemperature,
+		unsigned int swapInterval, const CoolingSchedule& coolTemperature = geometricCooling(1.0),
+		const StartStateGenarator<T>& generateStartState = generateStartStateRandomly<T>,
+		const SuccessorGenerator<T>& generateSuccessor = alterRandomVariableValuePair<T>,
+		const ScoreCalculator<T>& calculateScore = consistentConstraintsAmount<T>,
+		const ScoreDeltaCalculator<T>& calculateScoreDelta = ScoreDeltaCalculator<T>{ },
+		unsigned int threadsAmount = std::thread::hardware_concurrency())
+	{
+		// also rejects NaN temperatures
+		if (!(0 < minTemperature && minTemperature <= maxTemperature))
+		{
+			throw invalid_temperatures_error<T>{ minTemperature, maxTemperature };
+		}
+
+		const ScoreDeltaCalculator<T> calculateSuccessorScoreDelta = calculateScoreDelta ? calculateScoreDelta :
+			getScoreDeltaCalculator(calculateScore);
+		ConstraintProblem<T> problem = constraintProblem.deepCopy(bestVars, bestConstraints);
+		replicasAmount = std::max(replicasAmount, 1U);
+		swapInterval = std::max(swapInterval, 1U);
+		const size_t workersAmount = __getWorkersAmount(threadsAmount, replicasAmount);
+
+		std::vector<double> initialTemperatures(replicasAmount, minTemperature);
+		for (size_t rung = 1; rung < replicasAmount; ++rung)
+		{
+			initialTemperatures[rung] = minTemperature *
+				std::pow(maxTemperature / minTemperature, static_cast<double>(rung) / (replicasAmount - 1));
+		}
+		std::vector<double> temperatures = initialTemperatures;
+		std::vector<size_t> rungsReplicasIdxs(replicasAmount);
+		std::iota(rungsReplicasIdxs.begin(), rungsReplicasIdxs.end(), 0);
+		std::vector<size_t> replicasRungs = rungsReplicasIdxs;
+
+		std::random_device randomDevice;
+		std::default_random_engine swapsRandomEngine{ randomDevice() };
+		std::vector<std::vector<Variable<T>>> copiedVars;
+		std::vector<std::vector<Constraint<T>>> copiedConstraints;
+		std::vector<ConstraintProblem<T>> copiedProblems = __deepCopyProblems(constraintProblem, replicasAmount, copiedVars,
+			copiedConstraints);
+		std::vector<std::default_random_engine> replicasRandomEngines;
+		replicasRandomEngines.reserve(replicasAmount);
+		std::vector<unsigned int> currScores(replicasAmount);
+		std::vector<unsigned int> bestScores(replicasAmount);
+		std::vector<std::vector<size_t>> bestAssignmentsIdxs(replicasAmount);
+		std::vector<unsigned int> acceptedMovesSizes(replicasAmount);
+		std::vector<unsigned int> proposedMovesSizes(replicasAmount);
+		for (size_t replicaIdx = 0; replicaIdx < replicasAmount; ++replicaIdx)
+		{
+			replicasRandomEngines.emplace_back(randomDevice());
+			ConstraintProblem<T>& copiedProblem = copiedProblems[replicaIdx];
+			generateStartState(copiedProblem, replicasRandomEngines.back());
+			__writeAssignmentIdxs<T>(copiedProblem, bestAssignmentsIdxs[replicaIdx]);
+			if (copiedProblem.isCompletelyConsistentlyAssigned())
+			{
+				__assignFromAssignmentIdxs<T>(problem, bestAssignmentsIdxs[replicaIdx]);
+				return problem;
+			}
+			currScores[replicaIdx] = bestScores[replicaIdx] = calculateScore(copiedProblem);
+		}
+
+		std::atomic<size_t> solvingReplicaIdx{ UNASSIGNED };
+		std::atomic<bool> hasWorkerFailed{ false };
+		auto isStopRequested = [&]() -> bool
+		{
+			return solvingReplicaIdx.load() != UNASSIGNED || hasWorkerFailed.load() || constraintProblem.isStopRequested();
+		};
+		auto runReplicasEpoch = [&](size_t workerIdx, unsigned int epochSteps) -> void
+		{
+			for (size_t replicaIdx = workerIdx; replicaIdx < replicasAmount; replicaIdx += workersAmount)
+			{
+				ConstraintProblem<T>& copiedProblem = copiedProblems[replicaIdx];
+				const double temperature = temperatures[replicasRungs[replicaIdx]];
+				acceptedMovesSizes[replicaIdx] = proposedMovesSizes[replicaIdx] = 0;
+				for (unsigned int i = 0; i < epochSteps && !isStopRequested(); ++i)
+				{
+					++proposedMovesSizes[replicaIdx];
+					if (!__makeAnnealingMove(copiedProblem, currScores[replicaIdx], temperature, replicasRandomEngines[replicaIdx],
+						generateSuccessor, calculateScore, calculateSuccessorScoreDelta))
+					{
+						continue;
+					}
+					++acceptedMovesSizes[replicaIdx];
+					if (currScores[replicaIdx] < bestScores[replicaIdx])
+					{
+						continue;
+					}
+
+					const bool isSolved = copiedProblem.isCompletelyConsistentlyAssigned();
+					if (bestScores[replicaIdx] < currScores[replicaIdx] || isSolved)
+					{
+						bestScores[replicaIdx] = currScores[replicaIdx];
+						__writeAssignmentIdxs<T>(copiedProblem, bestAssignmentsIdxs[replicaIdx]);
+					}
+					if (isSolved)
+					{
+						size_t noSolvingReplicaIdx = UNASSIGNED;
+						solvingReplicaIdx.compare_exchange_strong(noSolvingReplicaIdx, replicaIdx);
+						return;
+					}
+				}
+			}
+		};
+
+		// the calling thread is worker 0, and the other workers wait between the epochs for the next one
+		std::vector<std::exception_ptr> workersExceptions(workersAmount);
+		std::mutex epochMutex;
+		std::condition_variable epochStartCondition;
+		std::condition_variable epochEndCondition;
+		unsigned int epochSteps = 0;
+		size_t startedEpochsAmount = 0;
+		size_t finishedWorkersAmount = 0;
+		bool areEpochsOver = false;
+		auto tryRunReplicasEpoch = [&](size_t workerIdx, unsigned int currEpochSteps) -> void
+		{
+			try
+			{
+				runReplicasEpoch(workerIdx, currEpochSteps);
+			}
+			catch (...)
+			{
+				workersExceptions[workerIdx] = std::current_exception();
+				hasWorkerFailed = true;
+			}
+		};
+		auto runWorker = [&](size_t workerIdx) -> void
+		{
+			for (size_t runEpochsAmount = 0; ; ++runEpochsAmount)
+			{
+				unsigned int currEpochSteps;
+				{
+					std::unique_lock<std::mutex> epochLock{ epochMutex };
+					epochStartCondition.wait(epochLock, [&]() -> bool
+						{
+							return areEpochsOver || runEpochsAmount < startedEpochsAmount;
+						});
+					if (areEpochsOver)
+					{
+						return;
+					}
+					currEpochSteps = epochSteps;
+				}
+				tryRunReplicasEpoch(workerIdx, currEpochSteps);
+				{
+					std::lock_guard<std::mutex> epochLock{ epochMutex };
+					++finishedWorkersAmount;
+				}
+				epochEndCondition.notify_one();
+			}
+		};
+		auto runEpoch = [&](unsigned int currEpochSteps) -> void
+		{
+			{
+				std::lock_guard<std::mutex> epochLock{ epochMutex };
+				epochSteps = currEpochSteps;
+				finishedWorkersAmount = 0;
+				++startedEpochsAmount;
+			}
+			epochStartCondition.notify_all();
+			tryRunReplicasEpoch(0, currEpochSteps);
+			std::unique_lock<std::mutex> epochLock{ epochMutex };
+			epochEndCondition.wait(epochLock, [&]() -> bool { return finishedWorkersAmount == workersAmount - 1; });
+		};
+		auto stopWorkers = [&](std::vector<std::thread>& workers) -> void
+		{
+			{
+				std::lock_guard<std::mutex> epochLock{ epochMutex };
+				areEpochsOver = true;
+			}
+			epochStartCondition.notify_all();
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		workers.reserve(workersAmount - 1);
+		try
+		{
+			for (size_t workerIdx = 1; workerIdx < workersAmount; ++workerIdx)
+			{
+				workers.emplace_back(runWorker, workerIdx);
+			}
+		}
+		catch (...)
+		{
+			stopWorkers(workers);
+			throw;
+		}
+
+		unsigned int bestScore = *std::max_element(bestScores.cbegin(), bestScores.cend());
+		unsigned int stagnantEpochs = 0;
+		std::vector<double> acceptanceRates(replicasAmount);
+		std::uniform_real_distribution<double> zeroToOneDistribution(0.0, 1.0);
+		try
+		{
+			for (unsigned int epoch = 0, steps = 0; steps < maxSteps && !isStopRequested(); ++epoch, steps += swapInterval)
+			{
+				runEpoch(std::min(swapInterval, maxSteps - steps));
+
+				const unsigned int epochBestScore = *std::max_element(bestScores.cbegin(), bestScores.cend());
+				stagnantEpochs = bestScore < epochBestScore ? 0 : stagnantEpochs + 1;
+				bestScore = std::max(bestScore, epochBestScore);
+				for (size_t rung = 0; rung < replicasAmount; ++rung)
+				{
+					const size_t replicaIdx = rungsReplicasIdxs[rung];
+					acceptanceRates[rung] = proposedMovesSizes[replicaIdx] ?
+						static_cast<double>(acceptedMovesSizes[replicaIdx]) / proposedMovesSizes[replicaIdx] : 0.0;
+				}
+
+				for (size_t rung = epoch % 2; rung + 1 < replicasAmount; rung += 2)
+				{
+					size_t& coldReplicaIdx = rungsReplicasIdxs[rung];
+					size_t& hotReplicaIdx = rungsReplicasIdxs[rung + 1];
+					double logSwapProbability = (static_cast<double>(currScores[hotReplicaIdx]) - currScores[coldReplicaIdx]) *
+						(1.0 / temperatures[rung] - 1.0 / temperatures[rung + 1]);
+					if (0 <= logSwapProbability || zeroToOneDistribution(swapsRandomEngine) < std::exp(logSwapProbability))
+					{
+						std::swap(coldReplicaIdx, hotReplicaIdx);
+						replicasRungs[coldReplicaIdx] = rung;
+						replicasRungs[hotReplicaIdx] = rung + 1;
+					}
+				}
+
+				for (size_t rung = 0; rung < replicasAmount; ++rung)
+				{
+					temperatures[rung] = coolTemperature(CoolingState{ initialTemperatures[rung], temperatures[rung],
+						acceptanceRates[rung], stagnantEpochs });
+				}
+			}
+		}
+		catch (...)
+		{
+			workersExceptions.front() = std::current_exception();
+		}
+		stopWorkers(workers);
+		__rethrowFirstWorkerException(workersExceptions);
+
+		size_t bestReplicaIdx = solvingReplicaIdx.load();
+		if (bestReplicaIdx == UNASSIGNED)
+		{
+			bestReplicaIdx = std::max_element(bestScores.cbegin(), bestScores.cend()) - bestScores.cbegin();
+		}
+		__assignFromAssignmentIdxs<T>(problem, bestAssignmentsIdxs[bestReplicaIdx]);
+		return problem;
+	}
+
+
+	template<typename T>
+	class invalid_temperatures_error : public std::invalid_argument
+	{
+	public:
+		invalid_temperatures_error(double minTemperature, double maxTemperature) :
+			invalid_argument{ "parallelTempering requires 0 < minTemperature <= maxTemperature, but minTemperature is " +
+				std::to_string(minTemperature) + " and maxTemperature is " + std::to_string(maxTemperature) + "." }
+		{ }
+	};
+}
\ No newline at end of file
@@ -56,7 +56,7 @@ namespace csp
 					neighbor.assignByIdx(j);
 				}
 
-				if (!constraintProblem.getConsistentDomain(diffVar).empty())
+				if (!constraintProblem.isConsistentDomainEmpty(diffVar))
 				{
 					consistentNeighborValues.emplace_back(neighborDomain[j]);
 				}
@@ -79,8 +79,8 @@ namespace csp
 
 			if (currRevised)
 			{
-				var.removeFromDomainByIdx(i);
-				neighbor.setSubsetDomain(consistentNeighborValues);
+				constraintProblem.removeFromDomainByIdx(var, i);
+				constraintProblem.setSubsetDomain(neighbor, consistentNeighborValues);
 			}
 		}
 		return anyRevised;
@@ -89,12 +89,15 @@ namespace csp
 	template <typename T>
 	bool pc2(ConstraintProblem<T>& constraintProblem)
 	{
+		const size_t trailMark = constraintProblem.getTrailMark();
 		std::queue<VarDiffVarNeighborTriplet<T>> varDiffVarNeighborTriplets;
 		const std::vector<Ref<Variable<T>>>& variables = constraintProblem.getVariables();
-		for (Variable<T>& var : variables)
+		for (size_t varIdx = 0; varIdx < variables.size(); ++varIdx)
 		{
-			for (Variable<T>& neighbor : constraintProblem.getNeighbors(var))
+			Variable<T>& var = variables[varIdx];
+			for (size_t neighborIdx : constraintProblem.getNeighborsIdxs(varIdx))
 			{
+				Variable<T>& neighbor = constraintProblem.getVariable(neighborIdx);
 				std::vector<Ref<Variable<T>>> diffVariables{ variables };
 				__eraseVarAndNeighborFromDiffVariables<T>(diffVariables, var, neighbor);
 				for (Variable<T>& diffVar : diffVariables)
@@ -121,6 +124,7 @@ namespace csp
 			}
 		}
 
+		constraintProblem.commitTrail(trailMark);
 		return constraintProblem.isPotentiallySolvable();
 	}
 
@@ -5,17 +5,25 @@
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
+#include <bitset>
 #include <map>
 #include <type_traits>
 #include <sstream>
 #include <exception>
 #include <memory>
 #include <algorithm> 
+#include <numeric>
 #include <functional>
 #include <utility>
 #include <optional>
+#include <variant>
 #include <queue>
+#include <deque>
 #include <random>
 #include <iterator>
 #include <future>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <execution>
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+
+/*
+Portfolio solver: runs several solver configurations concurrently, each on its own deep copy of the constraint problem, and keeps
+the first solution found. Once a configuration solves its copy, the configurations still running are cooperatively cancelled
+through the copies' stop flag (see ConstraintProblem::setStopFlag), and those not yet started are skipped.
+Hence the caller need not guess which solver fits an instance, and the latency is about that of the fastest configuration.
+A configuration is any callable that tries to solve in place the problem given to it, e.g.
+	[](csp::ConstraintProblem<T>& problem) -> void { csp::minConflicts<T>(problem, 10000); }
+Solvers which return a new problem (simulatedAnnealing, randomRestartFirstChoiceHillClimbing) can write their result back to
+the given problem with assignFromProblemCopy.
+*/
+
+namespace csp
+{
+	template <typename T>
+	using SolverConfiguration = std::function<void(ConstraintProblem<T>&)>;
+
+	// assigns the variables of constraintProblem as their counterparts in copiedConstraintProblem, which deepCopy() preserves indices of
+	template <typename T>
+	void assignFromProblemCopy(ConstraintProblem<T>& constraintProblem, const ConstraintProblem<T>& copiedConstraintProblem)
+	{
+		const size_t varsSize = constraintProblem.getVariables().size();
+		for (size_t varIdx = 0; varIdx < varsSize; ++varIdx)
+		{
+			Variable<T>& var = constraintProblem.getVariable(varIdx);
+			const Variable<T>& copiedVar = copiedConstraintProblem.getVariable(varIdx);
+			var.unassign();
+			if (copiedVar.isAssigned())
+			{
+				var.assignByValue(copiedVar.getValue());
+			}
+		}
+	}
+
+	/*
+	Returns the index of the configuration whose solution was kept, constraintProblem is assigned with that solution.
+	Returns an empty optional if no configuration solved the problem. If a configuration threw, and no other one solved
+	the problem, the first exception caught is rethrown.
+	*/
+	template <typename T>
+	std::optional<size_t> portfolioSolver(ConstraintProblem<T>& constraintProblem,
+		const std::vector<SolverConfiguration<T>>& solverConfigurations,
+		unsigned int threadsAmount = std::thread::hardware_concurrency())
+	{
+		const size_t configurationsSize = solverConfigurations.size();
+		if (!configurationsSize)
+		{
+			return std::optional<size_t>{};
+		}
+		const size_t workersAmount = __getWorkersAmount(threadsAmount, configurationsSize);
+
+		std::atomic<bool> stopFlag{ false };
+		std::vector<std::vector<Variable<T>>> copiedVars;
+		std::vector<std::vector<Constraint<T>>> copiedConstraints;
+		std::vector<ConstraintProblem<T>> copiedProblems = __deepCopyProblems(constraintProblem, configurationsSize, copiedVars,
+			copiedConstraints);
+		for (ConstraintProblem<T>& copiedProblem : copiedProblems)
+		{
+			copiedProblem.setStopFlag(&stopFlag);
+		}
+
+		std::atomic<size_t> nextConfigIdx{ 0 };
+		std::atomic<size_t> solvingConfigIdx{ UNASSIGNED };
+		std::vector<std::exception_ptr> workersExceptions(workersAmount);
+		auto runConfigurations = [&](size_t workerIdx) -> void
+		{
+			for (size_t configIdx = nextConfigIdx++; configIdx < configurationsSize && !stopFlag.load(); configIdx = nextConfigIdx++)
+			{
+				ConstraintProblem<T>& copiedProblem = copiedProblems[configIdx];
+				try
+				{
+					solverConfigurations[configIdx](copiedProblem);
+				}
+				catch (...)
+				{
+					if (!workersExceptions[workerIdx])
+					{
+						workersExceptions[workerIdx] = std::current_exception();
+					}
+					continue;
+				}
+
+				size_t noSolvingConfigIdx = UNASSIGNED;
+				if (copiedProblem.isCompletelyConsistentlyAssigned() &&
+					solvingConfigIdx.compare_exchange_strong(noSolvingConfigIdx, configIdx))
+				{
+					stopFlag.store(true);
+				}
+			}
+		};
+
+		__runWorkers(workersAmount, runConfigurations);
+
+		if (solvingConfigIdx.load() != UNASSIGNED)
+		{
+			assignFromProblemCopy<T>(constraintProblem, copiedProblems[solvingConfigIdx.load()]);
+			return solvingConfigIdx.load();
+		}
+		__rethrowFirstWorkerException(workersExceptions);
+		return std::optional<size_t>{};
+	}
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "constraint_problem.h"
+#include "successor_generators.h"
 
 
 namespace csp
@@ -8,9 +9,54 @@ namespace csp
 	template <typename T>	/* Good score is high score */
 	using ScoreCalculator = std::function<unsigned int(ConstraintProblem<T>&)>;
 
+	/*
+	The score change the reassignment would make, computed from the constraints containing the reassigned variable only.
+	The problem is left as it was. Local searches use the delta counterpart of their ScoreCalculator when it has one
+	(see getScoreDeltaCalculator), hence scoring a candidate costs O(degree) constraint evaluations rather than O(constraints).
+	*/
+	template <typename T>
+	using ScoreDeltaCalculator = std::function<int(ConstraintProblem<T>&, const Reassignment&)>;
+
 	template <typename T>
 	unsigned int consistentConstraintsAmount(ConstraintProblem<T>& constraintProblem)
 	{
 		return static_cast<unsigned int>(constraintProblem.getConsistentConstraintsSize());
 	}
+
+	template <typename T>
+	static int __countConsistentConstraintsContainingVariable(const ConstraintProblem<T>& constraintProblem, size_t varIdx)
+	{
+		int consistentConstraintsSize = 0;
+		for (size_t constrIdx : constraintProblem.getConstraintsIdxsContainingVariable(varIdx))
+		{
+			if (constraintProblem.getConstraint(constrIdx).isConsistent())
+			{
+				++consistentConstraintsSize;
+			}
+		}
+		return consistentConstraintsSize;
+	}
+
+	template <typename T>
+	int consistentConstraintsAmountDelta(ConstraintProblem<T>& constraintProblem, const Reassignment& reassignment)
+	{
+		const int consistentConstraintsSizeBefore = __countConsistentConstraintsContainingVariable(constraintProblem, reassignment.varIdx);
+		Reassignment revertingReassignment = applyReassignment<T>(constraintProblem, reassignment);
+		const int consistentConstraintsSizeAfter = __countConsistentConstraintsContainingVariable(constraintProblem, reassignment.varIdx);
+		applyReassignment<T>(constraintProblem, revertingReassignment);
+		return consistentConstraintsSizeAfter - consistentConstraintsSizeBefore;
+	}
+
+	// the delta counterpart of calculateScore if it is one of the score calculators above, otherwise an empty function
+	template <typename T>
+	ScoreDeltaCalculator<T> getScoreDeltaCalculator(const ScoreCalculator<T>& calculateScore)
+	{
+		using ScoreCalculatorPtr = unsigned int(*)(ConstraintProblem<T>&);
+		const ScoreCalculatorPtr* pCalculateScore = calculateScore.template target<ScoreCalculatorPtr>();
+		if (pCalculateScore && *pCalculateScore == &consistentConstraintsAmount<T>)
+		{
+			return consistentConstraintsAmountDelta<T>;
+		}
+		return ScoreDeltaCalculator<T>{ };
+	}
 }
\ No newline at end of file
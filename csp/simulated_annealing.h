@@ -9,64 +9,100 @@
 
 namespace csp
 {
+	// proposes a successor of problem, which is made only if it is accepted at temperature, and returns whether it was
+	template <typename T>
+	static bool __makeAnnealingMove(ConstraintProblem<T>& problem, unsigned int& currScore, double temperature,
+		std::default_random_engine& defaultRandomEngine, const SuccessorGenerator<T>& generateSuccessor,
+		const ScoreCalculator<T>& calculateScore, const ScoreDeltaCalculator<T>& calculateScoreDelta)
+	{
+		Reassignment reassignment = generateSuccessor(problem, defaultRandomEngine);
+		Reassignment revertingReassignment = reassignment;
+		int delta;
+		if (calculateScoreDelta)
+		{
+			delta = calculateScoreDelta(problem, reassignment);
+		}
+		else
+		{
+			revertingReassignment = applyReassignment<T>(problem, reassignment);
+			delta = static_cast<int>(calculateScore(problem)) - static_cast<int>(currScore);
+		}
+
+		std::uniform_real_distribution<double> zeroToOneDistribution(0.0, 1.0);
+		const bool isAccepted = 0 < delta || zeroToOneDistribution(defaultRandomEngine) < std::exp(delta / temperature);
+		if (isAccepted)
+		{
+			if (calculateScoreDelta)
+			{
+				applyReassignment<T>(problem, reassignment);
+			}
+			currScore = static_cast<unsigned int>(static_cast<int>(currScore) + delta);
+		}
+		else if (!calculateScoreDelta)
+		{
+			applyReassignment<T>(problem, revertingReassignment);
+		}
+		return isAccepted;
+	}
+
+	/*
+	Searches a deep copy of constraintProblem (into bestVars and bestConstraints), which is returned with the best assignment found.
+	Successors are applied to the copy in place and reverted when rejected, and the best assignment is kept as assignment
+	indices rather than as another deep copy.
+	Successors are scored by calculateScoreDelta, or by the delta counterpart of calculateScore if it has one (see
+	getScoreDeltaCalculator), and by calculateScore otherwise. A solution is assumed to score at least as high as any other
+	assignment, hence the problem is checked for being solved only when the score reaches the best one found.
+	*/
 	template <typename T>
 	ConstraintProblem<T> simulatedAnnealing(ConstraintProblem<T>& constraintProblem,
 		std::vector<Constraint<T>>& bestConstraints, std::vector<Variable<T>>& bestVars,
 		unsigned int maxSteps, double temperature, double coolingRate,
 		const StartStateGenarator<T>& generateStartState = generateStartStateRandomly<T>,
 		const SuccessorGenerator<T>& generateSuccessor = alterRandomVariableValuePair<T>,
-		const ScoreCalculator<T>& calculateScore = consistentConstraintsAmount<T>)
+		const ScoreCalculator<T>& calculateScore = consistentConstraintsAmount<T>,
+		const ScoreDeltaCalculator<T>& calculateScoreDelta = ScoreDeltaCalculator<T>{ })
 	{
-		ConstraintProblem<T> bestProblem = generateStartState(constraintProblem, bestVars, bestConstraints);
-		ConstraintProblem<T>* pBestProblem = &(bestProblem);
-		if (pBestProblem->isCompletelyConsistentlyAssigned() || maxSteps == 1)
+		const ScoreDeltaCalculator<T> calculateSuccessorScoreDelta = calculateScoreDelta ? calculateScoreDelta :
+			getScoreDeltaCalculator(calculateScore);
+		std::random_device randomDevice;
+		std::default_random_engine defaultRandomEngine{ randomDevice() };
+		ConstraintProblem<T> problem = constraintProblem.deepCopy(bestVars, bestConstraints);
+		generateStartState(problem, defaultRandomEngine);
+		if (problem.isCompletelyConsistentlyAssigned() || maxSteps == 1)
 		{
-			return *pBestProblem;
+			return problem;
 		}
 		--maxSteps;
 
-		std::random_device randomDevice;
-		std::default_random_engine defaultRandomEngine{ randomDevice() };
-		std::uniform_real_distribution<double> zeroToOneDistribution(0.0, 1.0);
-
-		unsigned int bestScore = calculateScore(*pBestProblem);
-		std::vector<csp::Variable<T>> currVars;
-		std::vector<csp::Constraint<T>> currConstrs;
-		ConstraintProblem<T> currConstrProb = pBestProblem->deepCopy(currVars, currConstrs);
-		ConstraintProblem<T>* pCurrConstrProb = &(currConstrProb);
-		for (unsigned int i = 0; i < maxSteps; ++i)
+		unsigned int currScore = calculateScore(problem);
+		unsigned int bestScore = currScore;
+		std::vector<size_t> bestAssignmentIdxs;
+		__writeAssignmentIdxs<T>(problem, bestAssignmentIdxs);
+		bool isMoved = false;
+		for (unsigned int i = 0; i < maxSteps && !constraintProblem.isStopRequested(); ++i)
 		{
-			if (pCurrConstrProb->isCompletelyConsistentlyAssigned())
+			if (isMoved && bestScore <= currScore)
 			{
-				bestConstraints.clear();
-				bestVars.clear();
-				*pBestProblem = pCurrConstrProb->deepCopy(bestVars, bestConstraints);
-				return *pBestProblem;
+				if (problem.isCompletelyConsistentlyAssigned())
+				{
+					return problem;
+				}
+				if (bestScore < currScore)
+				{
+					bestScore = currScore;
+					__writeAssignmentIdxs<T>(problem, bestAssignmentIdxs);
+				}
 			}
 
-			unsigned int currScore = calculateScore(*pCurrConstrProb);
-			if (bestScore < currScore)
-			{
-				bestScore = currScore;
-				bestConstraints.clear();
-				bestVars.clear();
-				*pBestProblem = pCurrConstrProb->deepCopy(bestVars, bestConstraints);
-			}
-
-			std::vector<csp::Variable<T>> successorVars;
-			std::vector<csp::Constraint<T>> successorConstrs;
-			ConstraintProblem<T> successorProb = generateSuccessor(*pCurrConstrProb, successorVars, successorConstrs);
-			unsigned int successorScore = calculateScore(successorProb);
-			int delta = successorScore - currScore;
-			if (0 < delta || zeroToOneDistribution(defaultRandomEngine) < std::exp(delta / temperature))
-			{
-				currConstrs.clear();
-				currVars.clear();
-				*pCurrConstrProb = successorProb.deepCopy(currVars, currConstrs);
-			}
+			isMoved = __makeAnnealingMove(problem, currScore, temperature, defaultRandomEngine,
+				generateSuccessor, calculateScore, calculateSuccessorScoreDelta);
 			temperature *= coolingRate;
 		}
 
-		return *pBestProblem;
+		if (currScore <= bestScore)
+		{
+			__assignFromAssignmentIdxs<T>(problem, bestAssignmentIdxs);
+		}
+		return problem;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "pch.h"
+#include "constraint_problem.h"
+#include "heuristic_backtracking.h"
+
+/*
+Pull-based enumeration of the solutions heuristicBacktrackingSolver_findAllSolutions would find, in the same order.
+It drives the same resumable engine as the solvers, __HeuristicBacktrackingEngine, whose explicit stack of frames lets the search
+be suspended at each solution and resumed by the next call to next().
+The constraint problem itself holds the current solution, which is valid until the next call to next(), so callers can take
+the first k solutions, stop early, or pipeline solutions into other work, without buffering them.
+	csp::SolutionsGenerator<int> solutions{ problem, csp::minimumRemainingValues_primarySelector<int> };
+	for (const csp::ConstraintProblem<int>& solvedProblem : solutions) { ... }
+On destruction (or reset()), the variables assigned by the search are unassigned and the pruned domains are restored.
+C++20 coroutines would make this a generator function, see initial_utilities.h.
+*/
+
+namespace csp
+{
+	template <typename T>
+	class SolutionsGenerator final
+	{
+	public:
+		class Iterator final
+		{
+		public:
+			using iterator_category = std::input_iterator_tag;
+			using value_type = ConstraintProblem<T>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const ConstraintProblem<T>*;
+			using reference = const ConstraintProblem<T>&;
+
+			Iterator(SolutionsGenerator<T>* pSolutionsGenerator) noexcept : m_pSolutionsGenerator{ pSolutionsGenerator }
+			{ }
+
+			reference operator*() const noexcept { return m_pSolutionsGenerator->m_constraintProblem; }
+			pointer operator->() const noexcept { return &(m_pSolutionsGenerator->m_constraintProblem); }
+
+			Iterator& operator++()
+			{
+				if (!m_pSolutionsGenerator->next())
+				{
+					m_pSolutionsGenerator = nullptr;
+				}
+				return *this;
+			}
+
+			friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+			{
+				return left.m_pSolutionsGenerator == right.m_pSolutionsGenerator;
+			}
+
+			friend bool operator!=(const Iterator& left, const Iterator& right) noexcept { return !(left == right); }
+
+		private:
+			SolutionsGenerator<T>* m_pSolutionsGenerator;
+		};
+
+		SolutionsGenerator<T>(ConstraintProblem<T>& constraintProblem,
+			const PrimarySelector<T>& primarySelector,
+			const SecondarySelector<T>& secondarySelector = chooseFirstCandidateVar_secondarySelector<T>,
+			const std::optional<DomainSorter<T>>& optDomainSorter = std::optional<DomainSorter<T>>{},
+			const std::optional<Inference<T>>& optInference = std::optional<Inference<T>>{}) :
+			m_constraintProblem{ constraintProblem },
+			m_primarySelector{ primarySelector },
+			m_secondarySelector{ secondarySelector },
+			m_optDomainSorter{ optDomainSorter },
+			m_optInference{ optInference },
+			m_heuristicBacktrackingEngine{ constraintProblem, m_primarySelector, m_secondarySelector, m_optDomainSorter, m_optInference }
+		{ }
+
+		SolutionsGenerator<T>(const SolutionsGenerator<T>&) = delete;
+		SolutionsGenerator<T>& operator=(const SolutionsGenerator<T>&) = delete;
+
+		~SolutionsGenerator<T>()
+		{
+			this->reset();
+		}
+
+		// advances to the next solution, which the constraint problem is then assigned with. returns false once there are no more
+		bool next() { return m_heuristicBacktrackingEngine.next(); }
+
+		// undoes the search, so that the next call to next() starts it over
+		void reset() { m_heuristicBacktrackingEngine.reset(); }
+
+		// resumes the search, the iterator is at the end once there are no more solutions
+		Iterator begin()
+		{
+			if (!m_heuristicBacktrackingEngine.isStarted() && !this->next())
+			{
+				return this->end();
+			}
+			return Iterator{ m_heuristicBacktrackingEngine.isExhausted() ? nullptr : this };
+		}
+
+		Iterator end() noexcept { return Iterator{ nullptr }; }
+
+	private:
+		ConstraintProblem<T>& m_constraintProblem;
+		const PrimarySelector<T> m_primarySelector;
+		const SecondarySelector<T> m_secondarySelector;
+		const std::optional<DomainSorter<T>> m_optDomainSorter;
+		const std::optional<Inference<T>> m_optInference;
+		__HeuristicBacktrackingEngine<T> m_heuristicBacktrackingEngine;
+	};
+}
\ No newline at end of file
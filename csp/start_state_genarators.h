@@ -5,17 +5,19 @@
 
 namespace csp
 {
+	// assigns the start state of a local search in place
 	template <typename T>
-	using StartStateGenarator = std::function<ConstraintProblem<T>(ConstraintProblem<T>& srcConstraintProblem,
-		std::vector<Variable<T>>& destVars, std::vector<Constraint<T>>& destConstraints)>;
+	using StartStateGenarator = std::function<void(ConstraintProblem<T>& constraintProblem,
+		std::default_random_engine& defaultRandomEngine)>;
 
 	template <typename T>
-	ConstraintProblem<T> generateStartStateRandomly(ConstraintProblem<T>& srcConstraintProblem,
-		std::vector<Variable<T>>& destVars, std::vector<Constraint<T>>& destConstraints)
+	void generateStartStateRandomly(ConstraintProblem<T>& constraintProblem, std::default_random_engine& defaultRandomEngine)
 	{
-		ConstraintProblem<T> copiedConstraintProb = srcConstraintProblem.deepCopy(destVars, destConstraints);
-		copiedConstraintProb.unassignAllVariables();
-		copiedConstraintProb.assignVarsWithRandomValues();
-		return copiedConstraintProb;
+		for (Variable<T>& var : constraintProblem.getVariables())
+		{
+			std::uniform_int_distribution<size_t> valuesDistribution(0, var.getDomain().size() - 1);
+			var.unassign();
+			var.assignByIdx(valuesDistribution(defaultRandomEngine));
+		}
 	}
 }
\ No newline at end of file
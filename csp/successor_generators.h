@@ -2,34 +2,79 @@
 
 #include "constraint_problem.h"
 
+/*
+Local search moves are made in place: a successor generator proposes a Reassignment of the current problem without making it,
+the solver applies it, scores the problem, and either keeps it or applies the Reassignment returned by applyReassignment,
+which reverts it. Hence a step assigns a variable twice at most, rather than deep copying the problem per candidate.
+Randomness comes from the engine the solver passes, so a seeded engine replays the same search.
+*/
 
 namespace csp
 {
+	// the variable of index varIdx is to be assigned with assignmentIdx (or unassigned, if assignmentIdx is UNASSIGNED)
+	struct Reassignment
+	{
+		size_t varIdx;
+		size_t assignmentIdx;
+	};
+
 	template <typename T>
-	using SuccessorGenerator = std::function<ConstraintProblem<T>(ConstraintProblem<T>& srcConstraintProblem,
-		std::vector<Variable<T>>& destVars, std::vector<Constraint<T>>& destConstraints)>;
+	using SuccessorGenerator = std::function<Reassignment(ConstraintProblem<T>& constraintProblem,
+		std::default_random_engine& defaultRandomEngine)>;
 
+	// returns the reassignment which reverts this one
 	template <typename T>
-	ConstraintProblem<T> alterRandomVariableValuePair(ConstraintProblem<T>& srcConstraintProblem,
-		std::vector<Variable<T>>& destVars, std::vector<Constraint<T>>& destConstraints)
+	Reassignment applyReassignment(ConstraintProblem<T>& constraintProblem, const Reassignment& reassignment)
 	{
-		ConstraintProblem<T> copiedConstraintProb = srcConstraintProblem.deepCopy(destVars, destConstraints);
-		Variable<T>& randomlySelectedVar = __selectElementRandomly<Ref<Variable<T>>,
-			std::vector<Ref<Variable<T>>>>(copiedConstraintProb.getVariables());
-		std::optional<T> optOldValue;
-		if (randomlySelectedVar.isAssigned())
+		Variable<T>& var = constraintProblem.getVariable(reassignment.varIdx);
+		Reassignment revertingReassignment{ reassignment.varIdx, var.getAssignmentIdx() };
+		var.unassign();
+		if (reassignment.assignmentIdx != UNASSIGNED)
 		{
-			optOldValue = randomlySelectedVar.getValue();
+			var.assignByIdx(reassignment.assignmentIdx);
 		}
+		return revertingReassignment;
+	}
+
+	// a random variable with another random value of its domain, if it has any
+	template <typename T>
+	Reassignment alterRandomVariableValuePair(ConstraintProblem<T>& constraintProblem, std::default_random_engine& defaultRandomEngine)
+	{
+		std::uniform_int_distribution<size_t> varsDistribution(0, constraintProblem.getVariables().size() - 1);
+		const size_t varIdx = varsDistribution(defaultRandomEngine);
+		const Variable<T>& var = constraintProblem.getVariable(varIdx);
+		const size_t domainSize = var.getDomain().size();
+		const size_t assignmentIdx = var.getAssignmentIdx();
+		if (assignmentIdx == UNASSIGNED || domainSize == 1)
+		{
+			std::uniform_int_distribution<size_t> valuesDistribution(0, domainSize - 1);
+			return Reassignment{ varIdx, valuesDistribution(defaultRandomEngine) };
+		}
+
+		// draws among the other values, by skipping over the current one
+		std::uniform_int_distribution<size_t> otherValuesDistribution(0, domainSize - 2);
+		size_t otherAssignmentIdx = otherValuesDistribution(defaultRandomEngine);
+		return Reassignment{ varIdx, otherAssignmentIdx < assignmentIdx ? otherAssignmentIdx : otherAssignmentIdx + 1 };
+	}
 
-		size_t domainSize = randomlySelectedVar.getDomain().size();
-		do 
+	// the assignment idx of every variable, in the order of getVariables()
+	template <typename T>
+	static void __writeAssignmentIdxs(const ConstraintProblem<T>& constraintProblem, std::vector<size_t>& assignmentIdxs)
+	{
+		const std::vector<Ref<Variable<T>>>& variables = constraintProblem.getVariables();
+		assignmentIdxs.resize(variables.size());
+		for (size_t varIdx = 0; varIdx < variables.size(); ++varIdx)
 		{
-			randomlySelectedVar.unassign();
-			randomlySelectedVar.assignWithRandomlySelectedValue();
-		} 
-		while (1 < domainSize && optOldValue && *optOldValue == randomlySelectedVar.getValue());
+			assignmentIdxs[varIdx] = variables[varIdx].get().getAssignmentIdx();
+		}
+	}
 
-		return copiedConstraintProb;
+	template <typename T>
+	static void __assignFromAssignmentIdxs(ConstraintProblem<T>& constraintProblem, const std::vector<size_t>& assignmentIdxs)
+	{
+		for (size_t varIdx = 0; varIdx < assignmentIdxs.size(); ++varIdx)
+		{
+			applyReassignment<T>(constraintProblem, Reassignment{ varIdx, assignmentIdxs[varIdx] });
+		}
 	}
 }
\ No newline at end of file
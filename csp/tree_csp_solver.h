@@ -118,18 +118,19 @@ namespace csp
 		{
 			Variable<T>& currVariable = topologicalySortedUnassginedVars.at(i);
 			const std::vector<T>& currDomain = currVariable.getDomain();
-			for (auto it = currDomain.begin(); it != currDomain.end(); )
+			for (size_t j = 0; j < currDomain.size(); )
 			{
-				currVariable.assignByValue(*it);
-				if (constraintProblem.getConsistentDomain(topologicalySortedUnassginedVars.at(i - 1)).empty())
+				currVariable.assignByIdx(j);
+				bool isUnsupported = constraintProblem.isConsistentDomainEmpty(topologicalySortedUnassginedVars.at(i - 1));
+				currVariable.unassign();
+				if (isUnsupported)
 				{
-					currVariable.removeFromDomainByValue(*it);
+					constraintProblem.removeFromDomainByIdx(currVariable, j);
 				}
 				else
 				{
-					++it;
+					++j;
 				}
-				currVariable.unassign();
 			}
 
 			if (currDomain.empty())
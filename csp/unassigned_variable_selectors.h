@@ -16,28 +16,54 @@ namespace csp
 	template <typename T>
 	const std::vector<Ref<Variable<T>>> minimumRemainingValues_primarySelector(ConstraintProblem<T>& constraintProblem)
 	{
-		const std::vector<Ref<Variable<T>>> unassignedVariables = constraintProblem.getUnassignedVariables();
-		std::multimap<size_t, Ref<Variable<T>>> scoreToVarMap;
-		for (Variable<T>& unassignedVar : unassignedVariables)
+		// computing consistent domains assigns variables temporarily, which reorders the unassigned variables indices
+		Span<const size_t> unassignedVarsIdxsSpan = constraintProblem.getUnassignedVariablesIdxs();
+		const std::vector<size_t> unassignedVarsIdxs{ unassignedVarsIdxsSpan.begin(), unassignedVarsIdxsSpan.end() };
+		size_t smallestConsistentDomainSize = std::numeric_limits<size_t>::max();
+		std::vector<size_t> candidateVarsIdxs;
+		for (size_t varIdx : unassignedVarsIdxs)
 		{
-			const std::vector<T> consistentDomain = constraintProblem.getConsistentDomain(unassignedVar);
-			scoreToVarMap.emplace(consistentDomain.size() , unassignedVar);
-		}
-
-		size_t smallestConsistentDomainSize = scoreToVarMap.cbegin()->first;
-		std::vector<Ref<Variable<T>>> variables;
-		variables.reserve(scoreToVarMap.size() >> 2);
-		for (const std::pair<size_t, Ref<Variable<T>>>& scoreToVar : scoreToVarMap)
-		{
-			if (scoreToVar.first == smallestConsistentDomainSize)
+			size_t consistentDomainSize = constraintProblem.getConsistentDomainSize(constraintProblem.getVariable(varIdx));
+			if (consistentDomainSize < smallestConsistentDomainSize)
 			{
-				variables.emplace_back(scoreToVar.second);
+				smallestConsistentDomainSize = consistentDomainSize;
+				candidateVarsIdxs.clear();
 			}
-			else
+			if (consistentDomainSize == smallestConsistentDomainSize)
 			{
-				break;
+				candidateVarsIdxs.push_back(varIdx);
 			}
 		}
+
+		// the unassigned variables indices are in no particular order, while ties are kept in the order of getVariables()
+		std::sort(candidateVarsIdxs.begin(), candidateVarsIdxs.end());
+		std::vector<Ref<Variable<T>>> variables;
+		variables.reserve(candidateVarsIdxs.size());
+		for (size_t varIdx : candidateVarsIdxs)
+		{
+			variables.emplace_back(constraintProblem.getVariable(varIdx));
+		}
+		return variables;
+	}
+
+	/*
+	Minimum Remaining Values by current domain sizes, which the constraint problem keeps in buckets as domains shrink and
+	are restored, hence no consistent domain is computed. Selects as minimumRemainingValues_primarySelector when the inference
+	removes every value inconsistent with the assigned variables (e.g. mac, maintainingGAC, allDifferentGAC),
+	and by domain sizes alone (dom) otherwise, e.g. with forwardChecking, which only checks.
+	*/
+	template <typename T>
+	const std::vector<Ref<Variable<T>>> incrementalMinimumRemainingValues_primarySelector(ConstraintProblem<T>& constraintProblem)
+	{
+		Span<const size_t> smallestDomainVarsIdxsSpan = constraintProblem.getSmallestDomainUnassignedVariablesIdxs();
+		std::vector<size_t> candidateVarsIdxs{ smallestDomainVarsIdxsSpan.begin(), smallestDomainVarsIdxsSpan.end() };
+		std::sort(candidateVarsIdxs.begin(), candidateVarsIdxs.end());
+		std::vector<Ref<Variable<T>>> variables;
+		variables.reserve(candidateVarsIdxs.size());
+		for (size_t varIdx : candidateVarsIdxs)
+		{
+			variables.emplace_back(constraintProblem.getVariable(varIdx));
+		}
 		return variables;
 	}
 
@@ -48,8 +74,7 @@ namespace csp
 		std::multimap<size_t, Ref<Variable<T>>> scoreToVarMap;
 		for (Variable<T>& var : candidateVariables)
 		{
-			const std::vector<T> consistentDomain = constraintProblem.getConsistentDomain(var);
-			scoreToVarMap.emplace(consistentDomain.size() , var);
+			scoreToVarMap.emplace(constraintProblem.getConsistentDomainSize(var), var);
 		}
 		return scoreToVarMap.cbegin()->second;
 	}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "pch.h"
+#include "initial_utilities.h"
+
+/*
+Sparse set of the unassigned variables of a constraint problem, by their indices in ConstraintProblem<T>::getVariables().
+All indices lie in one dense vector, partitioned into the unassigned ones (its prefix) and the assigned ones (its suffix),
+and each index knows its position in the dense vector. Assigning or unassigning a variable swaps its index across the
+partition's border, hence counting is O(1), and iterating the unassigned (or assigned) variables is O(their amount),
+with no allocation and no scan of the other variables. The order within each part is arbitrary.
+The unassigned variables are also kept in buckets by their current domain sizes (a bucket queue), so the ones with the
+smallest domain are found with no domain computation: updates are O(1), and finding the smallest nonempty bucket scans
+up from a lower bound which only domain shrinks and unassignments lower, hence it is amortized O(1) along a descent.
+Each bucket's capacity covers all the variables (assigned or not) whose domain has its size, reserved when domain sizes are
+reported, so marking a variable unassigned never allocates.
+Variables update the sets they are registered in on their own (see Variable<T>::registerToUnassignedVariablesSet),
+thus a set is correct no matter who assigns its variables. ConstraintProblem<T> copies share their set, as they share their
+variables, and the last of them to be destroyed releases it, after which its variables unregister from it lazily.
+*/
+
+namespace csp
+{
+	class UnassignedVariablesSet final
+	{
+	public:
+		UnassignedVariablesSet() = delete;
+
+		UnassignedVariablesSet(size_t variablesSize) :
+			m_vecDenseIdxs(variablesSize),
+			m_vecPositions(variablesSize),
+			m_size_tUnassignedSize{ variablesSize },
+			m_vecDomainSizes(variablesSize, 0),
+			m_vecDomainSizesBuckets(1, std::vector<size_t>(variablesSize)),
+			m_vecDomainSizesCounts(1, variablesSize),
+			m_vecBucketsPositions(variablesSize),
+			m_size_tSmallestDomainSizeBound{ 0 },
+			m_atomicOwnersCount{ 0 }
+		{
+			std::iota(m_vecDenseIdxs.begin(), m_vecDenseIdxs.end(), 0);
+			std::iota(m_vecPositions.begin(), m_vecPositions.end(), 0);
+			// domain sizes are reported by the variables when they register
+			std::iota(m_vecDomainSizesBuckets.front().begin(), m_vecDomainSizesBuckets.front().end(), 0);
+			std::iota(m_vecBucketsPositions.begin(), m_vecBucketsPositions.end(), 0);
+		}
+
+		UnassignedVariablesSet(const UnassignedVariablesSet& otherSet) = delete;
+		UnassignedVariablesSet& operator=(const UnassignedVariablesSet& otherSet) = delete;
+
+		~UnassignedVariablesSet() = default;
+
+		size_t getVariablesSize() const noexcept { return m_vecDenseIdxs.size(); }
+
+		size_t getUnassignedSize() const noexcept { return m_size_tUnassignedSize; }
+
+		size_t getAssignedSize() const noexcept { return m_vecDenseIdxs.size() - m_size_tUnassignedSize; }
+
+		bool isUnassigned(size_t varIdx) const noexcept { return m_vecPositions[varIdx] < m_size_tUnassignedSize; }
+
+		Span<const size_t> getUnassignedIdxs() const noexcept
+		{
+			return Span<const size_t>{ m_vecDenseIdxs.data(), m_size_tUnassignedSize };
+		}
+
+		Span<const size_t> getAssignedIdxs() const noexcept
+		{
+			return Span<const size_t>{ m_vecDenseIdxs.data() + m_size_tUnassignedSize, this->getAssignedSize() };
+		}
+
+		void markAssigned(size_t varIdx) noexcept
+		{
+			if (this->isUnassigned(varIdx))
+			{
+				this->swap_positions(varIdx, m_vecDenseIdxs[--m_size_tUnassignedSize]);
+				this->remove_from_bucket(varIdx);
+			}
+		}
+
+		void markUnassigned(size_t varIdx) noexcept
+		{
+			if (!this->isUnassigned(varIdx))
+			{
+				this->swap_positions(varIdx, m_vecDenseIdxs[m_size_tUnassignedSize++]);
+				this->insert_to_bucket(varIdx);
+			}
+		}
+
+		void updateDomainSize(size_t varIdx, size_t domainSize)
+		{
+			if (m_vecDomainSizes[varIdx] == domainSize)
+			{
+				return;
+			}
+			this->reserve_bucket(domainSize);
+			--m_vecDomainSizesCounts[m_vecDomainSizes[varIdx]];
+			const bool isUnassigned = this->isUnassigned(varIdx);
+			if (isUnassigned)
+			{
+				this->remove_from_bucket(varIdx);
+			}
+			m_vecDomainSizes[varIdx] = domainSize;
+			if (isUnassigned)
+			{
+				this->insert_to_bucket(varIdx);
+			}
+		}
+
+		// the smallest domain size of the unassigned variables, or a size no variable has if all of them are assigned
+		size_t getSmallestDomainSize() noexcept
+		{
+			while (m_size_tSmallestDomainSizeBound < m_vecDomainSizesBuckets.size() &&
+				m_vecDomainSizesBuckets[m_size_tSmallestDomainSizeBound].empty())
+			{
+				++m_size_tSmallestDomainSizeBound;
+			}
+			return m_size_tSmallestDomainSizeBound;
+		}
+
+		Span<const size_t> getSmallestDomainUnassignedIdxs() noexcept
+		{
+			const size_t smallestDomainSize = this->getSmallestDomainSize();
+			if (smallestDomainSize == m_vecDomainSizesBuckets.size())
+			{
+				return Span<const size_t>{ };
+			}
+			const std::vector<size_t>& bucket = m_vecDomainSizesBuckets[smallestDomainSize];
+			return Span<const size_t>{ bucket.data(), bucket.size() };
+		}
+
+		// owners are the constraint problems using the set, variables keep updating it only while it is owned
+		void acquire() noexcept { ++m_atomicOwnersCount; }
+
+		void release() noexcept { --m_atomicOwnersCount; }
+
+		bool isOwned() const noexcept { return m_atomicOwnersCount != 0; }
+
+	private:
+		void swap_positions(size_t firstVarIdx, size_t secondVarIdx) noexcept
+		{
+			std::swap(m_vecDenseIdxs[m_vecPositions[firstVarIdx]], m_vecDenseIdxs[m_vecPositions[secondVarIdx]]);
+			std::swap(m_vecPositions[firstVarIdx], m_vecPositions[secondVarIdx]);
+		}
+
+		// makes room in the bucket of domainSize for one more variable
+		void reserve_bucket(size_t domainSize)
+		{
+			if (m_vecDomainSizesBuckets.size() <= domainSize)
+			{
+				m_vecDomainSizesBuckets.resize(domainSize + 1);
+				m_vecDomainSizesCounts.resize(domainSize + 1, 0);
+			}
+			std::vector<size_t>& bucket = m_vecDomainSizesBuckets[domainSize];
+			const size_t domainSizeCount = m_vecDomainSizesCounts[domainSize] + 1;
+			if (bucket.capacity() < domainSizeCount)
+			{
+				bucket.reserve(std::max(domainSizeCount, 2 * bucket.capacity()));
+			}
+			m_vecDomainSizesCounts[domainSize] = domainSizeCount;
+		}
+
+		// never reallocates, since the bucket was reserved when the variable's domain size was reported
+		void insert_to_bucket(size_t varIdx) noexcept
+		{
+			const size_t domainSize = m_vecDomainSizes[varIdx];
+			std::vector<size_t>& bucket = m_vecDomainSizesBuckets[domainSize];
+			m_vecBucketsPositions[varIdx] = bucket.size();
+			bucket.push_back(varIdx);
+			m_size_tSmallestDomainSizeBound = std::min(m_size_tSmallestDomainSizeBound, domainSize);
+		}
+
+		void remove_from_bucket(size_t varIdx) noexcept
+		{
+			std::vector<size_t>& bucket = m_vecDomainSizesBuckets[m_vecDomainSizes[varIdx]];
+			const size_t lastVarIdx = bucket.back();
+			bucket[m_vecBucketsPositions[varIdx]] = lastVarIdx;
+			m_vecBucketsPositions[lastVarIdx] = m_vecBucketsPositions[varIdx];
+			bucket.pop_back();
+		}
+
+		std::vector<size_t> m_vecDenseIdxs;
+		std::vector<size_t> m_vecPositions;
+		size_t m_size_tUnassignedSize;
+		std::vector<size_t> m_vecDomainSizes;
+		std::vector<std::vector<size_t>> m_vecDomainSizesBuckets;
+		std::vector<size_t> m_vecDomainSizesCounts;	// variables, assigned or not, by their domain sizes
+		std::vector<size_t> m_vecBucketsPositions;
+		size_t m_size_tSmallestDomainSizeBound;
+		std::atomic<size_t> m_atomicOwnersCount;
+	};
+}
\ No newline at end of file
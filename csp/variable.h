@@ -2,6 +2,8 @@
 
 #include "pch.h"
 #include "initial_utilities.h"
+#include "unassigned_variables_set.h"
+#include "bitset_domain.h"
 
 
 namespace csp
@@ -12,6 +14,7 @@ namespace csp
 	template<typename T> class assignment_idx_out_of_range_error;
 	template<typename T> class uncontained_value_error;
 	template<typename T> class domain_alteration_error;
+	template<typename T> class bitset_domain_size_error;
 	
 	/*
 	Assumptions on T:
@@ -30,15 +33,20 @@ namespace csp
 		Variable<T>(const std::unordered_set<T>& domain) :
 			m_optCompare{ init_compare() },
 			m_vecDomain{ init_domain(domain) },
-			m_size_tValueIdx{ UNASSIGNED }
+			m_size_tValueIdx{ UNASSIGNED },
+			m_optBitsetDomain{ },
+			m_vecUnassignedVariablesSets{ }
 		{ }
 
 		~Variable<T>() = default;
 
+		// a copy is another variable, hence it is not registered to the sets of otherVar's constraint problems
 		Variable<T>(const Variable<T>& otherVar) :
 			m_optCompare{ otherVar.m_optCompare },
 			m_vecDomain{ otherVar.m_vecDomain }, 
-			m_size_tValueIdx{ otherVar.m_size_tValueIdx }
+			m_size_tValueIdx{ otherVar.m_size_tValueIdx },
+			m_optBitsetDomain{ otherVar.m_optBitsetDomain },
+			m_vecUnassignedVariablesSets{ }
 		{ }
 
 		Variable<T>& operator=(const Variable<T>& otherVar)
@@ -49,14 +57,21 @@ namespace csp
 		Variable<T>(Variable<T>&& otherVar) noexcept : 
 			m_optCompare{ std::move(otherVar.m_optCompare) },
 			m_vecDomain{ std::move(otherVar.m_vecDomain) },
-			m_size_tValueIdx{ otherVar.m_size_tValueIdx }
+			m_size_tValueIdx{ otherVar.m_size_tValueIdx },
+			m_optBitsetDomain{ otherVar.m_optBitsetDomain },
+			m_vecUnassignedVariablesSets{ }
 		{ }
 
-		Variable<T>& operator=(Variable<T>&& otherVar) noexcept
+		// the registrations stay with the variables' addresses, which are what the constraint problems refer to.
+		// not noexcept: the swapped domain sizes may need room in the sets' buckets
+		Variable<T>& operator=(Variable<T>&& otherVar)
 		{
 			std::swap(m_optCompare, otherVar.m_optCompare);
 			std::swap(m_vecDomain, otherVar.m_vecDomain);
 			std::swap(m_size_tValueIdx, otherVar.m_size_tValueIdx);
+			std::swap(m_optBitsetDomain, otherVar.m_optBitsetDomain);
+			this->update_unassigned_variables_sets();
+			otherVar.update_unassigned_variables_sets();
 			return *this;
 		}
 
@@ -75,7 +90,19 @@ namespace csp
 
 		constexpr size_t getAssignmentIdx() const noexcept { return m_size_tValueIdx; }
 
-		void unassign() noexcept { m_size_tValueIdx = UNASSIGNED; }
+		void unassign() noexcept
+		{
+			if (this->isAssigned())
+			{
+				m_size_tValueIdx = UNASSIGNED;
+				// the domain size is unchanged, hence its bucket already has room and nothing allocates
+				this->prune_unassigned_variables_sets();
+				for (const auto& [pUnassignedVariablesSet, varIdx] : m_vecUnassignedVariablesSets)
+				{
+					pUnassignedVariablesSet->markUnassigned(varIdx);
+				}
+			}
+		}
 
 		void assignByIdx(size_t assignmentIdx)
 		{
@@ -89,6 +116,7 @@ namespace csp
 			}
 
 			m_size_tValueIdx = assignmentIdx;
+			this->update_unassigned_variables_sets();
 		}
 
 		void assignByValue(T val)
@@ -106,6 +134,7 @@ namespace csp
 			{
 				m_size_tValueIdx = this->get_assignment_idx_for_value_in_unsorted_domain(val);
 			}
+			this->update_unassigned_variables_sets();
 		}
 
 		constexpr size_t getAssignmentIdxOfValue(T value) const
@@ -131,12 +160,42 @@ namespace csp
 			std::default_random_engine defaultRandomEngine{ randomDevice() };
 			std::uniform_int_distribution<size_t> zeroToDomainLenDistribution(0, m_vecDomain.size() - 1);
 			m_size_tValueIdx = zeroToDomainLenDistribution(defaultRandomEngine);
+			this->update_unassigned_variables_sets();
 		}
 
 		const std::vector<T>& getDomain() const noexcept
 		{
 			return m_vecDomain;
 		}
+
+		/*
+		The domain as a bitset domain, kept next to the domain vector by every domain change once enabled.
+		Enabling throws bitset_domain_size_error if the domain does not fit one. A later domain change that does not fit one
+		(e.g. by setDomain) disables it. Used through ConstraintProblem<T>::setBitsetDomains.
+		*/
+		void enableBitsetDomain()
+		{
+			if (!BitsetDomain<T>::fits(m_vecDomain))
+			{
+				throw bitset_domain_size_error<T>{ *this };
+			}
+			m_optBitsetDomain.emplace(m_vecDomain);
+		}
+
+		void disableBitsetDomain() noexcept { m_optBitsetDomain.reset(); }
+
+		const std::optional<BitsetDomain<T>>& getBitsetDomain() const noexcept { return m_optBitsetDomain; }
+
+		/*
+		From now on, every assignment, unassignment and domain size change of this variable is marked in unassignedVariablesSet
+		as those of the variable of index varIdx. Used by ConstraintProblem<T> to keep its set of unassigned variables up to date.
+		Registrations to sets no longer owned by any constraint problem are dropped on the next update of this variable.
+		*/
+		void registerToUnassignedVariablesSet(const std::shared_ptr<UnassignedVariablesSet>& pUnassignedVariablesSet, size_t varIdx)
+		{
+			m_vecUnassignedVariablesSets.emplace_back(pUnassignedVariablesSet, varIdx);
+			this->update_unassigned_variables_sets();
+		}
 		
 		void setDomain(const std::vector<T>& domain, bool checkUniqueness = false)
 		{
@@ -148,6 +207,8 @@ namespace csp
 				if(elems.size() == domain.size())
 					m_vecDomain = domain;
 			}
+			this->rebuild_bitset_domain();
+			this->update_unassigned_variables_sets();
 		}
 
 		bool setSubsetDomain(const std::vector<T>& vecSubsetDomain, bool subsetDomainIsSorted = true)
@@ -180,6 +241,8 @@ namespace csp
 			if (wasDomainShortened)
 			{
 				m_size_tValueIdx = UNASSIGNED;
+				this->rebuild_bitset_domain();
+				this->update_unassigned_variables_sets();
 			}
 
 			return wasDomainShortened;
@@ -191,8 +254,13 @@ namespace csp
 			{
 				throw domain_alteration_error<T>(*this);
 			}
+			if (m_optBitsetDomain)
+			{
+				m_optBitsetDomain->erase(m_vecDomain[idx]);
+			}
 			m_vecDomain.erase(m_vecDomain.begin() + idx);
 			m_size_tValueIdx = UNASSIGNED;
+			this->update_unassigned_variables_sets();
 		}
 
 		void removeFromDomainByValue(T val)
@@ -202,8 +270,55 @@ namespace csp
 				throw domain_alteration_error<T>(*this);
 			}
 			auto it = std::find(m_vecDomain.cbegin(), m_vecDomain.cend(), val);
+			if (m_optBitsetDomain)
+			{
+				m_optBitsetDomain->erase(*it);
+			}
 			m_vecDomain.erase(it);
 			m_size_tValueIdx = UNASSIGNED;
+			this->update_unassigned_variables_sets();
+		}
+
+		// removes all the values of removedValues in one pass, and from the bitset domain (if any) in one word operation
+		void removeFromDomain(const BitsetDomain<T>& removedValues)
+		{
+			if (this->isAssigned())
+			{
+				throw domain_alteration_error<T>(*this);
+			}
+			if (m_optBitsetDomain)
+			{
+				m_optBitsetDomain->eraseAll(removedValues);
+			}
+			m_vecDomain.erase(std::remove_if(m_vecDomain.begin(), m_vecDomain.end(),
+				[&removedValues](T value) -> bool { return removedValues.contains(value); }), m_vecDomain.end());
+			this->update_unassigned_variables_sets();
+		}
+
+		// inverse of removeFromDomainByIdx, used for undoing domain removals. keeps the assigned value (if any) assigned.
+		void insertToDomainByIdx(size_t idx, T val)
+		{
+			if (m_vecDomain.size() < idx)
+			{
+				throw assignment_idx_out_of_range_error<T>{ *this, std::to_string(idx) };
+			}
+			m_vecDomain.insert(m_vecDomain.begin() + idx, val);
+			if (this->isAssigned() && idx <= m_size_tValueIdx)
+			{
+				++m_size_tValueIdx;
+			}
+			if (m_optBitsetDomain)
+			{
+				if (m_optBitsetDomain->covers(val))
+				{
+					m_optBitsetDomain->insert(val);
+				}
+				else
+				{
+					this->rebuild_bitset_domain();
+				}
+			}
+			this->update_unassigned_variables_sets();
 		}
 
 		friend std::ostream& operator<<(std::ostream& os, const Variable<T>& variable) noexcept
@@ -306,6 +421,55 @@ namespace csp
 
 
 		private:
+			// drops the registrations to sets whose constraint problems are all gone, in place and with no allocation
+			void prune_unassigned_variables_sets() noexcept
+			{
+				size_t registrationIdx = 0;
+				while (registrationIdx < m_vecUnassignedVariablesSets.size())
+				{
+					if (m_vecUnassignedVariablesSets[registrationIdx].first->isOwned())
+					{
+						++registrationIdx;
+						continue;
+					}
+					m_vecUnassignedVariablesSets[registrationIdx] = std::move(m_vecUnassignedVariablesSets.back());
+					m_vecUnassignedVariablesSets.pop_back();
+				}
+			}
+
+			// after the domain vector was replaced. keeps the bitset domain if the new domain fits one, and disables it otherwise
+			void rebuild_bitset_domain() noexcept
+			{
+				if (m_optBitsetDomain)
+				{
+					if (BitsetDomain<T>::fits(m_vecDomain))
+					{
+						m_optBitsetDomain.emplace(m_vecDomain);
+					}
+					else
+					{
+						m_optBitsetDomain.reset();
+					}
+				}
+			}
+
+			void update_unassigned_variables_sets()
+			{
+				this->prune_unassigned_variables_sets();
+				for (const auto& [pUnassignedVariablesSet, varIdx] : m_vecUnassignedVariablesSets)
+				{
+					pUnassignedVariablesSet->updateDomainSize(varIdx, m_vecDomain.size());
+					if (this->isAssigned())
+					{
+						pUnassignedVariablesSet->markAssigned(varIdx);
+					}
+					else
+					{
+						pUnassignedVariablesSet->markUnassigned(varIdx);
+					}
+				}
+			}
+
 			static std::optional<std::function<constexpr bool(T left, T right)>> init_compare()
 			{
 				// CSPDO: test it in cspTests
@@ -399,6 +563,8 @@ namespace csp
 			std::optional<std::function<constexpr bool(T left, T right)>> m_optCompare;
 			std::vector<T> m_vecDomain;
 			size_t m_size_tValueIdx;
+			std::optional<BitsetDomain<T>> m_optBitsetDomain;
+			std::vector<std::pair<std::shared_ptr<UnassignedVariablesSet>, size_t>> m_vecUnassignedVariablesSets;
 	};
 
 
@@ -451,6 +617,16 @@ namespace csp
 		{ }
 	};
 
+	template<typename T>
+	class bitset_domain_size_error : public std::length_error
+	{
+	public:
+		bitset_domain_size_error(const Variable<T>& var) :
+			std::length_error{ "Domain of variable: " + var.toString() + " spans more than " +
+			std::to_string(BITSET_DOMAIN_MAX_SIZE) + " values, hence it can not be represented as a bitset domain." }
+		{ }
+	};
+
 	template<typename T>
 	class uncontained_value_error : public std::domain_error
 	{
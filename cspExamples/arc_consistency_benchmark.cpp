@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "arc_consistency_benchmark.h"
+#include "australia_map_coloring_problem.h"
+#include "sudoku_problem.h"
+
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+struct ArcConsistencyMeasurement
+{
+	size_t constraintChecksCount;
+	double milliseconds;
+};
+
+// runs algorithm on a copy of constraints whose evaluators count their calls, then restores the variables of constraints
+template <typename T, typename Algorithm>
+static ArcConsistencyMeasurement __measureArcConsistency(const std::vector<csp::Constraint<T>>& constraints, Algorithm algorithm)
+{
+	size_t constraintChecksCount = 0;
+	std::vector<csp::Constraint<T>> countingConstraints;
+	countingConstraints.reserve(constraints.size());
+	for (const csp::Constraint<T>& constraint : constraints)
+	{
+		csp::ConstraintEvaluator<T> constraintEvaluator = constraint.getConstraintEvaluator();
+		countingConstraints.emplace_back(constraint.getVariables(),
+			[&constraintChecksCount, constraintEvaluator](const std::vector<T>& assignedValues) -> bool
+			{
+				++constraintChecksCount;
+				return constraintEvaluator(assignedValues);
+			});
+	}
+	std::vector<std::reference_wrapper<csp::Constraint<T>>> countingConstraintsRefs{ countingConstraints.begin(), countingConstraints.end() };
+	csp::ConstraintProblem<T> countingProblem{ countingConstraintsRefs };
+
+	// preprocessing prunes permanently, hence the domains are saved rather than restored through the trail
+	const std::vector<std::reference_wrapper<csp::Variable<T>>> unassignedVars = countingProblem.getUnassignedVariables();
+	std::vector<std::vector<T>> unassignedVarsDomains;
+	unassignedVarsDomains.reserve(unassignedVars.size());
+	for (const csp::Variable<T>& var : unassignedVars)
+	{
+		unassignedVarsDomains.push_back(var.getDomain());
+	}
+	BenchmarkClock::time_point start = BenchmarkClock::now();
+	algorithm(countingProblem);
+	std::chrono::duration<double, std::milli> elapsed = BenchmarkClock::now() - start;
+	for (size_t i = 0; i < unassignedVars.size(); ++i)
+	{
+		csp::Variable<T>& var = unassignedVars[i];
+		var.unassign();
+		var.setDomain(unassignedVarsDomains[i]);
+	}
+	return ArcConsistencyMeasurement{ constraintChecksCount, elapsed.count() };
+}
+
+template <typename T>
+static void __benchmarkArcConsistency(std::ostream& out, const std::vector<csp::Constraint<T>>& constraints)
+{
+	auto writeMeasurement = [&out](const char* algorithmName, const ArcConsistencyMeasurement& measurement) -> void
+	{
+		out << '\t' << algorithmName << ": " << measurement.constraintChecksCount << " constraint checks, " <<
+			measurement.milliseconds << " ms\n";
+	};
+
+	writeMeasurement("ac3", __measureArcConsistency<T>(constraints, [](csp::ConstraintProblem<T>& constraintProblem) -> void
+		{
+			std::unordered_set<csp::VariableRefsPair<T>> arcs = csp::initArcsAC3(constraintProblem);
+			csp::ac3(constraintProblem, arcs);
+		}));
+	writeMeasurement("ac3rm", __measureArcConsistency<T>(constraints, [](csp::ConstraintProblem<T>& constraintProblem) -> void
+		{
+			csp::ac3rm(constraintProblem);
+		}));
+	writeMeasurement("backtracking with mac", __measureArcConsistency<T>(constraints, [](csp::ConstraintProblem<T>& constraintProblem) -> void
+		{
+			csp::heuristicBacktrackingSolver<T>(constraintProblem,
+				csp::minimumRemainingValues_primarySelector<T>,
+				csp::degreeHeuristic_secondarySelector<T>,
+				std::optional<csp::DomainSorter<T>>{},
+				csp::mac<T>);
+		}));
+	writeMeasurement("backtracking with ArcConsistency3rm", __measureArcConsistency<T>(constraints,
+		[](csp::ConstraintProblem<T>& constraintProblem) -> void
+		{
+			csp::heuristicBacktrackingSolver<T>(constraintProblem,
+				csp::minimumRemainingValues_primarySelector<T>,
+				csp::degreeHeuristic_secondarySelector<T>,
+				std::optional<csp::DomainSorter<T>>{},
+				csp::ArcConsistency3rm<T>{ });
+		}));
+}
+
+void benchmarkArcConsistency(std::ostream& out, const char* sudokuFilePath)
+{
+	std::vector<csp::Variable<std::string>> mapColoringVars;
+	std::vector<csp::Constraint<std::string>> mapColoringConstrs;
+	constructAustraliaMapColoringProblem(mapColoringVars, mapColoringConstrs);
+	out << "australia map coloring:\n";
+	__benchmarkArcConsistency<std::string>(out, mapColoringConstrs);
+
+	std::vector<csp::Variable<unsigned int>> sudokuVars;
+	std::vector<csp::Constraint<unsigned int>> sudokuConstrs;
+	constructSudokuProblem(sudokuFilePath, sudokuVars, sudokuConstrs);
+	out << sudokuFilePath << ":\n";
+	__benchmarkArcConsistency<unsigned int>(out, sudokuConstrs);
+}
\ No newline at end of file
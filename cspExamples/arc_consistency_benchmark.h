@@ -0,0 +1,10 @@
+#pragma once
+
+#include "pch.h"
+
+/*
+Counts the constraint checks (and times) of arc consistency as preprocessing and as an inference (maintaining arc consistency),
+by csp::ac3 / csp::mac versus the residual supports of csp::ac3rm / csp::ArcConsistency3rm, and writes the results to out.
+The problems are the australia map coloring and the sudoku puzzle in sudokuFilePath.
+*/
+void benchmarkArcConsistency(std::ostream& out, const char* sudokuFilePath = "sudoku_puzzles/9x9_hard.txt");
\ No newline at end of file
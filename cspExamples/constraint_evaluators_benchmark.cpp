@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "constraint_evaluators_benchmark.h"
+#include "n_queens_problem.h"
+#include "sudoku_problem.h"
+
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+static double __nQueensSolvingMilliseconds(unsigned int n, unsigned int repetitions, bool typeErasedEvaluators)
+{
+	std::vector<csp::Variable<unsigned int>> variables;
+	std::vector<csp::Constraint<unsigned int>> constraints;
+	csp::ConstraintProblem<unsigned int> nQueensProblem = constructNQueensProblem(n, variables, constraints, typeErasedEvaluators);
+
+	BenchmarkClock::time_point start = BenchmarkClock::now();
+	for (unsigned int i = 0; i < repetitions; ++i)
+	{
+		nQueensProblem.unassignAllVariables();
+		csp::heuristicBacktrackingSolver<unsigned int>(nQueensProblem,
+			csp::minimumRemainingValues_primarySelector<unsigned int>,
+			csp::degreeHeuristic_secondarySelector<unsigned int>,
+			csp::leastConstrainingValue<unsigned int>);
+	}
+	std::chrono::duration<double, std::milli> elapsed = BenchmarkClock::now() - start;
+	return elapsed.count();
+}
+
+static double __sudokuSolvingMilliseconds(const char* filePath, unsigned int repetitions, bool typeErasedEvaluators)
+{
+	std::vector<csp::Variable<unsigned int>> variables;
+	std::vector<csp::Constraint<unsigned int>> constraints;
+	std::pair<csp::ConstraintProblem<unsigned int>, CoordsToVarRefsUMap> res =
+		constructSudokuProblem(filePath, variables, constraints, typeErasedEvaluators);
+	csp::ConstraintProblem<unsigned int>& sudokuProblem = res.first;
+
+	// the puzzle's given cells are the variables assigned on construction
+	std::vector<std::reference_wrapper<csp::Variable<unsigned int>>> unassignedVars = sudokuProblem.getUnassignedVariables();
+	BenchmarkClock::time_point start = BenchmarkClock::now();
+	for (unsigned int i = 0; i < repetitions; ++i)
+	{
+		for (csp::Variable<unsigned int>& var : unassignedVars)
+		{
+			var.unassign();
+		}
+		csp::heuristicBacktrackingSolver<unsigned int>(sudokuProblem,
+			csp::minimumRemainingValues_primarySelector<unsigned int>,
+			csp::degreeHeuristic_secondarySelector<unsigned int>,
+			csp::leastConstrainingValue<unsigned int>);
+	}
+	std::chrono::duration<double, std::milli> elapsed = BenchmarkClock::now() - start;
+	return elapsed.count();
+}
+
+void benchmarkConstraintEvaluators(std::ostream& out, unsigned int nQueens, const char* sudokuFilePath, unsigned int repetitions)
+{
+	out << nQueens << "-queens, " << repetitions << " solver runs:\n";
+	out << "\ttype-erased evaluators: " << __nQueensSolvingMilliseconds(nQueens, repetitions, true) << " ms\n";
+	out << "\tbuilt-in evaluators: " << __nQueensSolvingMilliseconds(nQueens, repetitions, false) << " ms\n";
+
+	out << sudokuFilePath << ", " << repetitions << " solver runs:\n";
+	out << "\ttype-erased evaluators: " << __sudokuSolvingMilliseconds(sudokuFilePath, repetitions, true) << " ms\n";
+	out << "\tbuilt-in evaluators: " << __sudokuSolvingMilliseconds(sudokuFilePath, repetitions, false) << " ms\n";
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "pch.h"
+
+/*
+Times the same solver run on constraint problems whose constraints hold type-erased csp::ConstraintEvaluator (std::function)
+evaluators versus the equivalent built-in evaluators (csp::NotAttackingQueens, csp::AllDiff), and writes the results to out.
+*/
+void benchmarkConstraintEvaluators(std::ostream& out, unsigned int nQueens = 8, const char* sudokuFilePath = "sudoku_puzzles/9x9_easy.txt",
+	unsigned int repetitions = 10);
\ No newline at end of file
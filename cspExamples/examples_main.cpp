@@ -8,6 +8,10 @@
 #include "verbal_arithmetic_problem.h"
 #include "einstein_five_house_riddle_problem.h"
 #include "sudoku_problem.h"
+#include "constraint_evaluators_benchmark.h"
+#include "arc_consistency_benchmark.h"
+#include "parallel_backtracking_benchmark.h"
+#include "minimum_remaining_values_benchmark.h"
 
 
 int main()
@@ -92,7 +96,8 @@ int main()
 		magicSquareProb,
 		csp::minimumRemainingValues_primarySelector<unsigned int>,
 		csp::degreeHeuristic_secondarySelector<unsigned int>,
-		csp::leastConstrainingValue<unsigned int>);
+		csp::leastConstrainingValue<unsigned int>,
+		csp::globalConstraintsPropagation<unsigned int>);
 
 	for (const csp::Assignment<unsigned int>& assignment : sols)
 	{
@@ -127,7 +132,8 @@ int main()
 		csp::heuristicBacktrackingSolver<unsigned int>(verbalArithmeticProb,
 			csp::minimumRemainingValues_primarySelector<unsigned int>,
 			csp::degreeHeuristic_secondarySelector<unsigned int>,
-			csp::leastConstrainingValue<unsigned int>);
+			csp::leastConstrainingValue<unsigned int>,
+			csp::globalConstraintsPropagation<unsigned int>);
 	verbalArithmeticProb.writeNameToAssignment(std::cout);*/
 
 	// uncomment to see solution
@@ -157,11 +163,13 @@ int main()
 	std::vector<csp::Constraint<unsigned int>> constraints;
 	std::pair<csp::ConstraintProblem<unsigned int>, CoordsToVarRefsUMap> res = constructSudokuProblem("sudoku_puzzles/9x9_easy.txt", variables, constraints);
 	csp::ConstraintProblem<unsigned int>& sudokuProb = res.first;
+	sudokuProb.setBitsetDomains(true);
 	const csp::AssignmentHistory<unsigned int> sudokuProbAssignmentHistory =
 		csp::heuristicBacktrackingSolver<unsigned int>(sudokuProb,
 			csp::minimumRemainingValues_primarySelector<unsigned int>,
 			csp::degreeHeuristic_secondarySelector<unsigned int>,
-			csp::leastConstrainingValue<unsigned int>);
+			csp::leastConstrainingValue<unsigned int>,
+			csp::allDifferentGAC<unsigned int>);
 
 	std::string strGrid = GetSudokuGridAsString(res.second);
 	std::cout << strGrid;*/
@@ -198,4 +206,16 @@ int main()
 	 9 12 19 18  3 | 23 22 14  2 15 |  6 11 16  1 25 |  5 24  4 10 21 |  7 13 20 17  8
 	24 10 15  4 22 | 17 13 21 20  5 |  7  9 12  3 23 |  6  1 19  8 16 | 11 25  2 14 18
 	*/
+
+	// uncomment to compare type-erased and built-in constraint evaluators
+	// benchmarkConstraintEvaluators(std::cout);
+
+	// uncomment to compare the constraint checks of ac3 and ac3rm
+	// benchmarkArcConsistency(std::cout);
+
+	// uncomment to see how finding all the solutions scales with threads
+	// benchmarkParallelFindAllSolutions(std::cout);
+
+	// uncomment to compare MRV by consistent domains and by domain sizes buckets on the big sudoku puzzles
+	// benchmarkMinimumRemainingValues(std::cout);
 }
\ No newline at end of file
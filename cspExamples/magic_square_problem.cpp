@@ -107,7 +107,7 @@ csp::ConstraintProblem<unsigned int> constructMagicSquareProblem(unsigned int n,
 	*/
 {
 	unsigned int order = n * n;
-	unsigned int magicSum = n * ((order + 1) / 2);
+	unsigned int magicSum = n * (order + 1) / 2;
 
 	std::unordered_set<unsigned int> domain = __init_domain(order);
 	
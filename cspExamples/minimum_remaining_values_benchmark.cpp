@@ -0,0 +1,37 @@
+#include "pch.h"
+#include "minimum_remaining_values_benchmark.h"
+#include "sudoku_problem.h"
+
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+static void __time_sudoku_solving(std::ostream& out, const char* filePath, const char* selectorName,
+	const csp::PrimarySelector<unsigned int>& primarySelector)
+{
+	std::vector<csp::Variable<unsigned int>> variables;
+	std::vector<csp::Constraint<unsigned int>> constraints;
+	std::pair<csp::ConstraintProblem<unsigned int>, CoordsToVarRefsUMap> res = constructSudokuProblem(filePath, variables, constraints);
+	csp::ConstraintProblem<unsigned int>& sudokuProb = res.first;
+
+	BenchmarkClock::time_point start = BenchmarkClock::now();
+	const csp::AssignmentHistory<unsigned int> assignmentHistory = csp::heuristicBacktrackingSolver<unsigned int>(sudokuProb,
+		primarySelector,
+		csp::degreeHeuristic_secondarySelector<unsigned int>,
+		std::optional<csp::DomainSorter<unsigned int>>{},
+		csp::allDifferentGAC<unsigned int>);
+	std::chrono::duration<double, std::milli> elapsed = BenchmarkClock::now() - start;
+	out << '\t' << selectorName << ": " << (sudokuProb.isCompletelyConsistentlyAssigned() ? "solved, " : "unsolved, ")
+		<< elapsed.count() << " ms\n";
+}
+
+void benchmarkMinimumRemainingValues(std::ostream& out)
+{
+	const char* filesPaths[] = { "sudoku_puzzles/16x16_easy.txt", "sudoku_puzzles/16x16_medium.txt", "sudoku_puzzles/16x16_hard.txt",
+		"sudoku_puzzles/25x25_easy.txt", "sudoku_puzzles/25x25_medium.txt", "sudoku_puzzles/25x25_hard.txt" };
+	for (const char* filePath : filesPaths)
+	{
+		out << filePath << ":\n";
+		__time_sudoku_solving(out, filePath, "consistent domains MRV", csp::minimumRemainingValues_primarySelector<unsigned int>);
+		__time_sudoku_solving(out, filePath, "domain sizes buckets MRV", csp::incrementalMinimumRemainingValues_primarySelector<unsigned int>);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "pch.h"
+
+/*
+Times solving the 16x16 and 25x25 sudoku puzzles with all-different propagation (csp::allDifferentGAC) and the degree
+heuristic as tie breaker, by csp::minimumRemainingValues_primarySelector, which computes consistent domains, versus
+csp::incrementalMinimumRemainingValues_primarySelector, which reads the domain sizes buckets, and writes the results to out.
+*/
+void benchmarkMinimumRemainingValues(std::ostream& out);
\ No newline at end of file
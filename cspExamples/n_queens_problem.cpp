@@ -61,7 +61,8 @@ static std::unordered_map<unsigned int, csp::ConstraintEvaluator<unsigned int>>
 
 static void __init_constraints(unsigned int n, std::vector<csp::Constraint<unsigned int>>& constraints,
 	const std::unordered_map<unsigned int, std::reference_wrapper<csp::Variable<unsigned int>>>& columnToVarRefMap,
-	std::unordered_map<unsigned int, csp::ConstraintEvaluator<unsigned int>>& notAttackingConstrainEvaluatorsMap)
+	std::unordered_map<unsigned int, csp::ConstraintEvaluator<unsigned int>>& notAttackingConstrainEvaluatorsMap,
+	bool typeErasedEvaluators)
 {
 	constraints.reserve(((n * n) + n) / 2);
 	for (unsigned int firstCol = 0; firstCol < n; ++firstCol)
@@ -75,15 +76,22 @@ static void __init_constraints(unsigned int n, std::vector<csp::Constraint<unsig
 					std::reference_wrapper<csp::Variable<unsigned int>>{ columnToVarRefMap.at(firstCol) },
 					std::reference_wrapper<csp::Variable<unsigned int>>{ columnToVarRefMap.at(secondCol) }
 				};
-				constraints.emplace_back(varRefs,
-					notAttackingConstrainEvaluatorsMap[__uintCalcDifference(firstCol, secondCol)]);
+				unsigned int columnDifference = __uintCalcDifference(firstCol, secondCol);
+				if (typeErasedEvaluators)
+				{
+					constraints.emplace_back(varRefs, notAttackingConstrainEvaluatorsMap[columnDifference]);
+				}
+				else
+				{
+					constraints.emplace_back(varRefs, csp::NotAttackingQueens<unsigned int>{ columnDifference });
+				}
 			}
 		}
 	}
 }
 
 csp::ConstraintProblem<unsigned int> constructNQueensProblem(unsigned int n, std::vector<csp::Variable<unsigned int>>& variables,
-	std::vector<csp::Constraint<unsigned int>>& constraints)
+	std::vector<csp::Constraint<unsigned int>>& constraints, bool typeErasedEvaluators)
 	/*
 	SOLVING N-QUEENS PROBLEM:
 	Each variable represent a column in the n x n sized board.
@@ -92,6 +100,8 @@ csp::ConstraintProblem<unsigned int> constructNQueensProblem(unsigned int n, std
 		1. No single row hold two queens: all variables are (pair-wise) all-different.
 		2. The queens don't attack each other horizontally.
 		3. The queens don't attack each other diagonally.
+	By default the constraints use the built-in csp::NotAttackingQueens evaluator,
+	typeErasedEvaluators = true uses equivalent lambdas wrapped in csp::ConstraintEvaluator instead (for benchmarking).
 	*/
 {
 	std::unordered_set<unsigned int> domain = __initDomain(n);
@@ -100,9 +110,13 @@ csp::ConstraintProblem<unsigned int> constructNQueensProblem(unsigned int n, std
 	std::unordered_map<std::string, std::reference_wrapper<csp::Variable<unsigned int>>> nameToVarRefMap;
 	__init_name_and_col_to_var_ref_map(n, domain, variables, columnToVarRefMap, nameToVarRefMap);
 
-	std::unordered_map<unsigned int, csp::ConstraintEvaluator<unsigned int>> notAttackingConstrainEvaluatorsMap = __init_notAttackingConstraintEvaluatorsMap(n);
+	std::unordered_map<unsigned int, csp::ConstraintEvaluator<unsigned int>> notAttackingConstrainEvaluatorsMap;
+	if (typeErasedEvaluators)
+	{
+		notAttackingConstrainEvaluatorsMap = __init_notAttackingConstraintEvaluatorsMap(n);
+	}
 
-	__init_constraints(n, constraints, columnToVarRefMap, notAttackingConstrainEvaluatorsMap);
+	__init_constraints(n, constraints, columnToVarRefMap, notAttackingConstrainEvaluatorsMap, typeErasedEvaluators);
 	
 	std::vector<std::reference_wrapper<csp::Constraint<unsigned int>>> constraintsRefs{ constraints.begin(), constraints.end() };
 	csp::ConstraintProblem<unsigned int> nQueensProblem{ constraintsRefs, nameToVarRefMap };
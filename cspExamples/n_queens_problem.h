@@ -3,4 +3,4 @@
 #include "pch.h"
 
 csp::ConstraintProblem<unsigned int> constructNQueensProblem(unsigned int n, std::vector<csp::Variable<unsigned int>>& variables,
-	std::vector<csp::Constraint<unsigned int>>& constraints);
\ No newline at end of file
+	std::vector<csp::Constraint<unsigned int>>& constraints, bool typeErasedEvaluators = false);
\ No newline at end of file
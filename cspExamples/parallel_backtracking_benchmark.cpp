@@ -0,0 +1,36 @@
+#include "pch.h"
+#include "parallel_backtracking_benchmark.h"
+#include "n_queens_problem.h"
+
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+void benchmarkParallelFindAllSolutions(std::ostream& out, unsigned int nQueens, unsigned int maxThreadsAmount)
+{
+	std::vector<csp::Variable<unsigned int>> variables;
+	std::vector<csp::Constraint<unsigned int>> constraints;
+	csp::ConstraintProblem<unsigned int> nQueensProblem = constructNQueensProblem(nQueens, variables, constraints);
+	out << "all the " << nQueens << "-queens solutions:\n";
+
+	BenchmarkClock::time_point start = BenchmarkClock::now();
+	size_t solutionsAmount = csp::heuristicBacktrackingSolver_findAllSolutions<unsigned int>(nQueensProblem,
+		csp::minimumRemainingValues_primarySelector<unsigned int>,
+		csp::degreeHeuristic_secondarySelector<unsigned int>,
+		std::optional<csp::DomainSorter<unsigned int>>{},
+		csp::forwardChecking<unsigned int>).size();
+	std::chrono::duration<double, std::milli> elapsed = BenchmarkClock::now() - start;
+	out << "\tsequential: " << solutionsAmount << " solutions, " << elapsed.count() << " ms\n";
+
+	for (unsigned int threadsAmount = 1; threadsAmount <= std::max(maxThreadsAmount, 1U); threadsAmount *= 2)
+	{
+		start = BenchmarkClock::now();
+		solutionsAmount = csp::parallelHeuristicBacktrackingSolver_findAllSolutions<unsigned int>(nQueensProblem,
+			csp::minimumRemainingValues_primarySelector<unsigned int>,
+			csp::degreeHeuristic_secondarySelector<unsigned int>,
+			std::optional<csp::DomainSorter<unsigned int>>{},
+			csp::forwardChecking<unsigned int>,
+			threadsAmount).size();
+		elapsed = BenchmarkClock::now() - start;
+		out << "\t" << threadsAmount << " threads: " << solutionsAmount << " solutions, " << elapsed.count() << " ms\n";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "pch.h"
+
+/*
+Times finding all the solutions of the n-queens problem by csp::heuristicBacktrackingSolver_findAllSolutions, and by
+csp::parallelHeuristicBacktrackingSolver_findAllSolutions with 1, 2, 4, ... up to maxThreadsAmount threads, and writes the
+results to out.
+*/
+void benchmarkParallelFindAllSolutions(std::ostream& out, unsigned int nQueens = 8,
+	unsigned int maxThreadsAmount = std::thread::hardware_concurrency());
\ No newline at end of file
@@ -2,4 +2,5 @@
 
 #include <fstream>
 #include <algorithm>
+#include <chrono>
 #include <csp.h>
\ No newline at end of file
@@ -2,20 +2,6 @@
 #include "sudoku_problem.h"
 
 
-
-namespace std
-{
-	template<>
-	struct std::hash<std::pair<unsigned int, unsigned int>>
-	{
-		size_t operator()(const std::pair<unsigned int, unsigned int>& unsignedIntsPair) const
-		{
-			std::hash<unsigned int> unsignedIntHasher;
-			return static_cast<size_t>(unsignedIntHasher(unsignedIntsPair.first) / unsignedIntHasher(unsignedIntsPair.second));
-		}
-	};
-}
-
 std::vector<std::vector<unsigned int>> static __parse_sudoku_board(const char* filePath)
 {
 	// CSPDO: write in each text file the dimension/length of the sudoku grid/board, that way you can reserve space in advance
@@ -153,8 +139,15 @@ static std::vector<std::vector<std::pair<unsigned int, unsigned int>>> __get_blo
 }
 
 static void __init_constraints(std::vector<csp::Variable<unsigned int>>& variables,
-	std::vector<csp::Constraint<unsigned int>>& constraints, CoordsToVarRefsUMap& coordsToVarRefsUMap)
+	std::vector<csp::Constraint<unsigned int>>& constraints, CoordsToVarRefsUMap& coordsToVarRefsUMap, bool typeErasedEvaluators)
 {
+	// a lambda is not recognized as the built-in all-different evaluator, hence it stays type-erased
+	csp::ConstraintEvaluator<unsigned int> allDiffEvaluator = csp::allDiff<unsigned int>;
+	if (typeErasedEvaluators)
+	{
+		allDiffEvaluator = [](const std::vector<unsigned int>& assignedValues) { return csp::allDiff<unsigned int>(assignedValues); };
+	}
+
 	unsigned int gridLen = static_cast<unsigned int>(std::sqrt(variables.size()));
 	std::vector<std::vector<std::pair<unsigned int, unsigned int>>> rowIndices = __get_row_indices(gridLen);
 	std::vector<std::vector<std::pair<unsigned int, unsigned int>>> colIndices = __get_column_indices(gridLen);
@@ -168,7 +161,7 @@ static void __init_constraints(std::vector<csp::Variable<unsigned int>>& variabl
 		{
 			rowVars.emplace_back(coordsToVarRefsUMap.at(rowIdx));
 		}
-		constraints.emplace_back(rowVars, csp::allDiff<unsigned int>);
+		constraints.emplace_back(rowVars, allDiffEvaluator);
 	}
 
 
@@ -180,7 +173,7 @@ static void __init_constraints(std::vector<csp::Variable<unsigned int>>& variabl
 		{
 			colVars.emplace_back(coordsToVarRefsUMap.at(colIdx));
 		}
-		constraints.emplace_back(colVars, csp::allDiff<unsigned int>);
+		constraints.emplace_back(colVars, allDiffEvaluator);
 	}
 
 	for (std::vector<std::pair<unsigned int, unsigned int>>& block : blockIndices)
@@ -191,16 +184,16 @@ static void __init_constraints(std::vector<csp::Variable<unsigned int>>& variabl
 		{
 			blockVars.emplace_back(coordsToVarRefsUMap.at(blockIdx));
 		}
-		constraints.emplace_back(blockVars, csp::allDiff<unsigned int>);
+		constraints.emplace_back(blockVars, allDiffEvaluator);
 	}
 }
 
 std::pair<csp::ConstraintProblem<unsigned int>, CoordsToVarRefsUMap> constructSudokuProblem(const char* filePath, std::vector<csp::Variable<unsigned int>>& variables,
-	std::vector<csp::Constraint<unsigned int>>& constraints)
+	std::vector<csp::Constraint<unsigned int>>& constraints, bool typeErasedEvaluators)
 {
 	std::vector<std::vector<unsigned int>> grid = __parse_sudoku_board(filePath);
 	CoordsToVarRefsUMap coordsToVarRefsUMap = __init_variables(variables, grid);
-	__init_constraints(variables, constraints, coordsToVarRefsUMap);
+	__init_constraints(variables, constraints, coordsToVarRefsUMap, typeErasedEvaluators);
 
 	std::vector<std::reference_wrapper<csp::Constraint<unsigned int>>> constraintsRefs{ constraints.begin(), constraints.end() };
 	csp::ConstraintProblem<unsigned int> sudokuProblem{ constraintsRefs };
@@ -2,11 +2,27 @@
 
 #include "pch.h"
 
+namespace std
+{
+	template<>
+	struct std::hash<std::pair<unsigned int, unsigned int>>
+	{
+		size_t operator()(const std::pair<unsigned int, unsigned int>& unsignedIntsPair) const
+		{
+			std::hash<unsigned int> unsignedIntHasher;
+			// combined rather than divided, std::hash<unsigned int> may be the identity hence zero for coordinate 0
+			size_t seed = unsignedIntHasher(unsignedIntsPair.first);
+			return seed ^ (unsignedIntHasher(unsignedIntsPair.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+		}
+	};
+}
+
 using CoordsToVarRefsUMap = std::unordered_map<std::pair<unsigned int, unsigned int>, std::reference_wrapper<csp::Variable<unsigned int>>>;
 
 
 std::pair<csp::ConstraintProblem<unsigned int>, CoordsToVarRefsUMap> constructSudokuProblem(const char* filePath, 
-	std::vector<csp::Variable<unsigned int>>& variables, std::vector<csp::Constraint<unsigned int>>& constraints);
+	std::vector<csp::Variable<unsigned int>>& variables, std::vector<csp::Constraint<unsigned int>>& constraints,
+	bool typeErasedEvaluators = false);
 
 
 std::string GetSudokuGridAsString(CoordsToVarRefsUMap& coordsToVarRefsUMap);
\ No newline at end of file
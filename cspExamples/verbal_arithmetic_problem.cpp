@@ -39,55 +39,6 @@ static std::vector<std::reference_wrapper<csp::Variable<unsigned int>>> __init_u
 	return uniqueDigitsConstraintVarRefs;
 }
 
-static bool unitsDigitConstraintEvaluator(const std::vector<unsigned int>& assignedValues)
-{
-	if (assignedValues.size() < 3)
-	{
-		return true;
-	}
-	unsigned int o = assignedValues[0];
-	unsigned int r = assignedValues[1];
-	unsigned int c_10 = assignedValues[2];
-	return o + o == r + 10 * c_10;
-};
-
-static bool tensDigitConstraintEvaluator(const std::vector<unsigned int>& assignedValues)
-{
-	if (assignedValues.size() < 4)
-	{
-		return true;
-	}
-	unsigned int c_10 = assignedValues[0];
-	unsigned int w = assignedValues[1];
-	unsigned int u = assignedValues[2];
-	unsigned int c_100 = assignedValues[3];
-	return c_10 + w + w == u + 10 * c_100;
-};
-
-static bool hundredsDigitConstraintEvaluator(const std::vector<unsigned int>& assignedValues)
-{
-	if (assignedValues.size() < 4)
-	{
-		return true;
-	}
-	unsigned int c_100 = assignedValues[0];
-	unsigned int t = assignedValues[1];
-	unsigned int o = assignedValues[2];
-	unsigned int c_1000 = assignedValues[3];
-	return c_100 + t + t == o + 10 * c_1000;
-};
-
-static bool thousandsDigitConstraintEvaluator(const std::vector<unsigned int>& assignedValues)
-{
-	if (assignedValues.size() < 2)
-	{
-		return true;
-	}
-	unsigned int c_1000 = assignedValues[0];
-	unsigned int f = assignedValues[1];
-	return c_1000 == f;
-};
-
 csp::ConstraintProblem<unsigned int> constructVerbalArithmeticProblem(std::vector<csp::Variable<unsigned int>>& variables,
 	std::vector<csp::Constraint<unsigned int>>& constraints)
 	/*
@@ -115,25 +66,33 @@ csp::ConstraintProblem<unsigned int> constructVerbalArithmeticProblem(std::vecto
 	{
 		nameToVarRefMap.at("o"), nameToVarRefMap.at("r"), nameToVarRefMap.at("c_10")
 	};
-	constraints.emplace_back(unitsDigitsConstraintVarRefs, unitsDigitConstraintEvaluator);
+	// o + o == r + 10 * c_10
+	constraints.emplace_back(unitsDigitsConstraintVarRefs,
+		csp::LinearSum<unsigned int>{ { 2, -1, -10 }, csp::LinearRelation::EQUAL, 0 });
 
 	std::vector<std::reference_wrapper<csp::Variable<unsigned int>>> tensDigitsConstraintVarRefs
 	{
 		nameToVarRefMap.at("c_10"), nameToVarRefMap.at("w"), nameToVarRefMap.at("u"), nameToVarRefMap.at("c_100")
 	};
-	constraints.emplace_back(tensDigitsConstraintVarRefs, tensDigitConstraintEvaluator);
+	// c_10 + w + w == u + 10 * c_100
+	constraints.emplace_back(tensDigitsConstraintVarRefs,
+		csp::LinearSum<unsigned int>{ { 1, 2, -1, -10 }, csp::LinearRelation::EQUAL, 0 });
 
 	std::vector<std::reference_wrapper<csp::Variable<unsigned int>>> hundredsDigitsConstraintVarRefs
 	{
 		nameToVarRefMap.at("c_100"), nameToVarRefMap.at("t"), nameToVarRefMap.at("o"), nameToVarRefMap.at("c_1000")
 	};
-	constraints.emplace_back(hundredsDigitsConstraintVarRefs, hundredsDigitConstraintEvaluator);
+	// c_100 + t + t == o + 10 * c_1000
+	constraints.emplace_back(hundredsDigitsConstraintVarRefs,
+		csp::LinearSum<unsigned int>{ { 1, 2, -1, -10 }, csp::LinearRelation::EQUAL, 0 });
 
 	std::vector<std::reference_wrapper<csp::Variable<unsigned int>>> thousandsDigitsConstraintVarRefs
 	{
 		nameToVarRefMap.at("c_1000"), nameToVarRefMap.at("f")
 	};
-	constraints.emplace_back(thousandsDigitsConstraintVarRefs, thousandsDigitConstraintEvaluator);
+	// c_1000 == f
+	constraints.emplace_back(thousandsDigitsConstraintVarRefs,
+		csp::LinearSum<unsigned int>{ { 1, -1 }, csp::LinearRelation::EQUAL, 0 });
 
 	std::vector<std::reference_wrapper<csp::Constraint<unsigned int>>> constraintsRefs{ constraints.begin(), constraints.end() };
 	csp::ConstraintProblem<unsigned int> verbalArithmeticProblem{ constraintsRefs, nameToVarRefMap };
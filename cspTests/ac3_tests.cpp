@@ -106,6 +106,28 @@ namespace cspTests
 			Assert::IsTrue(actualReducedValues == expectedReducedValues);
 		}
 
+		TEST_METHOD(TestAC3PrunesPermanently)
+		{
+			Assert::IsTrue(ac3(constProb2, csp::initArcsAC3(constProb2)));
+			Assert::AreEqual(size_t{ 0 }, constProb2.getTrailMark());
+			Assert::IsTrue(ac3(constProb2, csp::initArcsAC3(constProb2)));
+			Assert::AreEqual(size_t{ 0 }, constProb2.getTrailMark());
+			Assert::AreEqual(size_t{ 2 }, s.getDomain().size());
+		}
+
+		TEST_METHOD(TestAC3WithBitsetDomains)
+		{
+			constProb2.setBitsetDomains(true);
+			Assert::IsTrue(ac3(constProb2, csp::initArcsAC3(constProb2)));
+			const std::vector<int> firstVarExpectedReducedDomain{ 1, 2 };
+			const std::vector<int> secondVarExpectedReducedDomain{ 2, 3 };
+			Assert::IsTrue(s.getDomain() == firstVarExpectedReducedDomain);
+			Assert::IsTrue(t.getDomain() == secondVarExpectedReducedDomain);
+			Assert::IsTrue(constProb2.getBitsetDomain(s)->getValues() == firstVarExpectedReducedDomain);
+			Assert::IsTrue(constProb2.getBitsetDomain(t)->getValues() == secondVarExpectedReducedDomain);
+			Assert::AreEqual(size_t{ 0 }, constProb2.getTrailMark());
+		}
+
 		TEST_METHOD(TestThreeAC3)
 		{
 			bool ac3Res = ac3(constProb2, csp::initArcsAC3(constProb2));
@@ -125,5 +147,57 @@ namespace cspTests
 				}
 			}
 		}
+
+		TEST_METHOD(TestAC3rmPrunesAsAC3)
+		{
+			Assert::IsTrue(csp::ac3rm(constProb1));
+			std::unordered_set<int> actualReducedValues;
+			for (const csp::Variable<int>& var : constProb1.getVariables())
+			{
+				actualReducedValues.insert(var.getDomain().cbegin(), var.getDomain().cend());
+			}
+			Assert::IsTrue(actualReducedValues == std::unordered_set<int>{ 2, 4 });
+
+			Assert::IsTrue(csp::ac3rm(constProb2));
+			Assert::IsTrue(s.getDomain() == std::vector<int>{ 1, 2 });
+			Assert::IsTrue(t.getDomain() == std::vector<int>{ 2, 3 });
+		}
+
+		TEST_METHOD(TestAC3rmReusesResidues)
+		{
+			csp::ArcConsistency3rm<std::string> arcConsistency3rm;
+			Assert::IsTrue(arcConsistency3rm.enforce(graphColoringProb));
+			const size_t firstEnforcementChecksCount = arcConsistency3rm.getConstraintChecksCount();
+			Assert::IsTrue(0 < firstEnforcementChecksCount);
+			// nothing was pruned, hence all the residues are still valid and no constraint is checked again
+			Assert::IsTrue(arcConsistency3rm.enforce(graphColoringProb));
+			Assert::AreEqual(firstEnforcementChecksCount, arcConsistency3rm.getConstraintChecksCount());
+
+			const size_t trailMark = graphColoringProb.getTrailMark();
+			csp::Variable<std::string>& sa = NameToVarUMap.at("sa");
+			csp::Variable<std::string>& wa = NameToVarUMap.at("wa");
+			csp::Variable<std::string>& nt = NameToVarUMap.at("nt");
+			sa.assignByValue("Red");
+			Assert::IsTrue(arcConsistency3rm(graphColoringProb, sa));
+			Assert::AreEqual(size_t{ 2 }, wa.getDomain().size());
+			wa.assignByValue("Green");
+			Assert::IsTrue(arcConsistency3rm(graphColoringProb, wa));
+			Assert::IsTrue(nt.getDomain() == std::vector<std::string>{ "Blue" });
+			graphColoringProb.restoreTrail(trailMark);
+			Assert::AreEqual(size_t{ 3 }, nt.getDomain().size());
+		}
+
+		TEST_METHOD(TestMacRMDetectsWipeout)
+		{
+			const size_t trailMark = constProb2.getTrailMark();
+			s.assignByValue(3);
+			Assert::IsFalse(csp::macRM(constProb2, s));
+			constProb2.restoreTrail(trailMark);
+			s.unassign();
+			s.assignByValue(2);
+			Assert::IsTrue(csp::macRM(constProb2, s));
+			Assert::IsTrue(t.getDomain() == std::vector<int>{ 3 });
+			constProb2.restoreTrail(trailMark);
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <csp.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace cspTests
+{
+	TEST_CLASS(AdaptiveVariableSelectorsTests)
+	{
+	public:
+		static const int n = 4;
+		std::vector<csp::Variable<int>> cells;
+		std::vector<csp::Constraint<int>> constraints;
+
+		AdaptiveVariableSelectorsTests()
+		{
+			std::unordered_set<int> domain;
+			for (int i = 0; i < n; ++i)
+			{
+				domain.emplace(i);
+			}
+			cells.reserve(n * n);
+			for (int i = 0; i < n * n; ++i)
+			{
+				cells.emplace_back(domain);
+			}
+			for (int i = 0; i < n; ++i)
+			{
+				std::vector<std::reference_wrapper<csp::Variable<int>>> rowVars;
+				std::vector<std::reference_wrapper<csp::Variable<int>>> colVars;
+				for (int j = 0; j < n; ++j)
+				{
+					rowVars.emplace_back(cells[i * n + j]);
+					colVars.emplace_back(cells[j * n + i]);
+				}
+				constraints.emplace_back(rowVars, csp::allDiff<int>);
+				constraints.emplace_back(colVars, csp::allDiff<int>);
+			}
+		}
+
+		template <typename AdaptiveSelector>
+		void solveLatinSquare(AdaptiveSelector adaptiveSelector)
+		{
+			std::vector<std::reference_wrapper<csp::Constraint<int>>> constraintsRefs{ constraints.begin(), constraints.end() };
+			csp::ConstraintProblem<int> latinSquareProb{ constraintsRefs };
+			// the same instance serves as the selectors and the inference, its copies share what it learns
+			csp::heuristicBacktrackingSolver<int>(latinSquareProb, adaptiveSelector, adaptiveSelector,
+				std::optional<csp::DomainSorter<int>>{}, adaptiveSelector);
+			Assert::IsTrue(latinSquareProb.isCompletelyConsistentlyAssigned());
+		}
+
+		TEST_METHOD(TestWeightedDegreeBumpsFailingConstraints)
+		{
+			csp::Variable<int> u{ { 1, 2 } };
+			csp::Variable<int> v{ { 1, 2 } };
+			csp::Variable<int> w{ { 1, 2 } };
+			csp::Variable<int> x{ { 1, 2, 3 } };
+			csp::Variable<int> y{ { 1, 2, 3 } };
+			csp::Constraint<int> pigeonholeConstr{ { u, v, w }, csp::allDiff<int> };
+			csp::Constraint<int> freeConstr{ { x, y }, csp::allDiff<int> };
+			csp::ConstraintProblem<int> pigeonholeProb{ { pigeonholeConstr, freeConstr } };
+
+			csp::WeightedDegree<int> weightedDegree;
+			csp::heuristicBacktrackingSolver<int>(pigeonholeProb, weightedDegree, weightedDegree,
+				std::optional<csp::DomainSorter<int>>{}, weightedDegree);
+			Assert::IsFalse(pigeonholeProb.isCompletelyConsistentlyAssigned());
+			Assert::IsTrue(1 < weightedDegree.getConstraintWeight(0));
+			Assert::AreEqual(size_t{ 1 }, weightedDegree.getConstraintWeight(1));
+		}
+
+		TEST_METHOD(TestWeightedDegreeSolvesLatinSquare)
+		{
+			this->solveLatinSquare(csp::WeightedDegree<int>{ csp::maintainingGAC<int> });
+		}
+
+		TEST_METHOD(TestActivityRecordsPrunedVariables)
+		{
+			csp::Activity<int> activity{ csp::maintainingGAC<int> };
+			this->solveLatinSquare(activity);
+			double activitiesSum = 0.0;
+			for (size_t varIdx = 0; varIdx < cells.size(); ++varIdx)
+			{
+				Assert::IsTrue(0.0 <= activity.getVariableActivity(varIdx));
+				activitiesSum += activity.getVariableActivity(varIdx);
+			}
+			Assert::IsTrue(0.0 < activitiesSum);
+		}
+
+		TEST_METHOD(TestImpactRecordsAssignmentsImpacts)
+		{
+			csp::Impact<int> impact{ csp::maintainingGAC<int> };
+			this->solveLatinSquare(impact);
+			// with no impacts yet, the first variable is selected first, and its assignment prunes its row and column
+			double firstAssignmentImpact = impact.getAssignmentImpact(0, cells[0].getValue());
+			Assert::IsTrue(0.0 < firstAssignmentImpact && firstAssignmentImpact <= 1.0);
+		}
+	};
+}
\ No newline at end of file
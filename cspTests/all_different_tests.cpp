@@ -0,0 +1,124 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <csp.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace cspTests
+{
+	TEST_CLASS(AllDifferentTests)
+	{
+	public:
+		csp::Variable<int> a{ { 1, 2, 3, 4 } };
+		csp::Variable<int> x{ { 1, 2 } };
+		csp::Variable<int> y{ { 1, 2 } };
+		csp::Variable<int> z{ { 1, 2, 3 } };
+		csp::Constraint<int> allDiffConstr{ { a, x, y, z }, csp::allDiff<int> };
+		csp::ConstraintProblem<int> allDiffProb{ { allDiffConstr } };
+
+		csp::Variable<int> u{ { 1, 2 } };
+		csp::Variable<int> v{ { 1, 2 } };
+		csp::Variable<int> w{ { 1, 2 } };
+		csp::Variable<int> t{ { 1, 2, 3, 4, 5 } };
+		csp::Constraint<int> pigeonholeConstr{ { u, v, w, t }, csp::AllDiff<int>{ } };
+		csp::ConstraintProblem<int> pigeonholeProb{ { pigeonholeConstr } };
+
+		TEST_METHOD_INITIALIZE(AllDifferentSetUp)
+		{
+			allDiffProb.unassignAllVariables();
+			pigeonholeProb.unassignAllVariables();
+		}
+
+		TEST_METHOD(TestGACPrunesBeyondPairwise)
+		{
+			const size_t trailMark = allDiffProb.getTrailMark();
+			a.assignByValue(4);
+			Assert::IsTrue(csp::allDifferentGAC(allDiffProb, a));
+			// x and y take 1 and 2 between them, which pairwise arc consistency does not detect
+			Assert::IsTrue(z.getDomain() == std::vector<int>{ 3 });
+			Assert::AreEqual(size_t{ 2 }, x.getDomain().size());
+			allDiffProb.restoreTrail(trailMark);
+			Assert::AreEqual(size_t{ 3 }, z.getDomain().size());
+		}
+
+		TEST_METHOD(TestBoundsConsistencyPrunes)
+		{
+			const size_t trailMark = allDiffProb.getTrailMark();
+			a.assignByValue(4);
+			Assert::IsTrue(csp::allDifferentBoundsConsistency(allDiffProb, a));
+			Assert::IsTrue(z.getDomain() == std::vector<int>{ 3 });
+			allDiffProb.restoreTrail(trailMark);
+			Assert::AreEqual(size_t{ 3 }, z.getDomain().size());
+		}
+
+		TEST_METHOD(TestBoundsConsistencyPassesHoles)
+		{
+			csp::Variable<int> p{ { 1, 2 } };
+			csp::Variable<int> q{ { 1, 2 } };
+			csp::Variable<int> r{ { 1, 2, 4 } };
+			csp::Variable<int> s{ { 2, 3, 4 } };
+			csp::Variable<int> k{ { 8, 9 } };
+			csp::Constraint<int> constr{ { p, q, r, s, k }, csp::allDiff<int> };
+			csp::ConstraintProblem<int> prob{ { constr } };
+			k.assignByValue(9);
+			Assert::IsTrue(csp::allDifferentBoundsConsistency(prob, k));
+			// the Hall interval [1, 2] raises r's min to the hole 3, hence to 4, and the Hall interval [4, 4] lowers s's max
+			Assert::IsTrue(r.getDomain() == std::vector<int>{ 4 });
+			Assert::IsTrue(s.getDomain() == std::vector<int>{ 3 });
+			Assert::IsTrue(p.getDomain() == std::vector<int>{ 1, 2 });
+		}
+
+		TEST_METHOD(TestPigeonholeFails)
+		{
+			const size_t trailMark = pigeonholeProb.getTrailMark();
+			t.assignByValue(5);
+			Assert::IsFalse(csp::allDifferentGAC(pigeonholeProb, t));
+			pigeonholeProb.restoreTrail(trailMark);
+			Assert::IsFalse(csp::allDifferentBoundsConsistency(pigeonholeProb, t));
+			pigeonholeProb.restoreTrail(trailMark);
+		}
+
+		TEST_METHOD(TestLatinSquareWithGACInference)
+		{
+			const int n = 6;
+			std::unordered_set<int> domain;
+			for (int i = 0; i < n; ++i)
+			{
+				domain.emplace(i);
+			}
+			std::vector<csp::Variable<int>> cells;
+			cells.reserve(n * n);
+			for (int i = 0; i < n * n; ++i)
+			{
+				cells.emplace_back(domain);
+			}
+			std::vector<csp::Constraint<int>> constraints;
+			for (int i = 0; i < n; ++i)
+			{
+				std::vector<std::reference_wrapper<csp::Variable<int>>> rowVars;
+				std::vector<std::reference_wrapper<csp::Variable<int>>> colVars;
+				for (int j = 0; j < n; ++j)
+				{
+					rowVars.emplace_back(cells[i * n + j]);
+					colVars.emplace_back(cells[j * n + i]);
+				}
+				constraints.emplace_back(rowVars, csp::allDiff<int>);
+				constraints.emplace_back(colVars, csp::allDiff<int>);
+			}
+			std::vector<std::reference_wrapper<csp::Constraint<int>>> constraintsRefs{ constraints.begin(), constraints.end() };
+			csp::ConstraintProblem<int> latinSquareProb{ constraintsRefs };
+			cells[0].assignByValue(5);
+			cells[n + 1].assignByValue(5);
+
+			csp::heuristicBacktrackingSolver<int>(latinSquareProb,
+				csp::minimumRemainingValues_primarySelector<int>,
+				csp::degreeHeuristic_secondarySelector<int>,
+				std::optional<csp::DomainSorter<int>>{},
+				csp::allDifferentGAC<int>);
+			Assert::IsTrue(latinSquareProb.isCompletelyConsistentlyAssigned());
+			Assert::AreEqual(size_t{ n }, cells[1].getDomain().size());
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <csp.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace cspTests
+{
+	TEST_CLASS(ConflictsTrackerTests)
+	{
+	public:
+
+		const std::unordered_set<std::string> domain{ "Red", "Green", "Blue" };
+		const std::unordered_set<std::string> names{ "nt", "q", "nsw", "v", "t", "sa", "wa" };
+		std::unordered_map<std::string, csp::Variable<std::string>> NameToVarUMap = csp::Variable<std::string>::constructFromNamesToEqualDomain(names, domain);
+
+		csp::Constraint<std::string> constr1{ { NameToVarUMap.at("sa"), NameToVarUMap.at("wa") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr2{ { NameToVarUMap.at("sa"), NameToVarUMap.at("nt") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr3{ { NameToVarUMap.at("sa"), NameToVarUMap.at("q") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr4{ { NameToVarUMap.at("sa"), NameToVarUMap.at("nsw") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr5{ { NameToVarUMap.at("sa"), NameToVarUMap.at("v") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr6{ { NameToVarUMap.at("wa"), NameToVarUMap.at("nt") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr7{ { NameToVarUMap.at("nt"), NameToVarUMap.at("q") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr8{ { NameToVarUMap.at("q"), NameToVarUMap.at("nsw") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr9{ { NameToVarUMap.at("nsw"), NameToVarUMap.at("v") }, csp::allDiff<std::string> };
+		csp::Constraint<std::string> constr10{ { NameToVarUMap.at("t") }, csp::allDiff<std::string> };
+
+		csp::ConstraintProblem<std::string> graphColoringProb{ {constr1, constr2, constr3, constr4, constr5, constr6, constr7, constr8,
+			constr9, constr10} };
+
+		TEST_METHOD_INITIALIZE(ConflictsTrackerSetUp)
+		{
+			graphColoringProb.unassignAllVariables();
+			for (csp::Variable<std::string>& var : graphColoringProb.getVariables())
+			{
+				var.assignByValue("Red");
+			}
+		}
+
+		TEST_METHOD(TestInitialCounts)
+		{
+			csp::ConflictsTracker<std::string> conflictsTracker{ graphColoringProb };
+			Assert::AreEqual(graphColoringProb.getUnsatisfiedConstraintsSize(), conflictsTracker.getUnsatisfiedConstraintsSize());
+			Assert::AreEqual(size_t{ 5 }, conflictsTracker.getVariableConflictsCount(graphColoringProb.getVariableIdx(NameToVarUMap.at("sa"))));
+			Assert::AreEqual(size_t{ 0 }, conflictsTracker.getVariableConflictsCount(graphColoringProb.getVariableIdx(NameToVarUMap.at("t"))));
+			Assert::AreEqual(size_t{ 6 }, conflictsTracker.getConflictedVariablesIdxs().size());
+		}
+
+		TEST_METHOD(TestReassign)
+		{
+			csp::ConflictsTracker<std::string> conflictsTracker{ graphColoringProb };
+			size_t saIdx = graphColoringProb.getVariableIdx(NameToVarUMap.at("sa"));
+			size_t greenIdx = NameToVarUMap.at("sa").getAssignmentIdxOfValue("Green");
+			Assert::AreEqual(size_t{ 0 }, conflictsTracker.getConflictsCountIfAssigned(saIdx, greenIdx));
+			Assert::IsTrue(NameToVarUMap.at("sa").getValue() == "Red");
+
+			conflictsTracker.reassign(saIdx, greenIdx);
+			Assert::AreEqual(graphColoringProb.getUnsatisfiedConstraintsSize(), conflictsTracker.getUnsatisfiedConstraintsSize());
+			Assert::AreEqual(size_t{ 0 }, conflictsTracker.getVariableConflictsCount(saIdx));
+			Assert::AreEqual(size_t{ 1 }, conflictsTracker.getVariableConflictsCount(graphColoringProb.getVariableIdx(NameToVarUMap.at("v"))));
+			Assert::AreEqual(size_t{ 5 }, conflictsTracker.getConflictedVariablesIdxs().size());
+		}
+
+		TEST_METHOD(TestReadOnlyVariablesAreNotConflicted)
+		{
+			std::unordered_set<std::reference_wrapper<csp::Variable<std::string>>> readOnlyVars{ NameToVarUMap.at("sa") };
+			csp::ConflictsTracker<std::string> conflictsTracker{ graphColoringProb, readOnlyVars };
+			size_t saIdx = graphColoringProb.getVariableIdx(NameToVarUMap.at("sa"));
+			for (size_t i = 0; i < 100; ++i)
+			{
+				Assert::AreNotEqual(saIdx, conflictsTracker.selectRandomConflictedVariableIdx());
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -191,6 +191,34 @@ namespace cspTests
 			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
 		}
 
+		TEST_METHOD(TestIsCompletelyConsistentlyAssignedOfHugeProblem)
+		{
+			// enough constraints for the parallel scan, all but the last one over wa and nt
+			std::vector<csp::Constraint<std::string>> hugeConstraints;
+			hugeConstraints.reserve(csp::PARALLEL_CONSISTENCY_CHECK_MIN_CONSTRAINTS);
+			std::vector<std::reference_wrapper<csp::Constraint<std::string>>> hugeConstraintsRefs;
+			hugeConstraintsRefs.reserve(csp::PARALLEL_CONSISTENCY_CHECK_MIN_CONSTRAINTS);
+			for (size_t i = 0; i + 1 < csp::PARALLEL_CONSISTENCY_CHECK_MIN_CONSTRAINTS; ++i)
+			{
+				hugeConstraints.emplace_back(std::vector<std::reference_wrapper<csp::Variable<std::string>>>{ NameToVarUMap.at("wa"),
+					NameToVarUMap.at("nt") }, csp::allDiff<std::string>);
+				hugeConstraintsRefs.emplace_back(hugeConstraints.back());
+			}
+			hugeConstraints.emplace_back(std::vector<std::reference_wrapper<csp::Variable<std::string>>>{ NameToVarUMap.at("nt"),
+				NameToVarUMap.at("q") }, csp::allDiff<std::string>);
+			hugeConstraintsRefs.emplace_back(hugeConstraints.back());
+			csp::ConstraintProblem<std::string> hugeProb{ hugeConstraintsRefs };
+
+			NameToVarUMap.at("wa").assignByValue("Red");
+			NameToVarUMap.at("nt").assignByValue("Green");
+			Assert::IsFalse(hugeProb.isCompletelyConsistentlyAssigned());
+			NameToVarUMap.at("q").assignByValue("Green");
+			Assert::IsFalse(hugeProb.isCompletelyConsistentlyAssigned());
+			NameToVarUMap.at("q").unassign();
+			NameToVarUMap.at("q").assignByValue("Blue");
+			Assert::IsTrue(hugeProb.isCompletelyConsistentlyAssigned());
+		}
+
 		TEST_METHOD(TestGetVariables)
 		{
 			const std::vector<std::reference_wrapper<csp::Variable<std::string>>> graphColoringVars = graphColoringProb.getVariables();
@@ -232,6 +260,76 @@ namespace cspTests
 			Assert::IsTrue(unassignedVars == graphProbUnassignedVarsUset);
 		}
 
+		TEST_METHOD(TestUnassignedVariablesTracking)
+		{
+			// a problem over some of the same variables, assigned directly rather than through either problem
+			csp::ConstraintProblem<std::string> subProb{ { constr1, constr6 } };
+			{
+				csp::ConstraintProblem<std::string> copiedSubProb{ subProb };
+				NameToVarUMap.at("sa").assignByValue("Red");
+			}
+			NameToVarUMap.at("t").assignByValue("Blue");
+			Assert::AreEqual(size_t{ 2 }, graphColoringProb.getAssignedVariablesSize());
+			Assert::AreEqual(size_t{ 5 }, graphColoringProb.getUnassignedVariablesSize());
+			Assert::AreEqual(size_t{ 1 }, subProb.getAssignedVariablesSize());
+			Assert::AreEqual(size_t{ 2 }, subProb.getUnassignedVariablesSize());
+
+			std::unordered_set<size_t> unassignedVarsIdxs;
+			for (size_t varIdx : subProb.getUnassignedVariablesIdxs())
+			{
+				Assert::IsFalse(subProb.getVariable(varIdx).isAssigned());
+				unassignedVarsIdxs.insert(varIdx);
+			}
+			Assert::IsTrue(unassignedVarsIdxs == std::unordered_set<size_t>{ subProb.getVariableIdx(NameToVarUMap.at("wa")),
+				subProb.getVariableIdx(NameToVarUMap.at("nt")) });
+
+			// unlike the indices, the variables keep the order of getVariables()
+			std::vector<std::reference_wrapper<csp::Variable<std::string>>> expectedUnassignedVars;
+			for (csp::Variable<std::string>& var : graphColoringProb.getVariables())
+			{
+				if (!var.isAssigned())
+				{
+					expectedUnassignedVars.emplace_back(var);
+				}
+			}
+			Assert::IsTrue(expectedUnassignedVars == graphColoringProb.getUnassignedVariables());
+
+			NameToVarUMap.at("wa").assignByValue("Green");
+			NameToVarUMap.at("nt").assignByValue("Blue");
+			Assert::IsTrue(subProb.isCompletelyAssigned());
+			Assert::IsFalse(graphColoringProb.isCompletelyAssigned());
+			subProb.unassignAllVariables();
+			Assert::IsTrue(subProb.isCompletelyUnassigned());
+			Assert::AreEqual(size_t{ 1 }, graphColoringProb.getAssignedVariablesSize());
+			Assert::IsTrue(NameToVarUMap.at("t") == graphColoringProb.getAssignedVariables().front());
+		}
+
+		TEST_METHOD(TestSmallestDomainUnassignedVariablesTracking)
+		{
+			csp::Variable<std::string>& q = NameToVarUMap.at("q");
+			const size_t qIdx = graphColoringProb.getVariableIdx(q);
+			Assert::AreEqual(size_t{ 3 }, graphColoringProb.getSmallestUnassignedDomainSize());
+			Assert::AreEqual(size_t{ 7 }, graphColoringProb.getSmallestDomainUnassignedVariablesIdxs().size());
+
+			const size_t trailMark = graphColoringProb.getTrailMark();
+			graphColoringProb.removeFromDomainByIdx(q, 0);
+			Assert::AreEqual(size_t{ 2 }, graphColoringProb.getSmallestUnassignedDomainSize());
+			Assert::AreEqual(size_t{ 1 }, graphColoringProb.getSmallestDomainUnassignedVariablesIdxs().size());
+			Assert::AreEqual(qIdx, graphColoringProb.getSmallestDomainUnassignedVariablesIdxs().front());
+			Assert::IsTrue(q == csp::incrementalMinimumRemainingValues_primarySelector<std::string>(graphColoringProb).front());
+
+			// assigned variables leave the buckets
+			q.assignByIdx(0);
+			Assert::AreEqual(size_t{ 3 }, graphColoringProb.getSmallestUnassignedDomainSize());
+			Assert::AreEqual(size_t{ 6 }, graphColoringProb.getSmallestDomainUnassignedVariablesIdxs().size());
+			q.unassign();
+			Assert::AreEqual(size_t{ 2 }, graphColoringProb.getSmallestUnassignedDomainSize());
+
+			graphColoringProb.restoreTrail(trailMark);
+			Assert::AreEqual(size_t{ 3 }, graphColoringProb.getSmallestUnassignedDomainSize());
+			Assert::AreEqual(size_t{ 7 }, graphColoringProb.getSmallestDomainUnassignedVariablesIdxs().size());
+		}
+
 		TEST_METHOD(TestGetNeighbors)
 		{
 			const std::unordered_set<std::reference_wrapper<csp::Variable<std::string>>> saNeighbors{ NameToVarUMap.at("nt"), NameToVarUMap.at("q"),
@@ -336,6 +434,36 @@ namespace cspTests
 			Assert::IsTrue(vConstraints == graphColoringProb.getConstraintsContainingVariable(NameToVarUMap.at("v")));
 		}
 
+		TEST_METHOD(TestGetVariablesIdxsAndConstraintsIdxs)
+		{
+			const size_t saIdx = graphColoringProb.getVariableIdx(NameToVarUMap.at("sa"));
+			const size_t tIdx = graphColoringProb.getVariableIdx(NameToVarUMap.at("t"));
+			Assert::IsTrue(&graphColoringProb.getVariable(saIdx) == &NameToVarUMap.at("sa"));
+			Assert::IsTrue(&graphColoringProb.getConstraint(4) == &constr5);
+
+			Assert::AreEqual(size_t{ 5 }, graphColoringProb.getNeighborsIdxs(saIdx).size());
+			Assert::IsTrue(graphColoringProb.getNeighborsIdxs(tIdx).empty());
+			Assert::AreEqual(size_t{ 5 }, graphColoringProb.getConstraintsIdxsContainingVariable(saIdx).size());
+			for (size_t constrIdx : graphColoringProb.getConstraintsIdxsContainingVariable(saIdx))
+			{
+				Assert::IsTrue(graphColoringProb.getConstraint(constrIdx).getVariables().front().get() == NameToVarUMap.at("sa"));
+			}
+			Assert::AreEqual(size_t{ 1 }, graphColoringProb.getVariablesIdxsOfConstraint(9).size());
+			Assert::AreEqual(tIdx, graphColoringProb.getVariablesIdxsOfConstraint(9).front());
+		}
+
+		TEST_METHOD(TestGetSharedConstraintIdx)
+		{
+			const size_t saIdx = graphColoringProb.getVariableIdx(NameToVarUMap.at("sa"));
+			const size_t vIdx = graphColoringProb.getVariableIdx(NameToVarUMap.at("v"));
+			const size_t tIdx = graphColoringProb.getVariableIdx(NameToVarUMap.at("t"));
+			std::optional<size_t> optSharedConstrIdx = graphColoringProb.getSharedConstraintIdx(saIdx, vIdx);
+			Assert::IsTrue(optSharedConstrIdx.has_value());
+			Assert::IsTrue(&graphColoringProb.getConstraint(*optSharedConstrIdx) == &constr5);
+			Assert::IsTrue(graphColoringProb.getSharedConstraintIdx(vIdx, saIdx) == optSharedConstrIdx);
+			Assert::IsFalse(graphColoringProb.getSharedConstraintIdx(saIdx, tIdx).has_value());
+		}
+
 		TEST_METHOD(TestGetConsistentDomain)
 		{
 			NameToVarUMap.at("wa").assignByValue("Red");
@@ -351,6 +479,110 @@ namespace cspTests
 			Assert::IsTrue(consistentDomain2 == graphColoringProb.getConsistentDomain(NameToVarUMap.at("sa")));
 		}
 
+		TEST_METHOD(TestGetConsistentDomainSize)
+		{
+			Assert::AreEqual(size_t{ 3 }, graphColoringProb.getConsistentDomainSize(NameToVarUMap.at("sa")));
+
+			NameToVarUMap.at("wa").assignByValue("Red");
+			Assert::AreEqual(size_t{ 2 }, graphColoringProb.getConsistentDomainSize(NameToVarUMap.at("sa")));
+			Assert::AreEqual(size_t{ 2 }, graphColoringProb.getConsistentDomainSize(NameToVarUMap.at("nt")));
+
+			NameToVarUMap.at("nt").assignByValue("Green");
+			Assert::AreEqual(size_t{ 1 }, graphColoringProb.getConsistentDomainSize(NameToVarUMap.at("sa")));
+
+			NameToVarUMap.at("q").assignByValue("Blue");
+			Assert::AreEqual(size_t{ 0 }, graphColoringProb.getConsistentDomainSize(NameToVarUMap.at("sa")));
+			Assert::IsTrue(NameToVarUMap.at("q").getValue() == "Blue");
+		}
+
+		TEST_METHOD(TestTrail)
+		{
+			const std::vector<std::string> saOriginalDomain = NameToVarUMap.at("sa").getDomain();
+			const std::vector<std::string> qOriginalDomain = NameToVarUMap.at("q").getDomain();
+			const size_t trailMark = graphColoringProb.getTrailMark();
+
+			graphColoringProb.removeFromDomainByIdx(NameToVarUMap.at("sa"), 1);
+			graphColoringProb.removeFromDomainByValue(NameToVarUMap.at("q"), "Red");
+			Assert::IsTrue(graphColoringProb.setSubsetDomain(NameToVarUMap.at("sa"), { "Red" }));
+			Assert::IsFalse(graphColoringProb.setSubsetDomain(NameToVarUMap.at("q"), { "Red" }));
+			Assert::AreEqual(size_t{ 1 }, NameToVarUMap.at("sa").getDomain().size());
+			Assert::AreEqual(size_t{ 2 }, NameToVarUMap.at("q").getDomain().size());
+			Assert::AreEqual(trailMark + 3, graphColoringProb.getTrailMark());
+
+			graphColoringProb.restoreTrail(trailMark);
+			Assert::AreEqual(trailMark, graphColoringProb.getTrailMark());
+			Assert::IsTrue(saOriginalDomain == NameToVarUMap.at("sa").getDomain());
+			Assert::IsTrue(qOriginalDomain == NameToVarUMap.at("q").getDomain());
+		}
+
+		TEST_METHOD(TestGetConsistentDomainWithBitsetDomains)
+		{
+			csp::Variable<int> wa{ { 0, 1, 2 } };
+			csp::Variable<int> nt{ { 0, 1, 2 } };
+			csp::Variable<int> sa{ { 0, 1, 2 } };
+			csp::Constraint<int> waNt{ { wa, nt }, csp::allDiff<int> };
+			csp::Constraint<int> waSa{ { wa, sa }, csp::allDiff<int> };
+			csp::Constraint<int> ntSa{ { nt, sa }, csp::allDiff<int> };
+			csp::ConstraintProblem<int> intColoringProb{ { waNt, waSa, ntSa } };
+			intColoringProb.setBitsetDomains(true);
+			Assert::IsTrue(intColoringProb.isUsingBitsetDomains());
+			Assert::AreEqual(size_t{ 3 }, intColoringProb.getConsistentDomainSize(sa));
+
+			wa.assignByValue(0);
+			const std::vector<int> consistentDomain1{ 1, 2 };
+			Assert::IsTrue(consistentDomain1 == intColoringProb.getConsistentDomain(sa));
+			Assert::AreEqual(size_t{ 2 }, intColoringProb.getConsistentDomainSize(nt));
+
+			nt.assignByValue(1);
+			const std::vector<int> consistentDomain2{ 2 };
+			Assert::IsTrue(consistentDomain2 == intColoringProb.getConsistentDomain(sa));
+			Assert::IsFalse(intColoringProb.isConsistentDomainEmpty(sa));
+
+			intColoringProb.removeFromDomainByValue(sa, 2);
+			Assert::IsTrue(intColoringProb.isConsistentDomainEmpty(sa));
+			Assert::IsFalse(intColoringProb.isPotentiallySolvable());
+
+			intColoringProb.setBitsetDomains(false);
+			Assert::IsTrue(intColoringProb.isConsistentDomainEmpty(sa));
+		}
+
+		TEST_METHOD(TestBitsetDomainsFollowTrail)
+		{
+			csp::Variable<int> x{ { 3, 5, 7, 9 } };
+			csp::Variable<int> y{ { 3, 5, 7, 9 } };
+			csp::Constraint<int> xy{ { x, y }, csp::allDiff<int> };
+			csp::ConstraintProblem<int> intProb{ { xy } };
+			intProb.setBitsetDomains(true);
+			const size_t trailMark = intProb.getTrailMark();
+
+			csp::BitsetDomain<int> removedValues{ 3 };
+			removedValues.insert(5);
+			removedValues.insert(9);
+			intProb.removeFromDomain(x, removedValues);
+			intProb.removeFromDomainByIdx(y, 0);
+			const std::vector<int> xReducedDomain{ 3, 7 };
+			Assert::IsTrue(xReducedDomain == x.getDomain());
+			Assert::IsTrue(xReducedDomain == intProb.getBitsetDomain(x)->getValues());
+			Assert::AreEqual(size_t{ 3 }, intProb.getBitsetDomain(y)->size());
+			Assert::AreEqual(trailMark + 3, intProb.getTrailMark());
+
+			intProb.restoreTrail(trailMark);
+			const std::vector<int> originalDomain{ 3, 5, 7, 9 };
+			Assert::IsTrue(originalDomain == x.getDomain());
+			Assert::IsTrue(originalDomain == intProb.getBitsetDomain(x)->getValues());
+			Assert::IsTrue(originalDomain == intProb.getBitsetDomain(y)->getValues());
+		}
+
+		TEST_METHOD(TestBitsetDomainSizeError)
+		{
+			csp::Variable<int> wideDomainVar{ { 0, static_cast<int>(csp::BITSET_DOMAIN_MAX_SIZE) } };
+			csp::Constraint<int> wideDomainConstr{ { wideDomainVar }, csp::allDiff<int> };
+			csp::ConstraintProblem<int> wideDomainProb{ { wideDomainConstr } };
+			Assert::ExpectException<csp::bitset_domain_size_error<int>>([&]() -> void { wideDomainProb.setBitsetDomains(true); });
+			Assert::IsFalse(wideDomainProb.isUsingBitsetDomains());
+			Assert::IsTrue(wideDomainProb.getBitsetDomain(wideDomainVar) == nullptr);
+		}
+
 		// CSPDO: fix and rewrite this test
 		TEST_METHOD(TestGetCurrentAssignment)
 		{
@@ -155,7 +155,74 @@ namespace cspTests
 			Assert::IsTrue(constraint1.isSatisfied());
 		}
 
-		
+
+		TEST_METHOD(TestNestedConstraintEvaluation)
+		{
+			csp::Constraint<double> outerConstraint{ vars, [this](const std::vector<double>& values) -> bool
+				{
+					const std::vector<double> valuesBefore{ values };
+					bool innerConsistent = constraint2.isConsistent();
+					return innerConsistent && valuesBefore == values;
+				}
+			};
+			var1.assignByValue(1.0);
+			var2.assignByValue(1.0);
+			Assert::IsTrue(outerConstraint.isConsistent());
+			var3.assignByValue(2.5);
+			Assert::IsFalse(outerConstraint.isSatisfied());
+		}
+
+		TEST_METHOD(TestAllDiffAndAllEqual)
+		{
+			std::vector<double> values;
+			for (size_t i = 0; i < 2 * csp::ALL_DIFF_PAIRWISE_SIZE_LIMIT; ++i)
+			{
+				values.push_back(static_cast<double>(i));
+			}
+			Assert::IsTrue(csp::allDiff<double>(values));
+			Assert::IsFalse(csp::allEqual<double>(values));
+			values.push_back(7.0);
+			Assert::IsFalse(csp::allDiff<double>(values));
+
+			const std::vector<double> fewValues{ 1.0, 2.5, 1.0 };
+			Assert::IsFalse(csp::allDiff<double>(fewValues));
+			Assert::IsTrue(csp::allEqual<double>(std::vector<double>{ 2.5 }));
+			Assert::IsTrue(csp::allEqual<double>(std::vector<double>{ }));
+		}
+
+		TEST_METHOD(TestBuiltInConstraintEvaluators)
+		{
+			Assert::IsFalse(constraint1.hasBuiltInConstraintEvaluator());
+			csp::Constraint<double> allDiffConstraint{ vars, csp::allDiff<double> };
+			Assert::IsTrue(allDiffConstraint.hasBuiltInConstraintEvaluator());
+			csp::Constraint<double> allEqualConstraint{ vars, csp::AllEqual<double>{ } };
+			Assert::IsTrue(allEqualConstraint.hasBuiltInConstraintEvaluator());
+			std::vector<std::reference_wrapper<csp::Variable<double>>> twoVars{ var1, var2 };
+			csp::Constraint<double> queensConstraint{ twoVars, csp::NotAttackingQueens<double>{ 3.0 } };
+
+			var1.assignByValue(2.5);
+			var2.assignByValue(2.5);
+			Assert::IsFalse(allDiffConstraint.isConsistent());
+			Assert::IsTrue(allEqualConstraint.isConsistent());
+			Assert::IsFalse(allEqualConstraint.isSatisfied());
+			Assert::IsFalse(queensConstraint.isConsistent());
+			var2.unassign();
+			var2.assignByValue(3.7);
+			Assert::IsTrue(allDiffConstraint.isConsistent());
+			Assert::IsTrue(queensConstraint.isConsistent());
+			var2.unassign();
+			var2.assignByValue(5.5);
+			Assert::IsFalse(queensConstraint.isConsistent());
+			var1.unassign();
+			var1.assignByValue(1.0);
+			Assert::IsTrue(queensConstraint.isSatisfied());
+
+			// the type-erased view of a built-in evaluator evaluates alike
+			Assert::IsTrue(queensConstraint.getConstraintEvaluator()(std::vector<double>{ 1.0, 3.7 }));
+			Assert::IsFalse(queensConstraint.getConstraintEvaluator()(std::vector<double>{ 1.0, 4.0 }));
+			Assert::IsFalse(allEqualConstraint.getConstraintEvaluator()(std::vector<double>{ 1.0, 3.7 }));
+		}
+
 		TEST_METHOD(TestEnforceUnaryConstraint)
 		{
 			std::unordered_set<double> expectedDomain{ 1.0, 2.5, 3.7, 4.2 };
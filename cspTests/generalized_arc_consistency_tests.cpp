@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <csp.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace cspTests
+{
+	TEST_CLASS(GeneralizedArcConsistencyTests)
+	{
+	public:
+		csp::Variable<int> x{ { 1, 2 } };
+		csp::Variable<int> y{ { 1, 2 } };
+		csp::Variable<int> z{ { 1, 2, 3, 4, 5 } };
+		csp::Constraint<int> sumConstr{ { x, y, z }, [](const std::vector<int>& values) -> bool
+			{
+				if (values.size() < 3)
+				{
+					return true;
+				}
+				return values[0] + values[1] == values[2];
+			}
+		};
+		csp::ConstraintProblem<int> sumProb{ { sumConstr } };
+
+		csp::Variable<int> u{ { 1, 2 } };
+		csp::Variable<int> v{ { 1, 2 } };
+		csp::Variable<int> w{ { 1, 2 } };
+		csp::Constraint<int> pigeonholeConstr{ { u, v, w }, csp::allDiff<int> };
+		csp::ConstraintProblem<int> pigeonholeProb{ { pigeonholeConstr } };
+
+		TEST_METHOD_INITIALIZE(GeneralizedArcConsistencySetUp)
+		{
+			sumProb.unassignAllVariables();
+			pigeonholeProb.unassignAllVariables();
+		}
+
+		TEST_METHOD(TestGAC3PrunesTernaryConstraint)
+		{
+			Assert::IsTrue(csp::gac3(sumProb));
+			std::vector<int> zDomain = z.getDomain();
+			std::sort(zDomain.begin(), zDomain.end());
+			Assert::IsTrue(zDomain == std::vector<int>{ 2, 3, 4 });
+			Assert::AreEqual(size_t{ 2 }, x.getDomain().size());
+			// preprocessing prunes permanently, hence nothing is left on the trail
+			Assert::AreEqual(size_t{ 0 }, sumProb.getTrailMark());
+		}
+
+		TEST_METHOD(TestMaintainingGACPrunesAssignedVariableConstraints)
+		{
+			const size_t trailMark = sumProb.getTrailMark();
+			z.assignByValue(4);
+			Assert::IsTrue(csp::maintainingGAC(sumProb, z));
+			Assert::IsTrue(x.getDomain() == std::vector<int>{ 2 });
+			Assert::IsTrue(y.getDomain() == std::vector<int>{ 2 });
+			sumProb.restoreTrail(trailMark);
+			z.unassign();
+			z.assignByValue(5);
+			Assert::IsFalse(csp::maintainingGAC(sumProb, z));
+			sumProb.restoreTrail(trailMark);
+		}
+
+		TEST_METHOD(TestGAC3DetectsPigeonhole)
+		{
+			Assert::IsFalse(csp::gac3(pigeonholeProb));
+		}
+
+		TEST_METHOD(TestGACInferenceReusesResidues)
+		{
+			const int n = 5;
+			std::unordered_set<int> domain;
+			for (int i = 0; i < n; ++i)
+			{
+				domain.emplace(i);
+			}
+			std::vector<csp::Variable<int>> cells;
+			cells.reserve(n * n);
+			for (int i = 0; i < n * n; ++i)
+			{
+				cells.emplace_back(domain);
+			}
+			std::vector<csp::Constraint<int>> constraints;
+			for (int i = 0; i < n; ++i)
+			{
+				std::vector<std::reference_wrapper<csp::Variable<int>>> rowVars;
+				std::vector<std::reference_wrapper<csp::Variable<int>>> colVars;
+				for (int j = 0; j < n; ++j)
+				{
+					rowVars.emplace_back(cells[i * n + j]);
+					colVars.emplace_back(cells[j * n + i]);
+				}
+				constraints.emplace_back(rowVars, csp::allDiff<int>);
+				constraints.emplace_back(colVars, csp::allDiff<int>);
+			}
+			std::vector<std::reference_wrapper<csp::Constraint<int>>> constraintsRefs{ constraints.begin(), constraints.end() };
+			csp::ConstraintProblem<int> latinSquareProb{ constraintsRefs };
+
+			csp::GeneralizedArcConsistency<int> generalizedArcConsistency;
+			Assert::IsTrue(generalizedArcConsistency.enforce(latinSquareProb));
+			size_t preprocessingChecksCount = generalizedArcConsistency.getConstraintChecksCount();
+			Assert::IsTrue(0 < preprocessingChecksCount);
+
+			// the inference is copied into the solver, hence its residues are kept along the search
+			csp::heuristicBacktrackingSolver<int>(latinSquareProb,
+				csp::minimumRemainingValues_primarySelector<int>,
+				csp::degreeHeuristic_secondarySelector<int>,
+				std::optional<csp::DomainSorter<int>>{},
+				generalizedArcConsistency);
+			Assert::IsTrue(latinSquareProb.isCompletelyConsistentlyAssigned());
+		}
+	};
+}
\ No newline at end of file
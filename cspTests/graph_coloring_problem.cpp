@@ -77,6 +77,41 @@ namespace cspTests
 			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
 		}
 
+		TEST_METHOD(TestMACHeuristicBacktrackingRestoresDomains)
+		{
+			const csp::AssignmentHistory<std::string> assignmentHistory = csp::heuristicBacktrackingSolver<std::string>(graphColoringProb,
+				csp::minimumRemainingValues_primarySelector<std::string>,
+				csp::degreeHeuristic_secondarySelector<std::string>,
+				csp::leastConstrainingValue<std::string>,
+				csp::mac<std::string>);
+			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
+			for (const csp::Variable<std::string>& var : graphColoringProb.getVariables())
+			{
+				Assert::AreEqual(domain.size(), var.getDomain().size());
+			}
+			Assert::AreEqual(size_t{ 0 }, graphColoringProb.getTrailMark());
+		}
+
+		TEST_METHOD(TestLeastConstrainingValueBySupportsOrder)
+		{
+			NameToVarUMap.at("wa").assignByValue("Red");
+			NameToVarUMap.at("nsw").assignByValue("Green");
+			// q = Red leaves Blue to sa and Green, Blue to nt, while q = Blue leaves only Green to nt
+			const std::vector<std::string> sortedDomain =
+				csp::leastConstrainingValueBySupports<std::string>(graphColoringProb, NameToVarUMap.at("q"));
+			Assert::IsTrue(sortedDomain == std::vector<std::string>{ "Red", "Blue" });
+		}
+
+		TEST_METHOD(TestSampledLeastConstrainingValueBySupportsHeuristicBacktracking)
+		{
+			const csp::AssignmentHistory<std::string> assignmentHistory = csp::heuristicBacktrackingSolver<std::string>(graphColoringProb,
+				csp::minimumRemainingValues_primarySelector<std::string>,
+				csp::degreeHeuristic_secondarySelector<std::string>,
+				csp::LeastConstrainingValueBySupports<std::string>{ 2 },
+				csp::mac<std::string>);
+			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
+		}
+
 		TEST_METHOD(TestMinConflicts)
 		{
 			//	CSPDO: test with tabu
@@ -88,6 +123,41 @@ namespace cspTests
 		{
 			const csp::AssignmentHistory<std::string> assignmentHistory = csp::constraintWeighting<std::string>(graphColoringProb, 1000);
 			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
+			Assert::IsTrue(assignmentHistory.empty());
+		}
+
+		TEST_METHOD(TestConstraintWeightingHistoryStartsWithStartAssignment)
+		{
+			const csp::AssignmentHistory<std::string> assignmentHistory = csp::constraintWeighting<std::string>(graphColoringProb,
+				1000, true);
+			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
+			const size_t variablesSize = graphColoringProb.getVariables().size();
+			Assert::IsTrue(variablesSize <= assignmentHistory.size());
+			for (size_t i = 0; i < variablesSize; ++i)
+			{
+				Assert::IsTrue(assignmentHistory[i].first.get() == graphColoringProb.getVariables()[i].get());
+				Assert::IsTrue(assignmentHistory[i].second.has_value());
+			}
+		}
+
+		TEST_METHOD(TestConstraintWeightingOfBigProblem)
+		{
+			// a ring in which every vertex is also adjacent to the vertex after the next one, 3-colorable by i % 3
+			const size_t verticesSize = 300;
+			std::vector<csp::Variable<std::string>> vertices(verticesSize, csp::Variable<std::string>{ domain });
+			std::vector<csp::Constraint<std::string>> edges;
+			edges.reserve(2 * verticesSize);
+			for (size_t i = 0; i < verticesSize; ++i)
+			{
+				edges.emplace_back(std::vector<std::reference_wrapper<csp::Variable<std::string>>>{ vertices[i],
+					vertices[(i + 1) % verticesSize] }, csp::allDiff<std::string>);
+				edges.emplace_back(std::vector<std::reference_wrapper<csp::Variable<std::string>>>{ vertices[i],
+					vertices[(i + 2) % verticesSize] }, csp::allDiff<std::string>);
+			}
+			std::vector<std::reference_wrapper<csp::Constraint<std::string>>> edgesRefs{ edges.begin(), edges.end() };
+			csp::ConstraintProblem<std::string> ringColoringProb{ edgesRefs };
+			csp::constraintWeighting<std::string>(ringColoringProb, 100000);
+			Assert::IsTrue(ringColoringProb.isCompletelyConsistentlyAssigned());
 		}
 
 		TEST_METHOD(TestHillClimbing)
@@ -99,6 +169,59 @@ namespace cspTests
 			Assert::IsTrue(bestProb.isCompletelyConsistentlyAssigned());
 		}
 
+		TEST_METHOD(TestParallelHillClimbing)
+		{
+			std::vector<csp::Variable<std::string>> bestVars;
+			std::vector<csp::Constraint<std::string>> bestConstraints;
+			csp::ConstraintProblem<std::string> bestProb = csp::parallelRandomRestartFirstChoiceHillClimbing(graphColoringProb,
+				bestConstraints, bestVars, 100, 100, 100);
+			Assert::IsTrue(bestProb.isCompletelyConsistentlyAssigned());
+			Assert::IsTrue(graphColoringProb.isCompletelyUnassigned());
+		}
+
+		TEST_METHOD(TestParallelHillClimbingIsDeterministicPerSeed)
+		{
+			std::vector<std::vector<std::string>> assignmentsValues;
+			for (unsigned int threadsAmount : { 1, 3 })
+			{
+				std::vector<csp::Variable<std::string>> bestVars;
+				std::vector<csp::Constraint<std::string>> bestConstraints;
+				csp::ConstraintProblem<std::string> bestProb = csp::parallelRandomRestartFirstChoiceHillClimbing(graphColoringProb,
+					bestConstraints, bestVars, 10, 3, 2, csp::generateStartStateRandomly<std::string>,
+					csp::alterRandomVariableValuePair<std::string>, csp::consistentConstraintsAmount<std::string>,
+					csp::ScoreDeltaCalculator<std::string>{ }, 7, threadsAmount);
+				assignmentsValues.emplace_back();
+				for (const csp::Variable<std::string>& var : bestVars)
+				{
+					assignmentsValues.back().push_back(var.getValue());
+				}
+			}
+			Assert::IsTrue(assignmentsValues[0] == assignmentsValues[1]);
+		}
+
+		TEST_METHOD(TestParallelHillClimbingRethrowsWorkerException)
+		{
+			std::atomic<unsigned int> startStatesAmount{ 0 };
+			csp::StartStateGenarator<std::string> throwingOnThirdRestart = [&startStatesAmount](
+				csp::ConstraintProblem<std::string>& constraintProblem, std::default_random_engine& defaultRandomEngine) -> void
+			{
+				if (++startStatesAmount == 3)
+				{
+					throw std::runtime_error{ "start state failure" };
+				}
+				csp::generateStartStateRandomly<std::string>(constraintProblem, defaultRandomEngine);
+			};
+			std::vector<csp::Variable<std::string>> bestVars;
+			std::vector<csp::Constraint<std::string>> bestConstraints;
+			Assert::ExpectException<std::runtime_error>([&]() -> void
+				{
+					csp::parallelRandomRestartFirstChoiceHillClimbing(graphColoringProb, bestConstraints, bestVars, 100, 1, 1,
+						throwingOnThirdRestart, csp::alterRandomVariableValuePair<std::string>, csp::consistentConstraintsAmount<std::string>,
+						csp::ScoreDeltaCalculator<std::string>{ }, 7, 4);
+				});
+			Assert::IsTrue(graphColoringProb.isCompletelyUnassigned());
+		}
+
 		TEST_METHOD(TestSimulatedAnnealing)
 		{
 			std::vector<csp::Variable<std::string>> bestVars;
@@ -108,6 +231,87 @@ namespace cspTests
 			Assert::IsTrue(bestProb.isCompletelyConsistentlyAssigned());
 		}
 
+		TEST_METHOD(TestParallelTempering)
+		{
+			const std::vector<csp::CoolingSchedule> coolingSchedules{ csp::geometricCooling(1.0), csp::geometricCooling(0.9),
+				csp::adaptiveCooling(0.9, 0.3), csp::reheatingCooling(0.9, 5) };
+			for (const csp::CoolingSchedule& coolingSchedule : coolingSchedules)
+			{
+				std::vector<csp::Variable<std::string>> bestVars;
+				std::vector<csp::Constraint<std::string>> bestConstraints;
+				csp::ConstraintProblem<std::string> bestProb = csp::parallelTempering(graphColoringProb,
+					bestConstraints, bestVars, 1000, 4, 0.1, 2.0, 50, coolingSchedule);
+				Assert::IsTrue(bestProb.isCompletelyConsistentlyAssigned());
+				Assert::IsTrue(graphColoringProb.isCompletelyUnassigned());
+			}
+
+			// an epoch per step
+			std::vector<csp::Variable<std::string>> bestVars;
+			std::vector<csp::Constraint<std::string>> bestConstraints;
+			csp::ConstraintProblem<std::string> bestProb = csp::parallelTempering(graphColoringProb,
+				bestConstraints, bestVars, 1000, 4, 0.1, 2.0, 1);
+			Assert::IsTrue(bestProb.isCompletelyConsistentlyAssigned());
+		}
+
+		TEST_METHOD(TestParallelTemperingInvalidTemperaturesError)
+		{
+			std::vector<csp::Variable<std::string>> bestVars;
+			std::vector<csp::Constraint<std::string>> bestConstraints;
+			Assert::ExpectException<csp::invalid_temperatures_error<std::string>>([&]() -> void
+				{
+					csp::parallelTempering(graphColoringProb, bestConstraints, bestVars, 1000, 4, 0.0, 2.0, 50);
+				});
+			Assert::ExpectException<csp::invalid_temperatures_error<std::string>>([&]() -> void
+				{
+					csp::parallelTempering(graphColoringProb, bestConstraints, bestVars, 1000, 4, 2.0, 0.1, 50);
+				});
+			Assert::IsTrue(graphColoringProb.isCompletelyUnassigned());
+		}
+
+		TEST_METHOD(TestLocalSearchLeavesSourceProblemUnassigned)
+		{
+			std::vector<csp::Variable<std::string>> bestVars;
+			std::vector<csp::Constraint<std::string>> bestConstraints;
+			csp::ConstraintProblem<std::string> bestProb = csp::simulatedAnnealing(graphColoringProb,
+				bestConstraints, bestVars, 1000, 0.5, 0.99999);
+			Assert::IsTrue(graphColoringProb.isCompletelyUnassigned());
+			Assert::AreEqual(graphColoringProb.getVariables().size(), bestVars.size());
+
+			// a reassignment applied in place is reverted by the reassignment it returns
+			std::default_random_engine defaultRandomEngine{ 0 };
+			csp::Reassignment reassignment = csp::alterRandomVariableValuePair<std::string>(bestProb, defaultRandomEngine);
+			csp::Variable<std::string>& var = bestProb.getVariable(reassignment.varIdx);
+			const std::string value = var.getValue();
+			csp::Reassignment revertingReassignment = csp::applyReassignment<std::string>(bestProb, reassignment);
+			Assert::AreNotEqual(value, var.getValue());
+			csp::applyReassignment<std::string>(bestProb, revertingReassignment);
+			Assert::AreEqual(value, var.getValue());
+		}
+
+		TEST_METHOD(TestConsistentConstraintsAmountDelta)
+		{
+			std::vector<csp::Variable<std::string>> copiedVars;
+			std::vector<csp::Constraint<std::string>> copiedConstraints;
+			csp::ConstraintProblem<std::string> copiedProb = graphColoringProb.deepCopy(copiedVars, copiedConstraints);
+			std::default_random_engine defaultRandomEngine{ 0 };
+			csp::generateStartStateRandomly<std::string>(copiedProb, defaultRandomEngine);
+
+			const csp::ScoreDeltaCalculator<std::string> calculateScoreDelta =
+				csp::getScoreDeltaCalculator<std::string>(csp::consistentConstraintsAmount<std::string>);
+			Assert::IsTrue(static_cast<bool>(calculateScoreDelta));
+			Assert::IsFalse(static_cast<bool>(csp::getScoreDeltaCalculator<std::string>(
+				[](csp::ConstraintProblem<std::string>& constraintProblem) -> unsigned int { return 0; })));
+			for (unsigned int i = 0; i < 100; ++i)
+			{
+				csp::Reassignment reassignment = csp::alterRandomVariableValuePair<std::string>(copiedProb, defaultRandomEngine);
+				int scoreBefore = static_cast<int>(csp::consistentConstraintsAmount(copiedProb));
+				int delta = calculateScoreDelta(copiedProb, reassignment);
+				Assert::AreEqual(scoreBefore, static_cast<int>(csp::consistentConstraintsAmount(copiedProb)));
+				csp::applyReassignment<std::string>(copiedProb, reassignment);
+				Assert::AreEqual(scoreBefore + delta, static_cast<int>(csp::consistentConstraintsAmount(copiedProb)));
+			}
+		}
+
 		TEST_METHOD(TestGeneralGeneticConstraintProblem)
 		{
 			csp::GeneralGeneticConstraintProblem<std::string> graphColoringGeneticProb{ graphColoringProb, 0.1 };
@@ -129,5 +333,206 @@ namespace cspTests
 			const csp::AssignmentHistory<std::string> assignmentHistory = csp::naiveCycleCutset(easierGraphColoringProb, true);
 			Assert::IsTrue(easierGraphColoringProb.isCompletelyConsistentlyAssigned());
 		}
+
+		TEST_METHOD(TestPortfolioSolver)
+		{
+			const std::vector<csp::SolverConfiguration<std::string>> solverConfigurations{
+				[](csp::ConstraintProblem<std::string>& problem) -> void
+				{
+					csp::heuristicBacktrackingSolver<std::string>(problem,
+						csp::minimumRemainingValues_primarySelector<std::string>,
+						csp::degreeHeuristic_secondarySelector<std::string>,
+						csp::leastConstrainingValue<std::string>);
+				},
+				[](csp::ConstraintProblem<std::string>& problem) -> void { csp::minConflicts<std::string>(problem, 1000); },
+				[](csp::ConstraintProblem<std::string>& problem) -> void
+				{
+					std::vector<csp::Variable<std::string>> bestVars;
+					std::vector<csp::Constraint<std::string>> bestConstraints;
+					csp::ConstraintProblem<std::string> bestProb = csp::simulatedAnnealing(problem, bestConstraints, bestVars,
+						1000, 0.5, 0.99999);
+					csp::assignFromProblemCopy(problem, bestProb);
+				}
+			};
+			std::optional<size_t> optSolvingConfigIdx = csp::portfolioSolver(graphColoringProb, solverConfigurations, 3);
+			Assert::IsTrue(optSolvingConfigIdx.has_value());
+			Assert::IsTrue(*optSolvingConfigIdx < solverConfigurations.size());
+			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
+		}
+
+		TEST_METHOD(TestPortfolioSolverCancelsOtherConfigurations)
+		{
+			const std::vector<csp::SolverConfiguration<std::string>> solverConfigurations{
+				// would never return if it was not cancelled
+				[](csp::ConstraintProblem<std::string>& problem) -> void
+				{
+					while (!problem.isStopRequested())
+					{
+						std::this_thread::yield();
+					}
+				},
+				[](csp::ConstraintProblem<std::string>& problem) -> void { csp::backtrackingSolver<std::string>(problem); }
+			};
+			std::optional<size_t> optSolvingConfigIdx = csp::portfolioSolver(graphColoringProb, solverConfigurations, 2);
+			Assert::IsTrue(optSolvingConfigIdx == std::optional<size_t>{ 1 });
+			Assert::IsTrue(graphColoringProb.isCompletelyConsistentlyAssigned());
+
+			// an unsolvable configuration
+			graphColoringProb.unassignAllVariables();
+			const std::vector<csp::SolverConfiguration<std::string>> failingConfigurations{
+				[](csp::ConstraintProblem<std::string>& problem) -> void { }
+			};
+			Assert::IsFalse(csp::portfolioSolver(graphColoringProb, failingConfigurations).has_value());
+		}
+
+		TEST_METHOD(TestParallelFindAllSolutions)
+		{
+			const std::unordered_set<csp::Assignment<std::string>> sequentialSolutions =
+				csp::heuristicBacktrackingSolver_findAllSolutions<std::string>(graphColoringProb,
+					csp::minimumRemainingValues_primarySelector<std::string>,
+					csp::degreeHeuristic_secondarySelector<std::string>,
+					csp::leastConstrainingValue<std::string>,
+					csp::forwardChecking<std::string>);
+			// 6 colorings of the mainland, times 3 colors of tasmania
+			Assert::AreEqual(size_t{ 18 }, sequentialSolutions.size());
+
+			for (unsigned int threadsAmount : { 1, 3, 8 })
+			{
+				const std::unordered_set<csp::Assignment<std::string>> parallelSolutions =
+					csp::parallelHeuristicBacktrackingSolver_findAllSolutions<std::string>(graphColoringProb,
+						csp::minimumRemainingValues_primarySelector<std::string>,
+						csp::degreeHeuristic_secondarySelector<std::string>,
+						csp::leastConstrainingValue<std::string>,
+						csp::forwardChecking<std::string>,
+						threadsAmount);
+				Assert::IsTrue(parallelSolutions == sequentialSolutions);
+				Assert::IsTrue(csp::parallelBacktrackingSolver_findAllSolutions(graphColoringProb, threadsAmount) == sequentialSolutions);
+			}
+			Assert::IsTrue(graphColoringProb.getUnassignedVariables().size() == graphColoringProb.getVariables().size());
+		}
+
+		TEST_METHOD(TestParallelFindAllSolutionsWithStatefulHeuristics)
+		{
+			// every worker runs its own copies of the residues and support tables
+			const std::unordered_set<csp::Assignment<std::string>> parallelSolutions =
+				csp::parallelHeuristicBacktrackingSolver_findAllSolutions<std::string>(graphColoringProb,
+					csp::minimumRemainingValues_primarySelector<std::string>,
+					csp::degreeHeuristic_secondarySelector<std::string>,
+					csp::LeastConstrainingValueBySupports<std::string>{ },
+					csp::ArcConsistency3rm<std::string>{ },
+					4);
+			Assert::AreEqual(size_t{ 18 }, parallelSolutions.size());
+		}
+
+		TEST_METHOD(TestParallelFindAllSolutionsRethrowsWorkerException)
+		{
+			// the search tree is split on graphColoringProb itself, hence only the workers' copies throw
+			const csp::ConstraintProblem<std::string>* pGraphColoringProb = &graphColoringProb;
+			csp::Inference<std::string> throwingOnCopies = [pGraphColoringProb](csp::ConstraintProblem<std::string>& constraintProblem,
+				csp::Variable<std::string>& assignedVariable) -> bool
+			{
+				if (&constraintProblem != pGraphColoringProb)
+				{
+					throw std::runtime_error{ "inference failure" };
+				}
+				return csp::forwardChecking<std::string>(constraintProblem, assignedVariable);
+			};
+			Assert::ExpectException<std::runtime_error>([&]() -> void
+				{
+					csp::parallelHeuristicBacktrackingSolver_findAllSolutions<std::string>(graphColoringProb,
+						csp::minimumRemainingValues_primarySelector<std::string>,
+						csp::degreeHeuristic_secondarySelector<std::string>,
+						std::optional<csp::DomainSorter<std::string>>{},
+						throwingOnCopies,
+						3);
+				});
+			Assert::IsTrue(graphColoringProb.isCompletelyUnassigned());
+		}
+
+		TEST_METHOD(TestCountAndForEachSolution)
+		{
+			Assert::AreEqual(uint64_t{ 18 }, csp::backtrackingSolver_countAllSolutions(graphColoringProb));
+			Assert::AreEqual(uint64_t{ 18 }, csp::heuristicBacktrackingSolver_countAllSolutions<std::string>(graphColoringProb,
+				csp::minimumRemainingValues_primarySelector<std::string>,
+				csp::degreeHeuristic_secondarySelector<std::string>,
+				csp::leastConstrainingValue<std::string>,
+				csp::mac<std::string>));
+
+			std::unordered_set<csp::Assignment<std::string>> visitedSolutions;
+			csp::SolutionVisitor<std::string> insertSolution = [&visitedSolutions](const csp::ConstraintProblem<std::string>& solvedProblem)
+			{
+				Assert::IsTrue(solvedProblem.isCompletelyConsistentlyAssigned());
+				visitedSolutions.emplace(solvedProblem.getCurrentAssignment());
+			};
+			csp::backtrackingSolver_forEachSolution(graphColoringProb, insertSolution);
+			Assert::IsTrue(visitedSolutions == csp::backtrackingSolver_findAllSolutions(graphColoringProb));
+
+			size_t visitsCount = 0;
+			csp::heuristicBacktrackingSolver_forEachSolution<std::string>(graphColoringProb,
+				[&visitsCount](const csp::ConstraintProblem<std::string>& solvedProblem)
+				{
+					Assert::IsTrue(solvedProblem.isCompletelyConsistentlyAssigned());
+					++visitsCount;
+				},
+				csp::minimumRemainingValues_primarySelector<std::string>);
+			Assert::AreEqual(size_t{ 18 }, visitsCount);
+			Assert::IsTrue(graphColoringProb.getUnassignedVariables().size() == graphColoringProb.getVariables().size());
+		}
+
+		TEST_METHOD(TestSolutionsGenerator)
+		{
+			// values rather than assignments, since the assignment indices are relative to domains which the inference pruned
+			auto getValues = [](const csp::ConstraintProblem<std::string>& solvedProblem) -> std::string
+			{
+				std::string values;
+				for (const csp::Variable<std::string>& var : solvedProblem.getVariables())
+				{
+					values += var.getValue() + ',';
+				}
+				return values;
+			};
+			std::unordered_set<std::string> allSolutions;
+			csp::backtrackingSolver_forEachSolution<std::string>(graphColoringProb,
+				[&allSolutions, &getValues](const csp::ConstraintProblem<std::string>& solvedProblem)
+				{
+					allSolutions.emplace(getValues(solvedProblem));
+				});
+			Assert::AreEqual(size_t{ 18 }, allSolutions.size());
+			{
+				csp::SolutionsGenerator<std::string> solutionsGenerator{ graphColoringProb,
+					csp::minimumRemainingValues_primarySelector<std::string>,
+					csp::degreeHeuristic_secondarySelector<std::string>,
+					csp::leastConstrainingValue<std::string>,
+					csp::mac<std::string> };
+				std::unordered_set<std::string> generatedSolutions;
+				for (const csp::ConstraintProblem<std::string>& solvedProblem : solutionsGenerator)
+				{
+					Assert::IsTrue(solvedProblem.isCompletelyConsistentlyAssigned());
+					Assert::IsTrue(generatedSolutions.emplace(getValues(solvedProblem)).second);
+				}
+				Assert::IsTrue(generatedSolutions == allSolutions);
+				Assert::IsFalse(solutionsGenerator.next());
+			}
+			Assert::IsTrue(graphColoringProb.getUnassignedVariables().size() == graphColoringProb.getVariables().size());
+
+			// stopping early restores the problem as well
+			{
+				csp::SolutionsGenerator<std::string> solutionsGenerator{ graphColoringProb,
+					csp::minimumRemainingValues_primarySelector<std::string>,
+					csp::degreeHeuristic_secondarySelector<std::string>,
+					std::optional<csp::DomainSorter<std::string>>{},
+					csp::forwardChecking<std::string> };
+				for (int i = 0; i < 3; ++i)
+				{
+					Assert::IsTrue(solutionsGenerator.next());
+					Assert::IsTrue(allSolutions.count(getValues(graphColoringProb)) == 1);
+				}
+			}
+			Assert::IsTrue(graphColoringProb.getUnassignedVariables().size() == graphColoringProb.getVariables().size());
+			for (const csp::Variable<std::string>& var : graphColoringProb.getVariables())
+			{
+				Assert::AreEqual(size_t{ 3 }, var.getDomain().size());
+			}
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include <csp.h>
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+namespace cspTests
+{
+	TEST_CLASS(LinearSumTests)
+	{
+	public:
+		const std::unordered_set<int> domain{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		csp::Variable<int> x{ domain };
+		csp::Variable<int> y{ domain };
+		csp::Variable<int> z{ domain };
+		csp::Constraint<int> equalityConstr{ { x, y, z }, csp::LinearSum<int>{ { 2, 3, -1 }, csp::LinearRelation::EQUAL, 10 } };
+		csp::ConstraintProblem<int> equalityProb{ { equalityConstr } };
+
+		csp::Variable<int> s{ domain };
+		csp::Variable<int> t{ domain };
+		csp::Constraint<int> inequalityConstr{ { s, t }, csp::LinearSum<int>{ { 1, 1 }, csp::LinearRelation::LESS_EQUAL, 5 } };
+		csp::Constraint<int> exactSumConstr{ { s, t }, csp::ExactLengthExactSum<int>{ 2, 12 } };
+		csp::ConstraintProblem<int> inequalityProb{ { inequalityConstr } };
+		csp::ConstraintProblem<int> exactSumProb{ { exactSumConstr } };
+
+		TEST_METHOD_INITIALIZE(LinearSumSetUp)
+		{
+			equalityProb.unassignAllVariables();
+			inequalityProb.unassignAllVariables();
+		}
+
+		TEST_METHOD(TestLinearSumEvaluator)
+		{
+			csp::LinearSum<unsigned int> linearSum{ { 2, -1, -10 }, csp::LinearRelation::EQUAL, 0 };
+			Assert::IsTrue(linearSum(std::vector<unsigned int>{ 7 }));
+			Assert::IsTrue(linearSum(std::vector<unsigned int>{ 7, 4, 1 }));
+			Assert::IsFalse(linearSum(std::vector<unsigned int>{ 7, 3, 1 }));
+			Assert::IsTrue(csp::isLinearSumConstraint(equalityConstr));
+			Assert::IsTrue(csp::isLinearSumConstraint(exactSumConstr));
+		}
+
+		TEST_METHOD(TestLinearSumArityError)
+		{
+			Assert::ExpectException<csp::linear_sum_arity_error<int>>([this]() -> void
+				{
+					csp::Constraint<int> tooManyCoefficientsConstr{ { s, t },
+						csp::LinearSum<int>{ { 1, 1, 1 }, csp::LinearRelation::EQUAL, 5 } };
+				});
+			Assert::ExpectException<std::invalid_argument>([this]() -> void
+				{
+					csp::Constraint<int> tooFewCoefficientsConstr{ { x, y, z },
+						csp::LinearSum<int>{ { 1, 1 }, csp::LinearRelation::EQUAL, 5 } };
+				});
+		}
+
+		TEST_METHOD(TestEqualityBoundsPropagation)
+		{
+			const size_t trailMark = equalityProb.getTrailMark();
+			x.assignByValue(4);
+			Assert::IsTrue(csp::linearSumBoundsPropagation(equalityProb, x));
+			// 3y - z == 2
+			std::vector<int> yDomain = y.getDomain();
+			std::sort(yDomain.begin(), yDomain.end());
+			Assert::IsTrue(yDomain == std::vector<int>{ 1, 2, 3 });
+			Assert::AreEqual(7, *std::max_element(z.getDomain().cbegin(), z.getDomain().cend()));
+			equalityProb.restoreTrail(trailMark);
+			Assert::AreEqual(size_t{ 9 }, y.getDomain().size());
+		}
+
+		TEST_METHOD(TestInequalityBoundsPropagation)
+		{
+			const size_t trailMark = inequalityProb.getTrailMark();
+			s.assignByValue(4);
+			Assert::IsTrue(csp::linearSumBoundsPropagation(inequalityProb, s));
+			Assert::IsTrue(t.getDomain() == std::vector<int>{ 1 });
+			inequalityProb.restoreTrail(trailMark);
+			s.unassign();
+			s.assignByValue(5);
+			Assert::IsFalse(csp::linearSumBoundsPropagation(inequalityProb, s));
+			inequalityProb.restoreTrail(trailMark);
+		}
+
+		TEST_METHOD(TestExactLengthExactSumPropagation)
+		{
+			const size_t trailMark = exactSumProb.getTrailMark();
+			s.assignByValue(4);
+			Assert::IsTrue(csp::linearSumBoundsPropagation(exactSumProb, s));
+			Assert::IsTrue(t.getDomain() == std::vector<int>{ 8 });
+			exactSumProb.restoreTrail(trailMark);
+			s.unassign();
+		}
+
+		TEST_METHOD(TestSendMoreMoneyWithGlobalConstraintsPropagation)
+		{
+			// SEND + MORE == MONEY
+			const std::unordered_set<int> digits{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+			const std::unordered_set<int> leadingDigits{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+			csp::Variable<int> sVar{ leadingDigits };
+			csp::Variable<int> eVar{ digits };
+			csp::Variable<int> nVar{ digits };
+			csp::Variable<int> dVar{ digits };
+			csp::Variable<int> mVar{ leadingDigits };
+			csp::Variable<int> oVar{ digits };
+			csp::Variable<int> rVar{ digits };
+			csp::Variable<int> yVar{ digits };
+			std::vector<std::reference_wrapper<csp::Variable<int>>> letters{ sVar, eVar, nVar, dVar, mVar, oVar, rVar, yVar };
+			csp::Constraint<int> allDiffConstr{ letters, csp::allDiff<int> };
+			csp::Constraint<int> sumConstr{ letters,
+				csp::LinearSum<int>{ { 1000, 91, -90, 1, -9000, -900, 10, -1 }, csp::LinearRelation::EQUAL, 0 } };
+			csp::ConstraintProblem<int> sendMoreMoneyProb{ { allDiffConstr, sumConstr } };
+
+			csp::heuristicBacktrackingSolver<int>(sendMoreMoneyProb,
+				csp::minimumRemainingValues_primarySelector<int>,
+				csp::degreeHeuristic_secondarySelector<int>,
+				std::optional<csp::DomainSorter<int>>{},
+				csp::globalConstraintsPropagation<int>);
+			Assert::IsTrue(sendMoreMoneyProb.isCompletelyConsistentlyAssigned());
+			Assert::AreEqual(9, sVar.getValue());
+			Assert::AreEqual(1, mVar.getValue());
+			Assert::AreEqual(2, yVar.getValue());
+		}
+	};
+}
\ No newline at end of file
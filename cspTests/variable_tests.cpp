@@ -114,6 +114,19 @@ namespace cspTests
 			Assert::IsTrue(std::find(domain.cbegin(), domain.cend(), valToDelete) == domain.cend());
 		}
 
+		TEST_METHOD(TestInsertToDomainByIdx)
+		{
+			csp::Variable<double> var2{ usetOriginalDomain };
+			const std::vector<double> originalDomain = var2.getDomain();
+			double valToDelete = originalDomain[3];
+			var2.removeFromDomainByIdx(3);
+			var2.assignByIdx(5);
+			double assignedValue = var2.getValue();
+			var2.insertToDomainByIdx(3, valToDelete);
+			Assert::IsTrue(originalDomain == var2.getDomain());
+			Assert::AreEqual(assignedValue, var2.getValue());
+		}
+
 		TEST_METHOD(TestUnassignedValueExtractionError)
 		{
 			Assert::ExpectException<csp::unassigned_value_extraction_error<double>>([&]() -> void { var1.getValue(); });
@@ -163,5 +176,38 @@ namespace cspTests
 			const std::vector<double>& vecDomain = var1.getDomain();
 			Assert::IsTrue(vecDomain.size() == 9);
 		}
+
+		TEST_METHOD(TestBitsetDomain)
+		{
+			csp::Variable<int> intVar{ { -2, 0, 1, 4 } };
+			Assert::IsFalse(intVar.getBitsetDomain().has_value());
+			intVar.enableBitsetDomain();
+			intVar.removeFromDomainByValue(0);
+			const std::vector<int> reducedDomain{ -2, 1, 4 };
+			Assert::IsTrue(reducedDomain == intVar.getBitsetDomain()->getValues());
+
+			intVar.insertToDomainByIdx(0, -5);
+			const std::vector<int> extendedDomain{ -5, -2, 1, 4 };
+			Assert::IsTrue(extendedDomain == intVar.getBitsetDomain()->getValues());
+
+			intVar.setDomain({ 0, static_cast<int>(csp::BITSET_DOMAIN_MAX_SIZE) });
+			Assert::IsFalse(intVar.getBitsetDomain().has_value());
+			Assert::ExpectException<csp::bitset_domain_size_error<int>>([&]() -> void { intVar.enableBitsetDomain(); });
+		}
+
+		TEST_METHOD(TestBitsetDomainOfUnsortedDomain)
+		{
+			csp::Variable<int> intVar{ { 1, 2 } };
+			intVar.enableBitsetDomain();
+			intVar.setDomain({ 3, 1, 5 });
+			Assert::AreEqual(1, intVar.getBitsetDomain()->getBase());
+			const std::vector<int> sortedDomain{ 1, 3, 5 };
+			Assert::IsTrue(sortedDomain == intVar.getBitsetDomain()->getValues());
+
+			// the first and last values are close, yet the values span more than BITSET_DOMAIN_MAX_SIZE integers
+			intVar.setDomain({ 3, -static_cast<int>(csp::BITSET_DOMAIN_MAX_SIZE), 5 });
+			Assert::IsFalse(intVar.getBitsetDomain().has_value());
+			Assert::ExpectException<csp::bitset_domain_size_error<int>>([&]() -> void { intVar.enableBitsetDomain(); });
+		}
 	};
 }
\ No newline at end of file